@@ -0,0 +1,195 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "Measurement.h"
+
+namespace laio::bench {
+
+    /// Catch2 reporter, which writes the benchmark results of a run as a single JSON document
+    ///
+    /// \details Selected with `--reporter json`, and written to standard output or the file given with `--out`. Test
+    /// assertions are not reported, so the benchmark executable should be run with the `[benchmark]` tag only. The
+    /// durations of Catch2 benchmarks are in nanoseconds per run of the benchmark body, and are followed by the
+    /// measurements which benchmarks reported themselves, so that results of different releases can be compared by
+    /// `test_case` and `name`.
+    class JsonReporter final : public Catch::StreamingReporterBase<JsonReporter> {
+
+        struct Result_ {
+            std::string testCase;
+            std::string name;
+            int samples;
+            int iterations;
+            double mean;
+            double meanLowerBound;
+            double meanUpperBound;
+            double standardDeviation;
+            double outlierVariance;
+        };
+
+        std::vector<Result_> results_{};
+        std::string testCase_{};
+
+        /// Write string literal with quotes and control characters escaped
+        void write_string_(const std::string& text) {
+            stream << '"';
+            for (const char c : text) {
+                switch (c) {
+                    case '"': stream << "\\\""; break;
+                    case '\\': stream << "\\\\"; break;
+                    case '\n': stream << "\\n"; break;
+                    case '\t': stream << "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            constexpr char hex[] = "0123456789abcdef";
+                            stream << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+                        } else {
+                            stream << c;
+                        }
+                }
+            }
+            stream << '"';
+        }
+
+        /// Write number with enough digits to read it back unchanged, or `null` if it is not finite, which JSON cannot
+        /// represent
+        void write_number_(double value) {
+            if (std::isfinite(value)) {
+                const std::streamsize precision = stream.precision(std::numeric_limits<double>::max_digits10);
+                stream << value;
+                stream.precision(precision);
+            } else {
+                stream << "null";
+            }
+        }
+
+        static std::string compiler_() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return "msvc " + std::to_string(_MSC_FULL_VER);
+#elif defined(__clang__)
+            return "clang " __clang_version__;
+#elif defined(__GNUC__)
+            return "gcc " __VERSION__;
+#else
+            return "unknown";
+#endif
+        }
+
+        static std::string timestamp_() {
+            const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            std::tm utc{};
+#if defined(_WIN32)
+            gmtime_s(&utc, &now);
+#else
+            gmtime_r(&now, &utc);
+#endif
+            char buf[sizeof "1970-01-01T00:00:00Z"];
+            return std::string{buf, std::strftime(buf, sizeof buf, "%Y-%m-%dT%H:%M:%SZ", &utc)};
+        }
+
+    public:
+        // # Constructors
+        explicit JsonReporter(const Catch::ReporterConfig& config) : StreamingReporterBase{config} {
+            m_reporterPrefs.shouldReportAllAssertions = false;
+        }
+
+        // # Public member functions
+        static std::string getDescription() {
+            return "Reports benchmark results as a JSON document";
+        }
+
+        void testCaseStarting(const Catch::TestCaseInfo& testInfo) override {
+            StreamingReporterBase::testCaseStarting(testInfo);
+            testCase_ = testInfo.name;
+        }
+
+        void assertionStarting(const Catch::AssertionInfo&) override {}
+
+        bool assertionEnded(const Catch::AssertionStats&) override {
+            return true;
+        }
+
+        void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override {
+            results_.push_back(Result_{testCase_, stats.info.name, stats.info.samples, stats.info.iterations,
+                                       stats.mean.point.count(), stats.mean.lower_bound.count(),
+                                       stats.mean.upper_bound.count(), stats.standardDeviation.point.count(),
+                                       stats.outlierVariance});
+        }
+
+        void testRunEnded(const Catch::TestRunStats& testRunStats) override {
+            stream << "{\n  \"context\": {\n    \"executable\": ";
+            write_string_(testRunStats.runInfo.name);
+            stream << ",\n    \"date\": ";
+            write_string_(timestamp_());
+            stream << ",\n    \"compiler\": ";
+            write_string_(compiler_());
+#if defined(NDEBUG)
+            stream << ",\n    \"build\": \"release\"";
+#else
+            stream << ",\n    \"build\": \"debug\"";
+#endif
+            stream << "\n  },\n  \"benchmarks\": [";
+            const char* separator = "\n";
+            for (const Result_& result : results_) {
+                stream << separator << "    {\"test_case\": ";
+                write_string_(result.testCase);
+                stream << ", \"name\": ";
+                write_string_(result.name);
+                stream << ", \"samples\": " << result.samples << ", \"iterations\": " << result.iterations;
+                stream << ", \"mean_ns\": ";
+                write_number_(result.mean);
+                stream << ", \"mean_lower_bound_ns\": ";
+                write_number_(result.meanLowerBound);
+                stream << ", \"mean_upper_bound_ns\": ";
+                write_number_(result.meanUpperBound);
+                stream << ", \"std_dev_ns\": ";
+                write_number_(result.standardDeviation);
+                stream << ", \"outlier_variance\": ";
+                write_number_(result.outlierVariance);
+                stream << '}';
+                separator = ",\n";
+            }
+            stream << "\n  ],\n  \"measurements\": [";
+            separator = "\n";
+            for (const Measurement& measurement : measurements()) {
+                stream << separator << "    {\"test_case\": ";
+                write_string_(measurement.testCase);
+                stream << ", \"name\": ";
+                write_string_(measurement.name);
+                stream << ", \"parameters\": {";
+                const char* parameterSeparator = "";
+                for (const auto& [key, value] : measurement.parameters) {
+                    stream << parameterSeparator;
+                    write_string_(key);
+                    stream << ": " << value;
+                    parameterSeparator = ", ";
+                }
+                stream << "}, \"operations\": " << measurement.operations
+                       << ", \"elapsed_ns\": " << measurement.elapsed.count() << ", \"ops_per_second\": ";
+                write_number_(measurement.throughput());
+                stream << ", \"p50_ns\": " << measurement.p50.count()
+                       << ", \"p90_ns\": " << measurement.p90.count()
+                       << ", \"p99_ns\": " << measurement.p99.count()
+                       << ", \"p999_ns\": " << measurement.p999.count()
+                       << ", \"max_ns\": " << measurement.max.count();
+                if (measurement.cpu.count() > 0) {
+                    stream << ", \"cpu_ns_per_op\": ";
+                    write_number_(measurement.cpu_per_operation());
+                }
+                stream << '}';
+                separator = ",\n";
+            }
+            stream << "\n  ]\n}\n";
+            StreamingReporterBase::testRunEnded(testRunStats);
+        }
+
+    }; // class JsonReporter
+
+} // namespace laio::bench
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "fmt/format.h"
+
+namespace laio::bench {
+
+    using std::int64_t;
+    using std::uint64_t;
+
+    /// Latencies of the individual operations of a benchmark run
+    ///
+    /// \details Every latency is kept, so that percentiles are exact. Each thread of a run should record into its own
+    /// recorder, which are merged after the threads have been joined.
+    class LatencyRecorder {
+
+        std::vector<int64_t> latencies_{};      ///< Latencies in nanoseconds, in order of recording
+
+    public:
+        // # Public member functions
+
+        /// Reserve memory for the expected number of operations, so that recording does not allocate
+        void reserve(std::size_t count) {
+            latencies_.reserve(count);
+        }
+
+        /// Record latency of a single operation
+        void record(std::chrono::nanoseconds latency) {
+            latencies_.push_back(latency.count());
+        }
+
+        /// Take over all latencies of another recorder
+        void merge(const LatencyRecorder& other) {
+            latencies_.insert(latencies_.end(), other.latencies_.begin(), other.latencies_.end());
+        }
+
+        /// Return number of recorded operations
+        [[nodiscard]] std::size_t count() const noexcept {
+            return latencies_.size();
+        }
+
+        /// Return latency below which the given fraction of all operations completed
+        ///
+        /// \details Nearest-rank percentile, e.g. `percentile(0.99)` for the 99th percentile. Sorts the recorded
+        /// latencies on first use after recording.
+        ///
+        /// \param fraction Fraction of operations between 0 and 1
+        /// \return Latency, or zero if nothing was recorded
+        std::chrono::nanoseconds percentile(double fraction) {
+            if (latencies_.empty()) return std::chrono::nanoseconds{0};
+            if (!std::is_sorted(latencies_.begin(), latencies_.end())) {
+                std::sort(latencies_.begin(), latencies_.end());
+            }
+            const auto rank = static_cast<std::size_t>(fraction * static_cast<double>(latencies_.size()));
+            return std::chrono::nanoseconds{latencies_[(std::min)(rank, latencies_.size() - 1)]};
+        }
+
+    }; // class LatencyRecorder
+
+    /// Result of a benchmark run, which is measured by the benchmark itself rather than by Catch2
+    struct Measurement {
+        std::string testCase;                                           ///< Name of the enclosing test case
+        std::string name;                                               ///< Name of the run
+        std::vector<std::pair<std::string, int64_t>> parameters;        ///< Configuration of the run
+        uint64_t operations;                                            ///< Number of completed operations
+        std::chrono::nanoseconds elapsed;                               ///< Wall-clock time of the run
+        std::chrono::nanoseconds p50;                                   ///< Median latency
+        std::chrono::nanoseconds p90;                                   ///< 90th percentile latency
+        std::chrono::nanoseconds p99;                                   ///< 99th percentile latency
+        std::chrono::nanoseconds p999;                                  ///< 99.9th percentile latency
+        std::chrono::nanoseconds max;                                   ///< Maximum latency
+        std::chrono::nanoseconds cpu;                                   ///< CPU time of the process, zero if unknown
+
+        /// Return CPU time per operation in nanoseconds, or zero if the CPU time is unknown
+        [[nodiscard]] double cpu_per_operation() const noexcept {
+            return operations > 0 ? static_cast<double>(cpu.count()) / static_cast<double>(operations) : 0.0;
+        }
+
+        /// Return operations per second
+        [[nodiscard]] double throughput() const noexcept {
+            return elapsed.count() > 0 ? static_cast<double>(operations) * 1e9 / static_cast<double>(elapsed.count())
+                                       : 0.0;
+        }
+
+    }; // struct Measurement
+
+    /// Return all measurements reported so far in this process
+    inline std::vector<Measurement>& measurements() {
+        static std::vector<Measurement> measurements{};
+        return measurements;
+    }
+
+    /// Report result of a benchmark run
+    ///
+    /// \details The measurement is printed to standard error right away and kept for the JSON reporter, which writes
+    /// all measurements of a process at the end of the test run. Must be called from the thread running the test case.
+    ///
+    /// \param name Name of the run, unique within the test case
+    /// \param parameters Configuration of the run
+    /// \param elapsed Wall-clock time of the run
+    /// \param latencies Latencies of all operations of the run
+    /// \param cpu CPU time the process has spent during the run, if measured
+    inline void report(std::string name, std::vector<std::pair<std::string, int64_t>> parameters,
+                       std::chrono::nanoseconds elapsed, LatencyRecorder& latencies,
+                       std::chrono::nanoseconds cpu = std::chrono::nanoseconds{0}) {
+        Measurement measurement{Catch::getResultCapture().getCurrentTestName(), std::move(name),
+                                std::move(parameters), latencies.count(), elapsed, latencies.percentile(0.5),
+                                latencies.percentile(0.9), latencies.percentile(0.99), latencies.percentile(0.999),
+                                latencies.percentile(1.0), cpu};
+        std::clog << fmt::format("{:<48} {:>12.0f} ops/s  p50 {:>9} ns  p99 {:>9} ns  p99.9 {:>9} ns  max {:>9} ns",
+                                 measurement.name, measurement.throughput(), measurement.p50.count(),
+                                 measurement.p99.count(), measurement.p999.count(), measurement.max.count());
+        if (cpu.count() > 0) {
+            std::clog << fmt::format("  cpu {:>9.0f} ns/op", measurement.cpu_per_operation());
+        }
+        std::clog << '\n';
+        measurements().push_back(std::move(measurement));
+    }
+
+} // namespace laio::bench
@@ -0,0 +1,308 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "fmt/format.h"
+#include "Result.h"
+
+#include "CompletionPort.h"
+#include "CompletionStatus.h"
+#include "Histogram.h"
+#include "Instrument.h"
+#include "Measurement.h"
+#include "Overlapped.h"
+
+namespace {
+
+    using laio::iocp::CompletionPort;
+    using laio::iocp::CompletionStatus;
+
+    /// Token of the completion status, which tells a consumer to stop
+    constexpr std::size_t SENTINEL = 0;
+
+    /// How consumers wait for completions
+    enum class Timeout : int64_t {
+        Infinite,       ///< Block until a completion arrives
+        Finite,         ///< Block for at most 10 milliseconds, then retry
+        Poll            ///< Return immediately and retry, i.e. spin on the port
+    };
+
+    constexpr Timeout timeouts[] = {Timeout::Infinite, Timeout::Finite, Timeout::Poll};
+
+    std::optional<const std::chrono::milliseconds> wait_for(Timeout timeout) {
+        switch (timeout) {
+            case Timeout::Finite: return std::chrono::milliseconds{10};
+            case Timeout::Poll: return std::chrono::milliseconds{0};
+            default: return std::nullopt;
+        }
+    }
+
+    const char* name_of(Timeout timeout) {
+        switch (timeout) {
+            case Timeout::Finite: return "finite";
+            case Timeout::Poll: return "poll";
+            default: return "infinite";
+        }
+    }
+
+    /// Steady clock time in nanoseconds, which producers post as token so that consumers can measure latency
+    std::size_t now() {
+        using namespace std::chrono;
+        return static_cast<std::size_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    /// Thread counts to sweep, up to the number of hardware threads
+    std::vector<unsigned> thread_counts() {
+        const unsigned hardware = (std::max)(std::thread::hardware_concurrency(), 1u);
+        std::vector<unsigned> counts{};
+        for (unsigned count = 1; count < hardware; count *= 2) {
+            counts.push_back(count);
+        }
+        counts.push_back(hardware);
+        return counts;
+    }
+
+    /// Dequeue completions until a sentinel arrives, and record the time since each completion was posted
+    ///
+    /// \details Batches are dequeued with `get_many` if `batch` is larger than one, and are timed once per batch. One
+    /// sentinel is posted per consumer after all other completions. If a batch holds more than one sentinel, the
+    /// surplus sentinels are posted again for the other consumers.
+    ///
+    /// \param onCompletion Called with the token of every completion other than a sentinel
+    /// \return `false` if dequeuing failed for any other reason than a timeout
+    template<typename F>
+    bool consume(CompletionPort& port, std::size_t batch, Timeout timeout, laio::bench::LatencyRecorder& latencies,
+                 F&& onCompletion) {
+        std::vector<CompletionStatus> statuses(batch, CompletionStatus{});
+        for (;;) {
+            gsl::span<CompletionStatus> dequeued{};
+            if (batch == 1) {
+                auto result = port.get(wait_for(timeout));
+                if (auto* status = std::get_if<CompletionStatus>(&result)) {
+                    statuses.front() = *status;
+                    dequeued = gsl::span<CompletionStatus>{statuses}.first(1);
+                } else if (std::get<laio::Error>(result) == wse::win_errc::wait_timeout) {
+                    continue;
+                } else {
+                    return false;
+                }
+            } else {
+                auto result = port.get_many(statuses, wait_for(timeout));
+                if (auto* span = std::get_if<gsl::span<CompletionStatus>>(&result)) {
+                    dequeued = *span;
+                } else if (std::get<laio::Error>(result) == wse::win_errc::wait_timeout) {
+                    continue;
+                } else {
+                    return false;
+                }
+            }
+            const std::size_t dequeuedAt = now();
+            std::size_t sentinels = 0;
+            for (CompletionStatus& status : dequeued) {
+                if (status.token() == SENTINEL) {
+                    ++sentinels;
+                    continue;
+                }
+                latencies.record(std::chrono::nanoseconds{dequeuedAt - status.token()});
+                onCompletion(status.token());
+            }
+            if (sentinels > 0) {
+                for (std::size_t i = 1; i < sentinels; ++i) {
+                    port.post(CompletionStatus::create(0, SENTINEL, nullptr));
+                }
+                return true;
+            }
+        }
+    }
+
+    /// Configuration of a throughput run
+    struct Throughput {
+        unsigned producers;
+        unsigned consumers;
+        std::size_t batch;
+        Timeout timeout;
+        std::size_t completions;
+    };
+
+    /// Let producers post completions as fast as possible, while consumers drain the port
+    void run(const Throughput& config) {
+        CompletionPort port = std::get<CompletionPort>(CompletionPort::create(config.consumers));
+        std::atomic<bool> go{false};
+        std::atomic<bool> failed{false};
+        std::vector<laio::bench::LatencyRecorder> latencies(config.consumers);
+
+        std::vector<std::thread> consumers{};
+        for (unsigned i = 0; i < config.consumers; ++i) {
+            latencies[i].reserve(config.completions);
+            consumers.emplace_back([&, i] {
+                if (!consume(port, config.batch, config.timeout, latencies[i], [](std::size_t) {})) failed = true;
+            });
+        }
+        std::vector<std::thread> producers{};
+        for (unsigned i = 0; i < config.producers; ++i) {
+            const std::size_t count = config.completions / config.producers
+                                    + (i < config.completions % config.producers ? 1 : 0);
+            producers.emplace_back([&, count] {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (std::size_t posted = 0; posted < count; ++posted) {
+                    port.post(CompletionStatus::create(0, now(), nullptr));
+                }
+            });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread& producer : producers) producer.join();
+        for (unsigned i = 0; i < config.consumers; ++i) {
+            port.post(CompletionStatus::create(0, SENTINEL, nullptr));
+        }
+        for (std::thread& consumer : consumers) consumer.join();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE_FALSE(failed.load());
+
+        laio::bench::LatencyRecorder all{};
+        all.reserve(config.completions);
+        for (const laio::bench::LatencyRecorder& recorder : latencies) all.merge(recorder);
+        REQUIRE(all.count() == config.completions);
+        laio::bench::report(
+                fmt::format("{}:{} batch {} {}", config.producers, config.consumers, config.batch,
+                            name_of(config.timeout)),
+                {{"producers", config.producers}, {"consumers", config.consumers},
+                 {"batch", static_cast<int64_t>(config.batch)}, {"timeout", static_cast<int64_t>(config.timeout)}},
+                elapsed, all);
+    }
+
+    /// Configuration of a wakeup latency run
+    struct Wakeup {
+        unsigned waiters;
+        std::size_t batch;
+        Timeout timeout;
+        std::size_t rounds;
+    };
+
+    /// Post one completion at a time to idle consumers, and wait for its acknowledgement before posting the next
+    void run(const Wakeup& config) {
+        CompletionPort port = std::get<CompletionPort>(CompletionPort::create(config.waiters));
+        CompletionPort acknowledgements = std::get<CompletionPort>(CompletionPort::create(1));
+        std::atomic<bool> failed{false};
+        std::vector<laio::bench::LatencyRecorder> latencies(config.waiters);
+
+        std::vector<std::thread> waiters{};
+        for (unsigned i = 0; i < config.waiters; ++i) {
+            latencies[i].reserve(config.rounds);
+            waiters.emplace_back([&, i] {
+                const bool consumed = consume(port, config.batch, config.timeout, latencies[i], [&](std::size_t token) {
+                    acknowledgements.post(CompletionStatus::create(0, token, nullptr));
+                });
+                if (!consumed) {
+                    failed = true;
+                    acknowledgements.post(CompletionStatus::create(0, SENTINEL, nullptr));
+                }
+            });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < config.rounds && !failed; ++round) {
+            port.post(CompletionStatus::create(0, now(), nullptr));
+            acknowledgements.get(std::nullopt);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        for (unsigned i = 0; i < config.waiters; ++i) {
+            port.post(CompletionStatus::create(0, SENTINEL, nullptr));
+        }
+        for (std::thread& waiter : waiters) waiter.join();
+        REQUIRE_FALSE(failed.load());
+
+        laio::bench::LatencyRecorder all{};
+        all.reserve(config.rounds);
+        for (const laio::bench::LatencyRecorder& recorder : latencies) all.merge(recorder);
+        laio::bench::report(
+                fmt::format("{} waiters batch {} {}", config.waiters, config.batch, name_of(config.timeout)),
+                {{"waiters", config.waiters}, {"batch", static_cast<int64_t>(config.batch)},
+                 {"timeout", static_cast<int64_t>(config.timeout)}},
+                elapsed, all);
+    }
+
+} // namespace
+
+TEST_CASE("CompletionPort throughput", "[benchmark]") {
+
+    // Latency is measured from `post` to the return of `get` or `get_many`, and therefore includes queueing
+    for (const unsigned consumers : thread_counts()) {
+        for (const unsigned producers : {1u, consumers}) {
+            for (const std::size_t batch : {1, 16, 64}) {
+                for (const Timeout timeout : timeouts) {
+                    run(Throughput{producers, consumers, batch, timeout, 1u << 18u});
+                }
+            }
+            if (consumers == 1) break;
+        }
+    }
+}
+
+TEST_CASE("CompletionPort wakeup latency", "[benchmark]") {
+
+    // Waiters beyond the first stay blocked, but the port must pick one of them to wake up
+    for (const unsigned waiters : {1u, 2u, 4u}) {
+        for (const std::size_t batch : {1, 16}) {
+            for (const Timeout timeout : timeouts) {
+                run(Wakeup{waiters, batch, timeout, 20'000});
+            }
+        }
+    }
+}
+
+TEST_CASE("Instrumentation overhead", "[benchmark]") {
+    using laio::iocp::Histogram;
+    using laio::iocp::Overlapped;
+    namespace instrument = laio::iocp::instrument;
+
+    // `bench_laio_iocp_instrumented`, `bench_laio_iocp_traced` and `bench_laio_iocp_metered` run the same benchmarks
+    // with instrumentation enabled
+    const std::string build = instrument::TRACED ? "traced"
+            : instrument::ENABLED ? "instrumented"
+            : instrument::METERED ? "metered"
+            : "plain";
+    CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
+    std::vector<Overlapped> overlapped(64);
+    std::vector<CompletionStatus> statuses(overlapped.size(), CompletionStatus{});
+
+    BENCHMARK("submit, post and get_many 64 operations " + build) {
+        for (std::size_t i = 0; i < overlapped.size(); ++i) {
+            instrument::submitted(overlapped[i].raw(), instrument::Op::Read);
+            port.post(CompletionStatus::create(0, i, &overlapped[i]));
+        }
+        return port.get_many(statuses, std::nullopt);
+    };
+
+    std::vector<CompletionStatus> completed{};
+    for (std::size_t i = 0; i < overlapped.size(); ++i) {
+        completed.push_back(CompletionStatus::create(0, i, &overlapped[i]));
+    }
+    BENCHMARK("submitted and dequeued hooks of 64 operations " + build) {
+        const int64_t waited = instrument::clock();
+        for (Overlapped& operation : overlapped) {
+            instrument::submitted(operation.raw(), instrument::Op::Read);
+        }
+        instrument::dequeued(waited, completed);
+        return overlapped.front().raw();
+    };
+
+    // Values spread over the whole range, so that buckets are hit at random
+    Histogram histogram{};
+    std::uint64_t value = 1;
+    BENCHMARK("Histogram::record") {
+        value = value * 6364136223846793005u + 1442695040888963407u;
+        histogram.record(value >> 24u);
+        return value;
+    };
+}
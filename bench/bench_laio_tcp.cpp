@@ -0,0 +1,605 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch2/catch.hpp"
+
+#include <WinSock2.h>
+#include <processthreadsapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "fmt/format.h"
+#include "gsl/span"
+#include "Result.h"
+
+#include "AcceptAddrBuf.h"
+#include "CompletionPort.h"
+#include "CompletionStatus.h"
+#include "Measurement.h"
+#include "Overlapped.h"
+#include "SocketAddr.h"
+#include "SocketAddrV4.h"
+#include "TcpListener.h"
+#include "TcpStream.h"
+#include "TcpStreamExt.h"
+
+namespace {
+
+    using laio::iocp::CompletionPort;
+    using laio::iocp::CompletionStatus;
+    using laio::iocp::Overlapped;
+    using laio::net::TcpListener;
+    using laio::net::TcpStream;
+    using Clock = std::chrono::steady_clock;
+
+    /// Token of completions on the listener
+    constexpr std::size_t LISTENER = (std::numeric_limits<std::size_t>::max)();
+
+    /// Token of the completion status, which tells a worker to stop
+    constexpr std::size_t STOP = LISTENER - 1;
+
+    /// Bytes the echo server reads at once on each connection
+    constexpr std::size_t ECHO_BUFFER_SIZE = 64 * 1024;
+
+    /// Return user and kernel time the process has spent on all of its threads
+    std::chrono::nanoseconds cpu_time() {
+        FILETIME creation{};
+        FILETIME exit{};
+        FILETIME kernel{};
+        FILETIME user{};
+        GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+        const auto ticks = [](FILETIME time) {
+            return static_cast<int64_t>(static_cast<uint64_t>(time.dwHighDateTime) << 32u | time.dwLowDateTime);
+        };
+        return std::chrono::nanoseconds{(ticks(kernel) + ticks(user)) * 100};
+    }
+
+    /// Dequeue a batch of completions, an empty batch if the timeout has elapsed
+    ///
+    /// \details `get_many` rather than `get`, because the latter does not return the overlapped structure of a
+    /// failed operation, whose error is retrieved through `result` instead.
+    gsl::span<CompletionStatus> dequeue(CompletionPort& port, std::vector<CompletionStatus>& statuses,
+                                        std::chrono::milliseconds timeout, std::atomic<bool>& failed) {
+        auto result = port.get_many(statuses, timeout);
+        if (auto* dequeued = std::get_if<gsl::span<CompletionStatus>>(&result)) return *dequeued;
+        if (std::get<laio::Error>(result) != wse::win_errc::wait_timeout) failed = true;
+        return gsl::span<CompletionStatus>{};
+    }
+
+    /// Return number of bytes transferred by a completed operation, or `std::nullopt` if it has failed
+    template<typename T>
+    std::optional<std::size_t> transferred(T& socket, OVERLAPPED* overlapped) {
+        auto result = socket.result(overlapped);
+        if (std::holds_alternative<laio::Error>(result)) return std::nullopt;
+        return std::get<0>(std::get<std::tuple<std::size_t, unsigned long>>(result));
+    }
+
+    /// Echo server on the loopback interface, which sends every byte it receives back on the same connection
+    ///
+    /// \details Accepts are posted for all expected connections up front. Each connection has at most one read or
+    /// write in flight, so that any worker thread may complete any connection without synchronization. A connection
+    /// is closed once the client has shut down its sending half.
+    class EchoServer {
+
+        struct Connection_ {
+            TcpStream stream;
+            laio::net::AcceptAddrBuf addresses{};
+            Overlapped overlapped{};
+            std::vector<uint8_t> buffer = std::vector<uint8_t>(ECHO_BUFFER_SIZE);
+            std::size_t received = 0;           ///< Bytes to echo, zero while reading
+            std::size_t echoed = 0;             ///< Bytes of `received` already sent back
+        };
+
+        TcpListener listener_;
+        CompletionPort port_;
+        laio::net::SocketAddr address_;
+        std::vector<std::unique_ptr<Connection_>> connections_{};
+        std::vector<std::thread> workers_{};
+        std::atomic<std::size_t> closed_{0};
+        std::atomic<bool> stopping_{false};
+        std::atomic<bool> failed_{false};
+
+    public:
+        // # Constructors
+        EchoServer(std::size_t connections, unsigned threads)
+            : listener_{std::get<TcpListener>(TcpListener::bind(laio::net::SocketAddrV4{laio::net::ipv4::LOCALHOST, 0}))},
+              port_{std::get<CompletionPort>(CompletionPort::create(threads))},
+              address_{std::get<laio::net::SocketAddr>(listener_.local_addr())} {
+            REQUIRE(std::holds_alternative<std::monostate>(port_.add_socket(LISTENER, listener_)));
+            for (std::size_t i = 0; i < connections; ++i) {
+                connections_.push_back(std::make_unique<Connection_>(
+                        Connection_{std::get<TcpStream>(TcpStream::create(address_))}));
+                Connection_& connection = *connections_.back();
+                auto accepting = listener_.accept_overlapped(connection.stream, connection.addresses,
+                                                             connection.overlapped.raw());
+                REQUIRE(std::holds_alternative<bool>(accepting));
+            }
+            for (unsigned i = 0; i < threads; ++i) {
+                workers_.emplace_back([this] { work_(); });
+            }
+        }
+
+        EchoServer(const EchoServer& other) = delete;
+
+        // # Destructor
+        ~EchoServer() noexcept {
+            stop();
+        }
+
+        // # Operator overloads
+        EchoServer& operator=(const EchoServer& rhs) = delete;
+
+        // # Public member functions
+
+        /// Return address clients connect to
+        [[nodiscard]] const laio::net::SocketAddr& address() const noexcept {
+            return address_;
+        }
+
+        /// Return `true` if an operation has failed, other than on connections closed by the client
+        [[nodiscard]] bool failed() const noexcept {
+            return failed_;
+        }
+
+        /// Cancel accepts of connections that never arrived, wait until all connections are closed and join workers
+        void stop() noexcept {
+            if (workers_.empty()) return;
+            CancelIoEx(reinterpret_cast<HANDLE>(listener_.as_raw_socket()), nullptr);
+            const auto deadline = Clock::now() + std::chrono::seconds{10};
+            while (closed_ < connections_.size() && Clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            stopping_ = true;
+            for (std::size_t i = 0; i < workers_.size(); ++i) {
+                port_.post(CompletionStatus::create(0, STOP, nullptr));
+            }
+            for (std::thread& worker : workers_) worker.join();
+            workers_.clear();
+        }
+
+    private:
+        void work_() {
+            std::vector<CompletionStatus> statuses(64, CompletionStatus{});
+            while (!stopping_) {
+                for (CompletionStatus& status : dequeue(port_, statuses, std::chrono::milliseconds{100}, failed_)) {
+                    if (status.token() == STOP) continue;
+                    if (status.token() == LISTENER) {
+                        accepted_(status.overlapped());
+                    } else {
+                        completed_(*connections_[status.token()]);
+                    }
+                }
+            }
+        }
+
+        void accepted_(OVERLAPPED* overlapped) {
+            auto it = std::find_if(connections_.begin(), connections_.end(), [overlapped](auto& connection) {
+                return connection->overlapped.raw() == overlapped;
+            });
+            Connection_& connection = **it;
+            const auto token = static_cast<std::size_t>(it - connections_.begin());
+            if (!transferred(listener_, overlapped)) {
+                // Cancelled by `stop`, because the client never connected
+                ++closed_;
+                return;
+            }
+            if (std::holds_alternative<laio::Error>(listener_.accept_complete(connection.stream))
+                    || std::holds_alternative<laio::Error>(port_.add_socket(token, connection.stream))
+                    || std::holds_alternative<laio::Error>(connection.stream.set_nodelay(true))) {
+                fail_(connection);
+                return;
+            }
+            read_(connection);
+        }
+
+        void completed_(Connection_& connection) {
+            const std::optional<std::size_t> bytes = transferred(connection.stream, connection.overlapped.raw());
+            if (!bytes) {
+                fail_(connection);
+                return;
+            }
+            if (connection.received == 0) {
+                if (*bytes == 0) {
+                    // Client has shut down its sending half
+                    connection.stream.shutdown(SD_SEND);
+                    ++closed_;
+                    return;
+                }
+                connection.received = *bytes;
+                connection.echoed = 0;
+            } else {
+                connection.echoed += *bytes;
+            }
+            if (connection.echoed < connection.received) {
+                write_(connection);
+            } else {
+                connection.received = 0;
+                read_(connection);
+            }
+        }
+
+        void read_(Connection_& connection) {
+            connection.overlapped = Overlapped{};
+            if (std::holds_alternative<laio::Error>(
+                    connection.stream.read_overlapped(connection.buffer, connection.overlapped.raw()))) {
+                fail_(connection);
+            }
+        }
+
+        void write_(Connection_& connection) {
+            connection.overlapped = Overlapped{};
+            const gsl::span<const uint8_t> unsent{connection.buffer.data() + connection.echoed,
+                                                  connection.received - connection.echoed};
+            if (std::holds_alternative<laio::Error>(
+                    connection.stream.write_overlapped(unsent, connection.overlapped.raw()))) {
+                fail_(connection);
+            }
+        }
+
+        void fail_(Connection_& connection) {
+            failed_ = true;
+            connection.stream.shutdown(SD_BOTH);
+            ++closed_;
+        }
+
+    }; // class EchoServer
+
+    /// Configuration of a load generator run
+    struct Workload {
+        std::size_t connections;            ///< Number of client connections
+        std::size_t messageSize;            ///< Bytes per request, and per response
+        std::size_t depth;                  ///< Maximum number of requests written at once on each connection
+        double rate;                        ///< Requests per second of all connections for an open loop, 0 otherwise
+        unsigned clientThreads;             ///< Number of load generator threads
+        unsigned serverThreads;             ///< Number of echo server threads
+        std::chrono::milliseconds warmup;   ///< Time before latencies are recorded
+        std::chrono::milliseconds duration; ///< Time latencies are recorded for
+    };
+
+    /// State of a run shared by all load generator threads
+    struct Shared {
+        const Workload& workload;
+        laio::net::SocketAddr address;
+        std::atomic<unsigned> connected{0};
+        std::atomic<bool> go{false};
+        std::atomic<bool> failed{false};
+        Clock::time_point start{};
+    };
+
+    /// Connection of the load generator, with a read in flight at all times and at most one write
+    ///
+    /// \details In a closed loop, `depth` requests are outstanding at all times, and each response is immediately
+    /// followed by a new request. In an open loop, requests are scheduled at a fixed rate regardless of responses,
+    /// and their latency is measured from the scheduled time, so that a slow server is not excused from the requests
+    /// it delayed.
+    struct Client {
+        TcpStream stream;
+        Overlapped reading{};
+        Overlapped writing{};
+        std::vector<uint8_t> request;
+        std::vector<uint8_t> response;
+        std::deque<Clock::time_point> outstanding{};    ///< Start of requests without complete response, oldest first
+        std::size_t queued = 0;                         ///< Newest outstanding requests not written yet
+        std::size_t unsent = 0;                         ///< Bytes of the write in flight not sent yet
+        std::size_t sent = 0;                           ///< Bytes of the write in flight sent already
+        std::size_t received = 0;                       ///< Bytes of the oldest outstanding response received so far
+        Clock::time_point next{};                       ///< Scheduled start of the next request in an open loop
+        bool connected = false;
+        bool isReading = false;
+        bool isWriting = false;
+        bool closing = false;
+
+        [[nodiscard]] bool done() const noexcept {
+            return closing && !isReading && !isWriting;
+        }
+    };
+
+    /// Generate load on a share of all connections
+    ///
+    /// \param run Shared state of the run
+    /// \param connections Number of connections of this thread
+    /// \param latencies Latencies of requests completed during the measurement
+    void generate(Shared& run, std::size_t connections, laio::bench::LatencyRecorder& latencies) {
+        const Workload& workload = run.workload;
+        const std::size_t requestBytes = workload.messageSize * workload.depth;
+        const auto interval = workload.rate > 0
+                ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>{
+                        static_cast<double>(workload.connections) / workload.rate})
+                : Clock::duration{0};
+        CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
+        std::vector<std::unique_ptr<Client>> clients{};
+
+        const auto close = [](Client& client) {
+            if (client.closing) return;
+            client.closing = true;
+            client.stream.shutdown(SD_SEND);
+        };
+        const auto fail = [&run](Client& client) {
+            run.failed = true;
+            client.closing = true;
+            CancelIoEx(reinterpret_cast<HANDLE>(client.stream.as_raw_socket()), nullptr);
+        };
+        const auto read = [&](Client& client) {
+            client.reading = Overlapped{};
+            client.isReading = !std::holds_alternative<laio::Error>(
+                    client.stream.read_overlapped(client.response, client.reading.raw()));
+            if (!client.isReading) fail(client);
+        };
+        const auto write = [&](Client& client) {
+            if (client.isWriting || client.closing) return;
+            if (client.unsent == 0) {
+                if (client.queued == 0) return;
+                const std::size_t count = (std::min)(client.queued, workload.depth);
+                client.queued -= count;
+                client.unsent = count * workload.messageSize;
+                client.sent = 0;
+            }
+            client.writing = Overlapped{};
+            const gsl::span<const uint8_t> unsent{client.request.data() + client.sent, client.unsent};
+            client.isWriting = !std::holds_alternative<laio::Error>(
+                    client.stream.write_overlapped(unsent, client.writing.raw()));
+            if (!client.isWriting) fail(client);
+        };
+
+        // Connect all connections of this thread before the clock starts
+        for (std::size_t i = 0; i < connections; ++i) {
+            clients.push_back(std::make_unique<Client>(Client{std::get<TcpStream>(TcpStream::create(run.address)),
+                                                              Overlapped{}, Overlapped{},
+                                                              std::vector<uint8_t>(requestBytes, 0x2a),
+                                                              std::vector<uint8_t>(requestBytes)}));
+            Client& client = *clients.back();
+            client.isWriting = std::holds_alternative<std::monostate>(
+                            client.stream.socket().bind(laio::net::SocketAddrV4{laio::net::ipv4::LOCALHOST, 0}))
+                    && std::holds_alternative<std::monostate>(port.add_socket(i, client.stream))
+                    && std::holds_alternative<std::optional<std::size_t>>(client.stream.connect_overlapped(
+                            run.address, gsl::span<const uint8_t>{}, client.writing.raw()));
+            if (!client.isWriting) fail(client);
+        }
+        std::vector<CompletionStatus> statuses(64, CompletionStatus{});
+        std::size_t pending = connections;
+        while (pending > 0 && !run.failed) {
+            for (CompletionStatus& status : dequeue(port, statuses, std::chrono::milliseconds{100}, run.failed)) {
+                Client& client = *clients[status.token()];
+                client.isWriting = false;
+                client.connected = transferred(client.stream, client.writing.raw()).has_value()
+                        && std::holds_alternative<std::monostate>(client.stream.connect_complete())
+                        && std::holds_alternative<std::monostate>(client.stream.set_nodelay(true));
+                if (!client.connected) fail(client);
+                --pending;
+            }
+        }
+        ++run.connected;
+        while (!run.go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+        const Clock::time_point measureFrom = run.start + workload.warmup;
+        const Clock::time_point measureUntil = measureFrom + workload.duration;
+        for (std::size_t i = 0; i < connections; ++i) {
+            Client& client = *clients[i];
+            if (!client.connected) continue;
+            read(client);
+            if (workload.rate > 0) {
+                client.next = run.start + interval * static_cast<Clock::rep>(i) / static_cast<Clock::rep>(connections);
+            } else {
+                client.outstanding.assign(workload.depth, run.start);
+                client.queued = workload.depth;
+                write(client);
+            }
+        }
+
+        const auto active = [&clients] {
+            return std::any_of(clients.begin(), clients.end(), [](auto& client) { return !client->done(); });
+        };
+        bool stopping = false;
+        while (active()) {
+            // Wait no longer than until the next scheduled request of an open loop
+            std::chrono::milliseconds timeout{10};
+            if (workload.rate > 0 && !stopping) {
+                const auto next = std::min_element(clients.begin(), clients.end(), [](auto& lhs, auto& rhs) {
+                    return lhs->next < rhs->next;
+                });
+                timeout = std::chrono::duration_cast<std::chrono::milliseconds>((*next)->next - Clock::now());
+                timeout = std::clamp(timeout, std::chrono::milliseconds{0}, std::chrono::milliseconds{10});
+            }
+            for (CompletionStatus& status : dequeue(port, statuses, timeout, run.failed)) {
+                Client& client = *clients[status.token()];
+                const std::optional<std::size_t> bytes = transferred(client.stream, status.overlapped());
+                if (status.overlapped() == client.reading.raw()) {
+                    client.isReading = false;
+                    if (!bytes || (*bytes == 0 && !client.closing)) {
+                        fail(client);
+                    } else if (*bytes > 0) {
+                        const Clock::time_point now = Clock::now();
+                        client.received += *bytes;
+                        while (client.received >= workload.messageSize && !client.outstanding.empty()) {
+                            if (now >= measureFrom && now < measureUntil) {
+                                latencies.record(now - client.outstanding.front());
+                            }
+                            client.outstanding.pop_front();
+                            client.received -= workload.messageSize;
+                            if (workload.rate == 0 && !stopping) {
+                                client.outstanding.push_back(now);
+                                ++client.queued;
+                            }
+                        }
+                        read(client);
+                    }
+                } else {
+                    client.isWriting = false;
+                    if (!bytes) {
+                        fail(client);
+                    } else {
+                        client.sent += *bytes;
+                        client.unsent -= (std::min)(*bytes, client.unsent);
+                    }
+                }
+                write(client);
+            }
+
+            const Clock::time_point now = Clock::now();
+            stopping = stopping || now >= measureUntil || run.failed;
+            for (std::unique_ptr<Client>& client : clients) {
+                if (client->done()) continue;
+                if (!stopping) {
+                    while (workload.rate > 0 && client->next <= now) {
+                        client->outstanding.push_back(client->next);
+                        ++client->queued;
+                        client->next += interval;
+                    }
+                    write(*client);
+                } else if (client->outstanding.empty() && !client->isWriting) {
+                    // Server closes its half in turn, which completes the read in flight
+                    close(*client);
+                }
+            }
+        }
+    }
+
+    /// Run echo server and load generator, and report requests per second, latency and CPU time per request
+    void run(const Workload& workload) {
+        EchoServer server{workload.connections, workload.serverThreads};
+        Shared shared{workload, server.address()};
+        const auto threads = static_cast<unsigned>((std::min)(std::size_t{workload.clientThreads},
+                                                               workload.connections));
+        std::vector<laio::bench::LatencyRecorder> latencies(threads);
+        std::vector<std::thread> generators{};
+        for (unsigned i = 0; i < threads; ++i) {
+            const std::size_t connections = workload.connections / threads + (i < workload.connections % threads);
+            generators.emplace_back([&shared, &latencies, connections, i] {
+                generate(shared, connections, latencies[i]);
+            });
+        }
+        while (shared.connected < threads) std::this_thread::yield();
+        shared.start = Clock::now();
+        shared.go.store(true, std::memory_order_release);
+
+        std::this_thread::sleep_until(shared.start + workload.warmup);
+        const std::chrono::nanoseconds cpuBefore = cpu_time();
+        std::this_thread::sleep_until(shared.start + workload.warmup + workload.duration);
+        const std::chrono::nanoseconds cpu = cpu_time() - cpuBefore;
+        for (std::thread& generator : generators) generator.join();
+        server.stop();
+        REQUIRE_FALSE(shared.failed.load());
+        REQUIRE_FALSE(server.failed());
+
+        laio::bench::LatencyRecorder all{};
+        for (const laio::bench::LatencyRecorder& recorder : latencies) all.merge(recorder);
+        const std::string loop = workload.rate > 0 ? fmt::format("open {:.0f}/s", workload.rate) : "closed";
+        laio::bench::report(
+                fmt::format("{} {} conn {} B depth {}", loop, workload.connections, workload.messageSize,
+                            workload.depth),
+                {{"connections", static_cast<int64_t>(workload.connections)},
+                 {"message_size", static_cast<int64_t>(workload.messageSize)},
+                 {"depth", static_cast<int64_t>(workload.depth)},
+                 {"rate", static_cast<int64_t>(workload.rate)},
+                 {"client_threads", threads},
+                 {"server_threads", workload.serverThreads}},
+                workload.duration, all, cpu);
+    }
+
+    /// Split hardware threads evenly between load generator and server
+    unsigned half_of_threads() {
+        return (std::max)(std::thread::hardware_concurrency() / 2, 1u);
+    }
+
+    /// Dynamic interface of a stream, declared the way the extension interfaces used to be
+    struct DynamicStreamExt {
+        virtual laio::Result<std::optional<std::size_t>> read_overlapped(gsl::span<uint8_t> buf,
+                                                                         OVERLAPPED* overlapped) noexcept = 0;
+        virtual laio::Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept = 0;
+        virtual ~DynamicStreamExt() = default;
+    };
+
+    /// Forward the dynamic interface to a stream implementing the static one
+    template<typename Stream>
+    struct Dynamic final : DynamicStreamExt {
+        Stream& stream;
+
+        explicit Dynamic(Stream& stream) noexcept
+            : stream{stream} {}
+
+        laio::Result<std::optional<std::size_t>> read_overlapped(gsl::span<uint8_t> buf,
+                                                                 OVERLAPPED* overlapped) noexcept override {
+            return stream.read_overlapped(buf, overlapped);
+        }
+
+        laio::Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept override {
+            return stream.result(overlapped);
+        }
+    };
+
+    /// Stream, whose operations complete without a system call, so that only the dispatch is measured
+    struct NullStream : laio::net::interface::TcpStreamExt<NullStream> {
+        laio::Result<std::optional<std::size_t>> read_overlapped(gsl::span<uint8_t> buf, OVERLAPPED*) noexcept {
+            return std::optional<std::size_t>{buf.size()};
+        }
+
+        laio::Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED*) noexcept {
+            return std::tuple<std::size_t, unsigned long>{0, 0};
+        }
+    };
+
+    /// Hide the dynamic type of an interface from the optimizer, as a stream stored behind a pointer would be
+    DynamicStreamExt& opaque(DynamicStreamExt& stream) {
+        DynamicStreamExt* volatile hidden = &stream;
+        return *hidden;
+    }
+
+} // namespace
+
+TEST_CASE("Stream interface dispatch", "[benchmark]") {
+    std::vector<uint8_t> buffer(64);
+    Overlapped overlapped{};
+
+    // Without a system call, static dispatch inlines to nothing while every virtual call is an indirect branch
+    NullStream null{};
+    laio::net::interface::TcpStreamExt<NullStream>& statically = null;
+    Dynamic<NullStream> nullAdapter{null};
+    DynamicStreamExt& dynamically = opaque(nullAdapter);
+    BENCHMARK("read_overlapped of a null stream, static dispatch") {
+        return statically.read_overlapped(buffer, overlapped.raw());
+    };
+    BENCHMARK("read_overlapped of a null stream, virtual dispatch") {
+        return dynamically.read_overlapped(buffer, overlapped.raw());
+    };
+
+    // Retrieving the result of a completed operation stays in user mode, so that the dispatch is a visible share
+    TcpStream stream = std::get<TcpStream>(TcpStream::create(AF_INET));
+    laio::net::interface::TcpStreamExt<TcpStream>& streamStatically = stream;
+    Dynamic<TcpStream> streamAdapter{stream};
+    DynamicStreamExt& streamDynamically = opaque(streamAdapter);
+    BENCHMARK("result of a completed operation, static dispatch") {
+        return streamStatically.result(overlapped.raw());
+    };
+    BENCHMARK("result of a completed operation, virtual dispatch") {
+        return streamDynamically.result(overlapped.raw());
+    };
+}
+
+TEST_CASE("TCP echo closed loop", "[benchmark]") {
+    for (const std::size_t connections : {1, 16, 64}) {
+        for (const std::size_t messageSize : {64, 4'096}) {
+            for (const std::size_t depth : {1, 16}) {
+                run(Workload{connections, messageSize, depth, 0.0, half_of_threads(), half_of_threads(),
+                             std::chrono::milliseconds{200}, std::chrono::milliseconds{1'000}});
+            }
+        }
+    }
+}
+
+TEST_CASE("TCP echo open loop", "[benchmark]") {
+
+    // Latency at fixed request rates well below and close to the saturation of a small server
+    for (const double rate : {10'000.0, 50'000.0, 100'000.0}) {
+        run(Workload{16, 64, 16, rate, half_of_threads(), 1, std::chrono::milliseconds{200},
+                     std::chrono::milliseconds{2'000}});
+    }
+}
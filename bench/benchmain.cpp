@@ -0,0 +1,9 @@
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch2/catch.hpp"
+
+#include "JsonReporter.h"
+
+using laio::bench::JsonReporter;
+
+CATCH_REGISTER_REPORTER("json", JsonReporter)
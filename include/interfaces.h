@@ -6,8 +6,13 @@
 
 namespace laio::interface {
 
-    using TcpListenerExt = laio::net::interface::TcpListenerExt;
-    using TcpStreamExt = laio::net::interface::TcpStreamExt;
-    using UdpSocketExt = laio::net::interface::UdpSocketExt;
+    template<typename Derived>
+    using TcpListenerExt = laio::net::interface::TcpListenerExt<Derived>;
+
+    template<typename Derived>
+    using TcpStreamExt = laio::net::interface::TcpStreamExt<Derived>;
+
+    template<typename Derived>
+    using UdpSocketExt = laio::net::interface::UdpSocketExt<Derived>;
 
 } // namespace laio::interface
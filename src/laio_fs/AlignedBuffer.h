@@ -0,0 +1,139 @@
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <variant>
+
+#include "gsl/span"
+#include "Result.h"
+
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint8_t;
+
+    namespace fs {
+
+        /// Owning buffer of raw bytes with a guaranteed minimum alignment
+        ///
+        /// \details Unbuffered file I/O requires the buffer address and the transfer length to be multiples of the
+        /// sector size of the underlying volume. The buffer is allocated with the requested alignment and its length
+        /// is rounded up to a multiple of that alignment, so that it can be passed to direct I/O operations as is. It
+        /// behaves in the widest sense similar to `std::unique_ptr<uint8_t[]>`.
+        class AlignedBuffer {
+
+            uint8_t* data_{};           ///< Start of the aligned allocation
+            std::size_t size_{};        ///< Length of the allocation in bytes (multiple of alignment)
+            std::size_t alignment_{};   ///< Alignment of the allocation in bytes (power of two)
+
+            AlignedBuffer(uint8_t* data, std::size_t size, std::size_t alignment) noexcept
+                : data_{data}, size_{size}, alignment_{alignment} {}
+
+        public:
+            // # Constructors
+            constexpr AlignedBuffer() noexcept = default;
+
+            AlignedBuffer(const AlignedBuffer& other) = delete;
+
+            AlignedBuffer(AlignedBuffer&& other) noexcept
+                : data_{other.data_}, size_{other.size_}, alignment_{other.alignment_}
+            {
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+
+            // # Destructor
+            ~AlignedBuffer() noexcept {
+                if (data_ != nullptr) _aligned_free(data_);
+            }
+
+            // # Operator overloads
+            AlignedBuffer& operator=(const AlignedBuffer& rhs) = delete;
+
+            AlignedBuffer& operator=(AlignedBuffer&& rhs) noexcept {
+                if (this != &rhs) {
+                    if (data_ != nullptr) _aligned_free(data_);
+                    data_ = rhs.data_;
+                    size_ = rhs.size_;
+                    alignment_ = rhs.alignment_;
+                    rhs.data_ = nullptr;
+                    rhs.size_ = 0;
+                }
+                return *this;
+            }
+
+            // # Public member functions
+
+            /// Allocate new zeroed buffer with the specified alignment
+            ///
+            /// \details The requested size is rounded up to the next multiple of the alignment. The alignment must be
+            /// a non-zero power of two, typically the sector size reported by `File::alignment` or the page size.
+            ///
+            /// \param size Minimum number of bytes the buffer must hold
+            /// \param alignment Required alignment of the buffer address and length
+            /// \return Variant with AlignedBuffer if successful, error type otherwise
+            static Result<AlignedBuffer> allocate(std::size_t size, std::size_t alignment) noexcept {
+                if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+                    return Error{static_cast<wse::win_errc>(ERROR_INVALID_PARAMETER)};
+                }
+                const std::size_t rounded = align_up(size, alignment);
+                auto* data = static_cast<uint8_t*>(_aligned_malloc(rounded == 0 ? alignment : rounded, alignment));
+                if (data == nullptr) {
+                    return Error{static_cast<wse::win_errc>(ERROR_NOT_ENOUGH_MEMORY)};
+                }
+                std::fill_n(data, rounded, uint8_t{0});
+                return AlignedBuffer{data, rounded, alignment};
+            }
+
+            /// Round value up to the next multiple of a power-of-two alignment
+            static constexpr std::size_t align_up(std::size_t value, std::size_t alignment) noexcept {
+                return (value + alignment - 1) & ~(alignment - 1);
+            }
+
+            /// Return `true` if value is a multiple of a power-of-two alignment
+            static constexpr bool is_aligned(std::uint64_t value, std::size_t alignment) noexcept {
+                return (value & (alignment - 1)) == 0;
+            }
+
+            /// Return mutable non-owning view over the entire buffer
+            gsl::span<uint8_t> as_mut_span() noexcept {
+                return gsl::span<uint8_t>{data_, size_};
+            }
+
+            /// Return non-owning view over the entire buffer
+            [[nodiscard]] gsl::span<const uint8_t> as_span() const noexcept {
+                return gsl::span<const uint8_t>{data_, size_};
+            }
+
+            /// Return pointer to the start of the buffer
+            uint8_t* data() noexcept {
+                return data_;
+            }
+
+            /// Return length of the buffer in bytes
+            [[nodiscard]] std::size_t size() const noexcept {
+                return size_;
+            }
+
+            /// Return alignment of the buffer in bytes
+            [[nodiscard]] std::size_t alignment() const noexcept {
+                return alignment_;
+            }
+
+        }; // class AlignedBuffer
+
+    } // namespace fs
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<fs::AlignedBuffer> = true;
+
+    } // namespace trait
+
+} // namespace laio
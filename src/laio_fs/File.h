@@ -0,0 +1,270 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "hicpp-move-const-arg"
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <fileapi.h>
+#include <winbase.h>
+
+#include <cstdint>
+#include <optional>
+#include <variant>
+
+#include "gsl/span"
+#include "Result.h"
+
+#include "AlignedBuffer.h"
+#include "Handle.h"
+#include "Overlapped.h"
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint8_t;
+    using std::uint64_t;
+
+    namespace fs {
+
+        /// Handle to a file opened for positional overlapped I/O
+        ///
+        /// \details Specialized wrapper around an ordinary Windows handle, which is always opened in overlapped mode.
+        /// All operations are positional: the file offset is passed alongside each request and stored in the provided
+        /// overlapped structure, so that multiple requests can be in flight on the same file at once.
+        /// If the file has been opened for direct (unbuffered) I/O, every request is validated against the sector
+        /// alignment of the underlying volume before it is submitted, as the system would otherwise reject it only
+        /// after the round trip into the kernel.
+        class File {
+
+            iocp::Handle handle_;       ///< Handle to the file
+            std::size_t alignment_;     ///< Required alignment of offsets, lengths and buffers (1 if buffered)
+
+        public:
+            // # Constructors
+            explicit File(iocp::Handle handle, std::size_t alignment = 1) noexcept
+                : handle_{std::move(handle)}, alignment_{alignment} {}
+
+            File(const File& other) = delete;
+
+            File(File&& other) noexcept
+                : handle_{std::move(other.handle_)}, alignment_{other.alignment_} {}
+
+            // # Operator overloads
+            File& operator=(const File& rhs) = delete;
+
+            File& operator=(File&& rhs) noexcept {
+                handle_ = std::move(rhs.handle_);
+                alignment_ = rhs.alignment_;
+                return *this;
+            }
+
+            // # Public member functions
+
+            /// Wrap raw handle to a file opened in overlapped mode
+            ///
+            /// \details If the file has been opened with `FILE_FLAG_NO_BUFFERING`, the sector size of the volume is
+            /// queried, so that requests can be validated before submission.
+            ///
+            /// \param handle Raw Windows handle
+            /// \param direct `true` if the file has been opened for unbuffered I/O
+            /// \return Variant with File if successful, error type otherwise
+            static Result<File> from_raw_handle(HANDLE&& handle, bool direct) noexcept {
+                iocp::Handle owned{std::move(handle)};
+                if (!direct) {
+                    return File{std::move(owned)};
+                }
+                FILE_STORAGE_INFO info{};
+                const BOOL ret = GetFileInformationByHandleEx(
+                        owned,
+                        FileStorageInfo,
+                        &info,
+                        static_cast<DWORD>(sizeof info)
+                );
+                if (ret == 0) {
+                    return Error{};
+                }
+
+                // Sector sizes are powers of two, so the larger one is always a multiple of the smaller one
+                const std::size_t alignment = (std::max)(
+                        static_cast<std::size_t>(info.LogicalBytesPerSector),
+                        static_cast<std::size_t>(info.PhysicalBytesPerSectorForPerformance));
+                return File{std::move(owned), alignment};
+            }
+
+            /// Borrow raw handle to this file
+            ///
+            /// \details Callee retains ownership over handle and no manual clean-up is required!
+            ///
+            /// \return HANDLE Raw Windows handle to this file
+            [[nodiscard]] HANDLE as_raw_handle() const noexcept {
+                return handle_;
+            }
+
+            /// Extract raw handle to this file and consume wrapper
+            ///
+            /// \details Caller takes ownership over the HANDLE and must clean-up manually!
+            ///
+            /// \return HANDLE&& Raw Windows handle to this file
+            HANDLE&& into_raw_handle() && noexcept {
+                return std::move(handle_).into_raw();
+            }
+
+            /// Return `true` if this file bypasses the system file cache
+            [[nodiscard]] bool is_direct() const noexcept {
+                return alignment_ > 1;
+            }
+
+            /// Return alignment required for offsets, lengths and buffer addresses of requests to this file
+            ///
+            /// \details For buffered files this is always 1. For direct files it is the sector size of the volume.
+            [[nodiscard]] std::size_t alignment() const noexcept {
+                return alignment_;
+            }
+
+            /// Allocate zeroed buffer suitable for requests to this file
+            ///
+            /// \param size Minimum number of bytes the buffer must hold
+            /// \return Variant with AlignedBuffer if successful, error type otherwise
+            [[nodiscard]] Result<AlignedBuffer> allocate_buffer(std::size_t size) const noexcept {
+                return AlignedBuffer::allocate(size, alignment_);
+            }
+
+            /// Return the current size of this file in bytes
+            ///
+            /// \return Variant with size of the file if successful, error type otherwise
+            Result<uint64_t> size() noexcept {
+                LARGE_INTEGER size{};
+                if (GetFileSizeEx(handle_, &size) == 0) {
+                    return Error{};
+                }
+                return static_cast<uint64_t>(size.QuadPart);
+            }
+
+            /// Check whether a request at the specified offset is admissible for this file
+            ///
+            /// \details Direct I/O requires the offset, the length of the transfer and the address of the buffer to be
+            /// multiples of the sector size. The error codes match the ones the system reports for such requests.
+            ///
+            /// \param data Start of the buffer of the request
+            /// \param len Length of the request in bytes
+            /// \param offset Position of the request in the file
+            /// \return Variant with error type, in case the request is misaligned
+            [[nodiscard]] Result<std::monostate> validate(const void* data, std::size_t len,
+                                                          uint64_t offset) const noexcept {
+                if (!AlignedBuffer::is_aligned(offset, alignment_)) {
+                    return Error{static_cast<wse::win_errc>(ERROR_OFFSET_ALIGNMENT_VIOLATION)};
+                }
+                if (!AlignedBuffer::is_aligned(len, alignment_)
+                        || !AlignedBuffer::is_aligned(reinterpret_cast<std::uintptr_t>(data), alignment_)) {
+                    return Error{static_cast<wse::win_errc>(ERROR_INVALID_PARAMETER)};
+                }
+                return std::monostate{};
+            }
+
+            /// Asynchronously read data at the specified offset and return immediately
+            ///
+            /// \details Validates the request, stores the offset in the overlapped structure and submits an overlapped
+            /// read. The function returns immediately with the number of bytes that have already been read
+            /// successfully by that time, if any.
+            ///
+            /// \param buf Buffer for raw bytes to read from this file
+            /// \param offset Position in the file to read from
+            /// \param overlapped Overlapped structure to specify asynchronous read
+            /// \return Variant with optional number of bytes successfully read if any, error type otherwise
+            Result<std::optional<std::size_t>> read_at(gsl::span<uint8_t> buf, uint64_t offset,
+                                                       iocp::Overlapped& overlapped) noexcept {
+                if (auto err = validate(buf.data(), buf.size_bytes(), offset); std::holds_alternative<Error>(err)) {
+                    return std::get<Error>(err);
+                }
+                overlapped.set_offset(offset);
+                return handle_.read_overlapped(buf, overlapped.raw());
+            }
+
+            /// Asynchronously read data at the specified offset and wait for completion
+            ///
+            /// \param buf Buffer for raw bytes to read from this file
+            /// \param offset Position in the file to read from
+            /// \param overlapped Overlapped structure to specify asynchronous read
+            /// \return Variant with number of bytes successfully read, error type otherwise
+            Result<std::size_t> read_at_wait(gsl::span<uint8_t> buf, uint64_t offset,
+                                             iocp::Overlapped& overlapped) noexcept {
+                if (auto err = validate(buf.data(), buf.size_bytes(), offset); std::holds_alternative<Error>(err)) {
+                    return std::get<Error>(err);
+                }
+                overlapped.set_offset(offset);
+                return handle_.read_overlapped_wait(buf, overlapped.raw());
+            }
+
+            /// Asynchronously write data at the specified offset and return immediately
+            ///
+            /// \details Validates the request, stores the offset in the overlapped structure and submits an overlapped
+            /// write. The function returns immediately with the number of bytes that have already been written
+            /// successfully by that time, if any.
+            ///
+            /// \param buf Buffer of raw bytes to write to this file
+            /// \param offset Position in the file to write to
+            /// \param overlapped Overlapped structure to specify asynchronous write
+            /// \return Variant with optional number of bytes successfully written if any, error type otherwise
+            Result<std::optional<std::size_t>> write_at(gsl::span<const uint8_t> buf, uint64_t offset,
+                                                        iocp::Overlapped& overlapped) noexcept {
+                if (auto err = validate(buf.data(), buf.size_bytes(), offset); std::holds_alternative<Error>(err)) {
+                    return std::get<Error>(err);
+                }
+                overlapped.set_offset(offset);
+                return handle_.write_overlapped(buf, overlapped.raw());
+            }
+
+            /// Retrieve the result of an overlapped request to this file
+            ///
+            /// \param overlapped Overlapped structure of the submitted request
+            /// \param wait Block thread until the request has completed if `true`
+            /// \return Variant with optional number of bytes transferred if completed, error type otherwise
+            Result<std::optional<std::size_t>> result(iocp::Overlapped& overlapped, bool wait) noexcept {
+                return handle_.result(overlapped.raw(), wait);
+            }
+
+            /// Request cancellation of an overlapped request to this file
+            ///
+            /// \param overlapped Overlapped structure of the request to cancel
+            /// \return Variant with error type, in case the cancellation request has failed
+            Result<std::monostate> cancel(iocp::Overlapped& overlapped) noexcept {
+                return handle_.cancel(overlapped.raw());
+            }
+
+            /// Asynchronously write data at the specified offset and wait for completion
+            ///
+            /// \param buf Buffer of raw bytes to write to this file
+            /// \param offset Position in the file to write to
+            /// \param overlapped Overlapped structure to specify asynchronous write
+            /// \return Variant with number of bytes successfully written, error type otherwise
+            Result<std::size_t> write_at_wait(gsl::span<const uint8_t> buf, uint64_t offset,
+                                              iocp::Overlapped& overlapped) noexcept {
+                if (auto err = validate(buf.data(), buf.size_bytes(), offset); std::holds_alternative<Error>(err)) {
+                    return std::get<Error>(err);
+                }
+                overlapped.set_offset(offset);
+                return handle_.write_overlapped_wait(buf, overlapped.raw());
+            }
+
+        }; // class File
+
+    } // namespace fs
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<fs::File> = true;
+
+        template<>
+        constexpr bool is_sync<fs::File> = true;
+
+        template<>
+        constexpr bool as_raw_handle<fs::File> = true;
+
+        template<>
+        constexpr bool into_raw_handle<fs::File> = true;
+
+    } // namespace trait
+
+} // namespace laio
+#pragma clang diagnostic pop
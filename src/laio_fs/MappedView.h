@@ -0,0 +1,359 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "hicpp-move-const-arg"
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <memoryapi.h>
+#include <sysinfoapi.h>
+#include <threadpoolapiset.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <variant>
+
+#include "gsl/span"
+#include "Result.h"
+
+#include "CompletionPort.h"
+#include "CompletionStatus.h"
+#include "File.h"
+#include "Handle.h"
+#include "Overlapped.h"
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint8_t;
+    using std::uint64_t;
+
+    namespace fs {
+
+        /// Expected access pattern of a range inside a mapped view
+        enum class Advice {
+            WillNeed,   ///< Range will be accessed soon - read it into memory ahead of time
+            DontNeed    ///< Range will not be accessed for a while - release it from the working set
+        };
+
+        /// View of a file mapped into the address space of the process
+        ///
+        /// \details Wraps a Windows file mapping object and a view into it. The mapped bytes are accessed through
+        /// spans without any copying, and pages are read from the file on first access. Unlike `File`, the view does
+        /// not go through overlapped I/O at all, which makes it well-suited for random reads from large, read-mostly
+        /// files.
+        ///
+        /// Windows only supports large pages for views of sections backed by the paging file. Such views are created
+        /// through `anonymous` and require the `SeLockMemoryPrivilege`. Views of regular files always use the default
+        /// page size.
+        class MappedView {
+
+            iocp::Handle mapping_;      ///< Handle to the file mapping object
+            uint8_t* base_{};           ///< Start of the view, aligned to the allocation granularity
+            std::size_t delta_{};       ///< Distance from the start of the view to the first requested byte
+            std::size_t size_{};        ///< Number of requested bytes in the view
+            bool writable_{};           ///< `true` if the view has been mapped with write access
+
+            MappedView(iocp::Handle mapping, uint8_t* base, std::size_t delta, std::size_t size, bool writable) noexcept
+                : mapping_{std::move(mapping)}, base_{base}, delta_{delta}, size_{size}, writable_{writable} {}
+
+        public:
+            // # Constructors
+            MappedView(const MappedView& other) = delete;
+
+            MappedView(MappedView&& other) noexcept
+                : mapping_{std::move(other.mapping_)},
+                base_{other.base_},
+                delta_{other.delta_},
+                size_{other.size_},
+                writable_{other.writable_}
+            {
+                other.base_ = nullptr;
+                other.size_ = 0;
+            }
+
+            // # Destructor
+            ~MappedView() noexcept {
+                if (base_ != nullptr) UnmapViewOfFile(base_);
+            }
+
+            // # Operator overloads
+            MappedView& operator=(const MappedView& rhs) = delete;
+
+            MappedView& operator=(MappedView&& rhs) noexcept {
+                if (this != &rhs) {
+                    if (base_ != nullptr) UnmapViewOfFile(base_);
+                    mapping_ = std::move(rhs.mapping_);
+                    base_ = rhs.base_;
+                    delta_ = rhs.delta_;
+                    size_ = rhs.size_;
+                    writable_ = rhs.writable_;
+                    rhs.base_ = nullptr;
+                    rhs.size_ = 0;
+                }
+                return *this;
+            }
+
+            // # Public member functions
+
+            /// Map range of a file into memory
+            ///
+            /// \details The offset need not be aligned: the view is extended down to the allocation granularity of
+            /// the system and the spans start at the requested offset. If no length is specified, the view extends to
+            /// the end of the file.
+            ///
+            /// \param file File to map, which may be closed once the view has been created
+            /// \param offset Position of the first byte to map
+            /// \param length Number of bytes to map, or until the end of the file
+            /// \param writable Map with write access, which requires the file to be opened for writing
+            /// \return Variant with MappedView if successful, error type otherwise
+            static Result<MappedView> map(File& file, uint64_t offset, std::optional<std::size_t> length,
+                                          bool writable) noexcept {
+                Result<uint64_t> fileSize = file.size();
+                if (std::holds_alternative<Error>(fileSize)) {
+                    return std::get<Error>(fileSize);
+                }
+                const uint64_t end = length ? offset + *length : std::get<uint64_t>(fileSize);
+                if (end <= offset) {
+                    return Error{static_cast<wse::win_errc>(ERROR_INVALID_PARAMETER)};
+                }
+
+                // Passing zero as maximum size maps the file at its current size; a larger size extends the file
+                HANDLE mapping = CreateFileMappingW(
+                        file.as_raw_handle(),
+                        nullptr,
+                        writable ? PAGE_READWRITE : PAGE_READONLY,
+                        static_cast<DWORD>(end >> 32u),
+                        static_cast<DWORD>(end),
+                        nullptr
+                );
+                if (mapping == nullptr) {
+                    return Error{};
+                }
+                return map_view_(iocp::Handle{mapping}, offset, static_cast<std::size_t>(end - offset),
+                                 writable ? FILE_MAP_WRITE : FILE_MAP_READ, writable);
+            }
+
+            /// Map zeroed memory backed by the paging file
+            ///
+            /// \details Large pages are only available to processes holding the `SeLockMemoryPrivilege`, and the size
+            /// of the view is rounded up to a multiple of the large page size.
+            ///
+            /// \param size Number of bytes to map
+            /// \param largePages Back the view with large pages
+            /// \return Variant with MappedView if successful, error type otherwise
+            static Result<MappedView> anonymous(std::size_t size, bool largePages) noexcept {
+                DWORD protection = PAGE_READWRITE;
+                DWORD access = FILE_MAP_WRITE;
+                if (largePages) {
+                    const std::size_t largePage = GetLargePageMinimum();
+                    if (largePage == 0) {
+                        return Error{static_cast<wse::win_errc>(ERROR_NOT_SUPPORTED)};
+                    }
+                    size = (size + largePage - 1) / largePage * largePage;
+                    protection |= SEC_COMMIT | SEC_LARGE_PAGES;
+                    access |= FILE_MAP_LARGE_PAGES;
+                }
+                HANDLE mapping = CreateFileMappingW(
+                        INVALID_HANDLE_VALUE,
+                        nullptr,
+                        protection,
+                        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32u),
+                        static_cast<DWORD>(size),
+                        nullptr
+                );
+                if (mapping == nullptr) {
+                    return Error{};
+                }
+                return map_view_(iocp::Handle{mapping}, 0, size, access, true);
+            }
+
+            /// Return non-owning view over the mapped bytes
+            [[nodiscard]] gsl::span<const uint8_t> as_span() const noexcept {
+                return gsl::span<const uint8_t>{base_ + delta_, size_};
+            }
+
+            /// Return mutable non-owning view over the mapped bytes
+            ///
+            /// \details Writing through the view of a file mapped without write access raises an access violation.
+            gsl::span<uint8_t> as_mut_span() noexcept {
+                return gsl::span<uint8_t>{base_ + delta_, size_};
+            }
+
+            /// Return number of mapped bytes
+            [[nodiscard]] std::size_t size() const noexcept {
+                return size_;
+            }
+
+            /// Return `true` if the view has been mapped with write access
+            [[nodiscard]] bool is_writable() const noexcept {
+                return writable_;
+            }
+
+            /// Pass hint about the expected access pattern of a range to the memory manager
+            ///
+            /// \details `Advice::WillNeed` issues large reads for the range in the background and returns without
+            /// waiting for them. `Advice::DontNeed` trims the range from the working set of the process, which keeps
+            /// the pages in the standby list, so that they can be faulted back in cheaply.
+            ///
+            /// \param offset Position of the range relative to the start of the view
+            /// \param len Length of the range in bytes
+            /// \param advice Expected access pattern
+            /// \return Variant with error type, in case the hint has been rejected
+            Result<std::monostate> advise(std::size_t offset, std::size_t len, Advice advice) noexcept {
+                gsl::span<uint8_t> range = subspan_(offset, len);
+                if (range.empty()) {
+                    return std::monostate{};
+                }
+                switch (advice) {
+                    case Advice::WillNeed: {
+                        WIN32_MEMORY_RANGE_ENTRY entry{range.data(), range.size()};
+                        if (PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0) == 0) {
+                            return Error{};
+                        }
+                        return std::monostate{};
+                    }
+                    case Advice::DontNeed: {
+
+                        // Unlocking pages that are not locked removes them from the working set, and always fails with
+                        // `ERROR_NOT_LOCKED` for that very reason
+                        if (VirtualUnlock(range.data(), range.size()) == 0
+                                && GetLastError() != ERROR_NOT_LOCKED) {
+                            return Error{};
+                        }
+                        return std::monostate{};
+                    }
+                }
+                return std::monostate{};
+            }
+
+            /// Fault range into memory and wait until it is resident
+            ///
+            /// \details Touches one byte on every page of the range, so that subsequent accesses do not incur page
+            /// faults. The range is prefetched first, so that the faults are resolved from memory rather than by one
+            /// read each.
+            ///
+            /// \param offset Position of the range relative to the start of the view
+            /// \param len Length of the range in bytes
+            void prefault(std::size_t offset, std::size_t len) noexcept {
+                advise(offset, len, Advice::WillNeed);
+                touch_(subspan_(offset, len));
+            }
+
+            /// Fault range into memory on a worker of the system thread pool
+            ///
+            /// \details Returns immediately. Once the range is resident, a completion status is posted to the provided
+            /// port, carrying the token and overlapped structure, if any. The view must outlive the request.
+            ///
+            /// \param offset Position of the range relative to the start of the view
+            /// \param len Length of the range in bytes
+            /// \param port Completion port to notify, or `nullptr`
+            /// \param token Token of the completion status posted to the port
+            /// \param overlapped Overlapped structure of the completion status posted to the port, may be `nullptr`
+            /// \return Variant with error type, in case the request could not be queued
+            Result<std::monostate> prefault_async(std::size_t offset, std::size_t len, iocp::CompletionPort* port,
+                                                  std::size_t token, iocp::Overlapped* overlapped) noexcept {
+                auto* request = new(std::nothrow) PrefaultRequest_{subspan_(offset, len), port, token, overlapped};
+                if (request == nullptr) {
+                    return Error{static_cast<wse::win_errc>(ERROR_NOT_ENOUGH_MEMORY)};
+                }
+                advise(offset, len, Advice::WillNeed);
+                if (TrySubmitThreadpoolCallback(&MappedView::prefault_callback_, request, nullptr) == 0) {
+                    delete request;
+                    return Error{};
+                }
+                return std::monostate{};
+            }
+
+            /// Write modified pages of a range back to the file
+            ///
+            /// \details Returns once the writes have been issued. Use `FlushFileBuffers` on the file to wait until
+            /// they have reached the device.
+            ///
+            /// \param offset Position of the range relative to the start of the view
+            /// \param len Length of the range in bytes
+            /// \return Variant with error type, in case the flush has failed
+            Result<std::monostate> flush(std::size_t offset, std::size_t len) noexcept {
+                gsl::span<uint8_t> range = subspan_(offset, len);
+                if (FlushViewOfFile(range.data(), range.size()) == 0) {
+                    return Error{};
+                }
+                return std::monostate{};
+            }
+
+        private:
+            /// Parameters of a prefault request passed to the thread pool
+            struct PrefaultRequest_ {
+                gsl::span<uint8_t> range;           ///< Range to fault in
+                iocp::CompletionPort* port;         ///< Port to notify when done, if any
+                std::size_t token;                  ///< Token to post
+                iocp::Overlapped* overlapped;       ///< Overlapped structure to post
+            };
+
+            /// Map view of a mapping object, extending the offset down to the allocation granularity
+            static Result<MappedView> map_view_(iocp::Handle mapping, uint64_t offset, std::size_t size, DWORD access,
+                                                bool writable) noexcept {
+                SYSTEM_INFO info{};
+                GetSystemInfo(&info);
+                const uint64_t base = offset - offset % info.dwAllocationGranularity;
+                const auto delta = static_cast<std::size_t>(offset - base);
+                void* view = MapViewOfFile(
+                        mapping,
+                        access,
+                        static_cast<DWORD>(base >> 32u),
+                        static_cast<DWORD>(base),
+                        delta + size
+                );
+                if (view == nullptr) {
+                    return Error{};
+                }
+                return MappedView{std::move(mapping), static_cast<uint8_t*>(view), delta, size, writable};
+            }
+
+            /// Clamp range to the bounds of the view
+            gsl::span<uint8_t> subspan_(std::size_t offset, std::size_t len) noexcept {
+                offset = (std::min)(offset, size_);
+                return as_mut_span().subspan(offset, (std::min)(len, size_ - offset));
+            }
+
+            /// Read one byte on every page of the range
+            static void touch_(gsl::span<uint8_t> range) noexcept {
+                SYSTEM_INFO info{};
+                GetSystemInfo(&info);
+                volatile uint8_t sink = 0;
+                for (std::size_t i = 0; i < range.size(); i += info.dwPageSize) {
+                    sink = range[i];
+                }
+                if (!range.empty()) {
+                    sink = range[range.size() - 1];
+                }
+                static_cast<void>(sink);
+            }
+
+            /// Entry point of the thread pool worker
+            static void CALLBACK prefault_callback_(PTP_CALLBACK_INSTANCE /* instance */, void* context) noexcept {
+                auto* request = static_cast<PrefaultRequest_*>(context);
+                touch_(request->range);
+                if (request->port != nullptr) {
+                    request->port->post(iocp::CompletionStatus::create(0, request->token, request->overlapped));
+                }
+                delete request;
+            }
+
+        }; // class MappedView
+
+    } // namespace fs
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<fs::MappedView> = true;
+
+        template<>
+        constexpr bool is_sync<fs::MappedView> = true;
+
+    } // namespace trait
+
+} // namespace laio
+#pragma clang diagnostic pop
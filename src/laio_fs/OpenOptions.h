@@ -0,0 +1,121 @@
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <fileapi.h>
+#include <winbase.h>
+
+#include <filesystem>
+#include <variant>
+
+#include "Result.h"
+
+#include "File.h"
+
+namespace laio {
+
+    namespace fs {
+
+        /// Caching behaviour of a file opened through `OpenOptions`
+        enum class Caching {
+            Buffered,           ///< Reads and writes go through the system file cache
+            WriteThrough,       ///< Writes go through the system file cache, but are flushed to the device at once
+            Direct,             ///< Reads and writes bypass the system file cache (`FILE_FLAG_NO_BUFFERING`)
+            DirectWriteThrough  ///< As `Direct`, and the device is asked not to cache writes either
+        };
+
+        /// Options and flags to configure how a file is opened
+        ///
+        /// \details Modelled after `std::fs::OpenOptions` in the Rust Standard Library. Every file is opened in
+        /// overlapped mode, so that it can be used for positional reads and writes and can be associated with a
+        /// completion port.
+        class OpenOptions {
+
+            bool read_{false};                      ///< Open with read access
+            bool write_{false};                     ///< Open with write access
+            bool create_{false};                    ///< Create file if it does not exist
+            bool truncate_{false};                  ///< Truncate existing file to zero length
+            Caching caching_{Caching::Buffered};    ///< Caching behaviour of the file
+
+        public:
+            // # Constructors
+            constexpr OpenOptions() noexcept = default;
+
+            // # Public member functions
+
+            /// Set option for read access
+            constexpr OpenOptions& read(bool read) noexcept {
+                read_ = read;
+                return *this;
+            }
+
+            /// Set option for write access
+            constexpr OpenOptions& write(bool write) noexcept {
+                write_ = write;
+                return *this;
+            }
+
+            /// Set option to create the file if it does not exist
+            constexpr OpenOptions& create(bool create) noexcept {
+                create_ = create;
+                return *this;
+            }
+
+            /// Set option to truncate an existing file to zero length
+            constexpr OpenOptions& truncate(bool truncate) noexcept {
+                truncate_ = truncate;
+                return *this;
+            }
+
+            /// Set caching behaviour of the file
+            ///
+            /// \details Opening a file with `Caching::Direct` requires all subsequent requests to be aligned to the
+            /// sector size of the volume. `File` validates every request before submitting it.
+            constexpr OpenOptions& caching(Caching caching) noexcept {
+                caching_ = caching;
+                return *this;
+            }
+
+            /// Open file at the specified path with the options specified by `this`
+            ///
+            /// \param path Path to the file
+            /// \return Variant with File if successful, error type otherwise
+            [[nodiscard]] Result<File> open(const std::filesystem::path& path) const noexcept {
+                DWORD access = 0;
+                if (read_) access |= GENERIC_READ;
+                if (write_) access |= GENERIC_WRITE;
+
+                DWORD disposition = OPEN_EXISTING;
+                if (create_ && truncate_) disposition = CREATE_ALWAYS;
+                else if (create_) disposition = OPEN_ALWAYS;
+                else if (truncate_) disposition = TRUNCATE_EXISTING;
+
+                DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED;
+                switch (caching_) {
+                    case Caching::Buffered: break;
+                    case Caching::WriteThrough: flags |= FILE_FLAG_WRITE_THROUGH; break;
+                    case Caching::Direct: flags |= FILE_FLAG_NO_BUFFERING; break;
+                    case Caching::DirectWriteThrough: flags |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH; break;
+                }
+
+                HANDLE ret = CreateFileW(
+                        path.c_str(),
+                        access,
+                        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                        nullptr,
+                        disposition,
+                        flags,
+                        nullptr
+                );
+                if (ret == INVALID_HANDLE_VALUE) {
+                    return Error{};
+                }
+                return File::from_raw_handle(std::move(ret), caching_ == Caching::Direct
+                                                             || caching_ == Caching::DirectWriteThrough);
+            }
+
+        }; // class OpenOptions
+
+    } // namespace fs
+
+} // namespace laio
@@ -0,0 +1,323 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "hicpp-move-const-arg"
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "gsl/span"
+#include "Result.h"
+
+#include "AlignedBuffer.h"
+#include "File.h"
+#include "Overlapped.h"
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint8_t;
+    using std::uint64_t;
+
+    namespace fs {
+
+        /// Options to configure a read-ahead pipeline
+        ///
+        /// \details The pipeline keeps between `min_depth` and `max_depth` chunks of `chunk_size` bytes in flight. All
+        /// buffers are allocated upfront, so that `max_depth * chunk_size` bytes are held for the entire lifetime of
+        /// the pipeline. If `adaptive` is disabled, the depth stays fixed at `initial_depth`.
+        class ReadAheadOptions {
+
+            std::size_t chunk_size_{1u << 20u};     ///< Length of each positional read in bytes
+            std::size_t initial_depth_{4};          ///< Number of reads in flight when the pipeline starts
+            std::size_t min_depth_{1};              ///< Lower bound of reads in flight
+            std::size_t max_depth_{32};             ///< Upper bound of reads in flight
+            uint64_t offset_{0};                    ///< Position in the file to start reading from
+            std::optional<uint64_t> length_{};      ///< Number of bytes to read, or until the end of the file
+            bool adaptive_{true};                   ///< Adapt number of reads in flight to observed throughput
+
+            friend class ReadAhead;
+
+        public:
+            // # Constructors
+            constexpr ReadAheadOptions() noexcept = default;
+
+            // # Public member functions
+
+            /// Set length of each positional read
+            ///
+            /// \details For direct files the length is rounded up to a multiple of the sector size.
+            constexpr ReadAheadOptions& chunk_size(std::size_t chunkSize) noexcept {
+                chunk_size_ = chunkSize;
+                return *this;
+            }
+
+            /// Set number of reads in flight when the pipeline starts, and the bounds within which it may adapt
+            constexpr ReadAheadOptions& depth(std::size_t initial, std::size_t min, std::size_t max) noexcept {
+                min_depth_ = (std::max)(min, std::size_t{1});
+                max_depth_ = (std::max)(max, min_depth_);
+                initial_depth_ = (std::min)((std::max)(initial, min_depth_), max_depth_);
+                return *this;
+            }
+
+            /// Set range of the file to read
+            ///
+            /// \details For direct files the offset must be a multiple of the sector size.
+            constexpr ReadAheadOptions& range(uint64_t offset, std::optional<uint64_t> length) noexcept {
+                offset_ = offset;
+                length_ = length;
+                return *this;
+            }
+
+            /// Set option to adapt the number of reads in flight to observed throughput
+            constexpr ReadAheadOptions& adaptive(bool adaptive) noexcept {
+                adaptive_ = adaptive;
+                return *this;
+            }
+
+        }; // class ReadAheadOptions
+
+        /// Sequential reader, which keeps multiple positional reads in flight
+        ///
+        /// \details Reading a file with a single outstanding request leaves the queue of the device mostly empty. The
+        /// pipeline instead submits reads for the next chunks ahead of the consumer, each with its own overlapped
+        /// structure, offset and buffer, and hands the chunks out strictly in file order.
+        ///
+        /// If enabled, the number of reads in flight is adapted through hill climbing: after every measurement window
+        /// the throughput is compared to the previous window, and the depth keeps moving in the same direction as long
+        /// as throughput improves, or turns around otherwise.
+        ///
+        /// Each read carries its own event, so that the file must not be associated with a completion port while it
+        /// is read through the pipeline.
+        class ReadAhead {
+
+            using clock = std::chrono::steady_clock;
+
+            /// Single positional read and its buffer
+            struct Slot {
+                iocp::Overlapped overlapped{};          ///< Overlapped structure of the read
+                AlignedBuffer buffer{};                 ///< Target buffer of the read
+                std::size_t requested{0};               ///< Number of bytes requested
+                std::optional<std::size_t> bytes{};     ///< Number of bytes read, if completed
+                bool in_flight{false};                  ///< `true` while the read is submitted
+            };
+
+            File* file_;                    ///< File the pipeline reads from
+            std::vector<Slot> slots_;       ///< Ring of reads, stable in memory while reads are in flight
+            std::size_t head_{0};           ///< Index of the next chunk to hand out
+            std::size_t submitted_{0};      ///< Number of slots past head with a submitted read
+            std::size_t depth_;             ///< Current number of reads to keep in flight
+            std::size_t min_depth_;         ///< Lower bound of reads in flight
+            bool returned_{false};          ///< `true` if the head slot has been handed out to the consumer
+            bool adaptive_;                 ///< Adapt depth to throughput
+            std::size_t chunk_size_;        ///< Length of each positional read in bytes
+            uint64_t next_offset_;          ///< Position of the next read to submit
+            uint64_t end_;                  ///< End of the range to read
+
+            clock::time_point window_start_{clock::now()};  ///< Start of the current measurement window
+            uint64_t window_bytes_{0};                      ///< Bytes handed out in the current window
+            double last_throughput_{0.0};                   ///< Throughput of the previous window in bytes per second
+            bool growing_{true};                            ///< Direction in which depth is currently moving
+
+            ReadAhead(File& file, std::vector<Slot>&& slots, const ReadAheadOptions& options, std::size_t chunkSize,
+                      uint64_t end) noexcept
+                : file_{&file},
+                slots_{std::move(slots)},
+                depth_{options.initial_depth_},
+                min_depth_{options.min_depth_},
+                adaptive_{options.adaptive_},
+                chunk_size_{chunkSize},
+                next_offset_{options.offset_},
+                end_{end} {}
+
+        public:
+            // # Constructors
+            ReadAhead(const ReadAhead& other) = delete;
+
+            ReadAhead(ReadAhead&& other) noexcept = default;
+
+            // # Destructor
+            ~ReadAhead() noexcept {
+                for (Slot& slot: slots_) {
+                    if (slot.in_flight) {
+
+                        // The buffer must stay alive until the system has let go of it
+                        file_->cancel(slot.overlapped);
+                        file_->result(slot.overlapped, true);
+                    }
+                    if (slot.overlapped.event() != nullptr) CloseHandle(slot.overlapped.event());
+                }
+            }
+
+            // # Operator overloads
+            ReadAhead& operator=(const ReadAhead& rhs) = delete;
+
+            ReadAhead& operator=(ReadAhead&& rhs) = delete;
+
+            // # Public member functions
+
+            /// Create new pipeline over the provided file and submit the first reads
+            ///
+            /// \param file File to read from, which must outlive the pipeline
+            /// \param options Options to configure the pipeline
+            /// \return Variant with ReadAhead if successful, error type otherwise
+            static Result<ReadAhead> create(File& file, const ReadAheadOptions& options) noexcept {
+                const std::size_t chunkSize = AlignedBuffer::align_up((std::max)(options.chunk_size_, std::size_t{1}),
+                                                                      file.alignment());
+                if (!AlignedBuffer::is_aligned(options.offset_, file.alignment())) {
+                    return Error{static_cast<wse::win_errc>(ERROR_OFFSET_ALIGNMENT_VIOLATION)};
+                }
+                Result<uint64_t> size = file.size();
+                if (std::holds_alternative<Error>(size)) {
+                    return std::get<Error>(size);
+                }
+                uint64_t end = (std::max)(std::get<uint64_t>(size), options.offset_);
+                if (options.length_) {
+                    // Clamp the length before adding, so that lengths close to the maximum cannot wrap around
+                    end = options.offset_ + (std::min)(*options.length_, end - options.offset_);
+                }
+
+                // Events created so far are released by the destructor of the pipeline if any allocation fails
+                ReadAhead pipeline{file, std::vector<Slot>(options.max_depth_), options, chunkSize, end};
+                for (Slot& slot: pipeline.slots_) {
+                    Result<AlignedBuffer> buffer = file.allocate_buffer(chunkSize);
+                    if (std::holds_alternative<Error>(buffer)) {
+                        return std::get<Error>(buffer);
+                    }
+                    slot.buffer = std::move(std::get<AlignedBuffer>(buffer));
+                    Result<iocp::Overlapped> overlapped = iocp::Overlapped::initialize_with_autoreset_event();
+                    if (std::holds_alternative<Error>(overlapped)) {
+                        return std::get<Error>(overlapped);
+                    }
+                    slot.overlapped = std::get<iocp::Overlapped>(overlapped);
+                }
+                if (auto res = pipeline.fill_(); std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                return pipeline;
+            }
+
+            /// Return next chunk of the file in order
+            ///
+            /// \details Blocks until the read of the next chunk has completed. The returned view stays valid until the
+            /// next call, when its buffer is recycled for a read further ahead in the file.
+            ///
+            /// \return Variant with view over the next chunk, or `std::nullopt` at the end of the range, error type
+            /// otherwise
+            Result<std::optional<gsl::span<const uint8_t>>> next() noexcept {
+                if (returned_) {
+                    returned_ = false;
+                    head_ = (head_ + 1) % slots_.size();
+                    --submitted_;
+                }
+                if (auto res = fill_(); std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                if (submitted_ == 0) {
+                    return std::nullopt;
+                }
+
+                Slot& slot = slots_[head_];
+                if (!slot.bytes) {
+                    Result<std::optional<std::size_t>> res = file_->result(slot.overlapped, true);
+                    slot.in_flight = false;
+                    if (std::holds_alternative<Error>(res)) {
+                        const Error err = std::get<Error>(res);
+                        if (err != static_cast<wse::win_errc>(ERROR_HANDLE_EOF)) {
+                            return err;
+                        }
+                        slot.bytes = 0;
+                    } else {
+                        slot.bytes = std::get<std::optional<std::size_t>>(res);
+                    }
+                }
+                returned_ = true;
+
+                // Direct reads are rounded up to whole sectors, so trim anything past the requested range
+                const std::size_t bytes = (std::min)(*slot.bytes, slot.requested);
+                if (adaptive_) {
+                    adapt_(bytes);
+                }
+                if (bytes == 0) {
+                    return std::nullopt;
+                }
+                return std::optional{slot.buffer.as_span().first(bytes)};
+            }
+
+            /// Return current number of reads kept in flight
+            [[nodiscard]] std::size_t depth() const noexcept {
+                return depth_;
+            }
+
+        private:
+            /// Submit reads until the current depth is reached or the range is exhausted
+            Result<std::monostate> fill_() noexcept {
+                while (submitted_ < depth_ && next_offset_ < end_) {
+                    Slot& slot = slots_[(head_ + submitted_) % slots_.size()];
+                    const uint64_t remaining = end_ - next_offset_;
+                    slot.requested = static_cast<std::size_t>((std::min)(remaining, uint64_t{chunk_size_}));
+                    const std::size_t len = AlignedBuffer::align_up(slot.requested, file_->alignment());
+                    slot.bytes = std::nullopt;
+                    Result<std::optional<std::size_t>> res = file_->read_at(slot.buffer.as_mut_span().first(len),
+                                                                            next_offset_, slot.overlapped);
+                    if (std::holds_alternative<Error>(res)) {
+                        const Error err = std::get<Error>(res);
+                        if (err != static_cast<wse::win_errc>(ERROR_HANDLE_EOF)) {
+                            return err;
+                        }
+
+                        // The file has shrunk underneath the pipeline
+                        slot.bytes = 0;
+                    } else {
+                        slot.bytes = std::get<std::optional<std::size_t>>(res);
+                        slot.in_flight = !slot.bytes;
+                    }
+                    next_offset_ += slot.requested;
+                    ++submitted_;
+                }
+                return std::monostate{};
+            }
+
+            /// Account for handed out bytes and move depth in the direction of higher throughput
+            void adapt_(std::size_t bytes) noexcept {
+                window_bytes_ += bytes;
+
+                // Measure over a few rounds of the current depth, so that a single slow read does not dominate
+                if (window_bytes_ < uint64_t{chunk_size_} * depth_ * 4) {
+                    return;
+                }
+                const clock::time_point now = clock::now();
+                const double seconds = std::chrono::duration<double>(now - window_start_).count();
+                const double throughput = seconds > 0.0 ? static_cast<double>(window_bytes_) / seconds : 0.0;
+                if (throughput < last_throughput_ * 1.05) {
+                    growing_ = !growing_;
+                }
+                const std::size_t step = (std::max)(depth_ / 4, std::size_t{1});
+                if (growing_) {
+                    depth_ = (std::min)(depth_ + step, slots_.size());
+                } else {
+                    depth_ = (std::max)(depth_ - (std::min)(step, depth_), min_depth_);
+                }
+                last_throughput_ = throughput;
+                window_start_ = now;
+                window_bytes_ = 0;
+            }
+
+        }; // class ReadAhead
+
+    } // namespace fs
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<fs::ReadAhead> = true;
+
+    } // namespace trait
+
+} // namespace laio
+#pragma clang diagnostic pop
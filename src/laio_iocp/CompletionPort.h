@@ -6,19 +6,17 @@
 
 // TODO: Replace by STL span as soon as available
 #include "gsl/span"
-#include "win_error.h"
+#include "Result.h"
 
 #include "CompletionStatus.h"
 #include "Handle.h"
+#include "Instrument.h"
 #include "traits.h"
 
 namespace laio {
 
     using std::uint_fast32_t;
 
-    template<typename T>
-    using Result = std::variant<T, wse::win_error>;
-
     namespace iocp {
 
         /// Handle to Windows I/O completion port
@@ -61,7 +59,7 @@ namespace laio {
                         static_cast<DWORD>(threads)
                 );
                 if (ret == nullptr) {
-                    return wse::win_error{};
+                    return Error{};
                 }
                 return CompletionPort{Handle{ret}};
             }
@@ -116,7 +114,7 @@ namespace laio {
             /// \return Variant with error type in case the association of the socket failed
             template<typename T, typename = std::enable_if_t<trait::as_raw_socket<T>>>
             Result<std::monostate> add_socket(const std::size_t token, const T &t) noexcept {
-                return add_(token, static_cast<HANDLE>(t.as_raw_socket()));
+                return add_(token, reinterpret_cast<HANDLE>(t.as_raw_socket()));
             }
 
 
@@ -134,6 +132,7 @@ namespace laio {
                 ULONG_PTR token = 0;
                 LPOVERLAPPED overlapped = nullptr;
                 const DWORD duration = timeout ? static_cast<DWORD>((*timeout).count()) : INFINITE;
+                const int64_t waited = instrument::clock();
                 const BOOL ret = GetQueuedCompletionStatus(
                         handle_,
                         &bytes,
@@ -141,15 +140,25 @@ namespace laio {
                         &overlapped,
                         duration
                 );
-                if (ret == 0) {
-                    return wse::win_error{};
-                }
-                return CompletionStatus{OVERLAPPED_ENTRY{
+                CompletionStatus status{OVERLAPPED_ENTRY{
                         token,
                         overlapped,
                         0,
                         bytes,
                 }};
+                if (ret == 0) {
+
+                    // Failed operations are dequeued along with their overlapped structure, timeouts are not
+                    const Error error{};
+                    if (overlapped != nullptr) {
+                        instrument::dequeued(waited, gsl::span<CompletionStatus>{&status, 1});
+                    } else {
+                        instrument::missed(waited, error == wse::win_errc::wait_timeout);
+                    }
+                    return error;
+                }
+                instrument::dequeued(waited, gsl::span<CompletionStatus>{&status, 1});
+                return status;
             }
 
             /// Dequeue multiple completion statuses from this I/O completion port
@@ -170,6 +179,7 @@ namespace laio {
                         static_cast<DWORD>((std::numeric_limits<std::size_t>::max)()));
                 ULONG removed = 0;
                 const DWORD duration = timeout ? static_cast<DWORD>((*timeout).count()) : INFINITE;
+                const int64_t waited = instrument::clock();
                 const BOOL ret = GetQueuedCompletionStatusEx(
                         handle_,
                         reinterpret_cast<LPOVERLAPPED_ENTRY>(list.data()),
@@ -179,8 +189,11 @@ namespace laio {
                         static_cast<BOOL>(FALSE)
                 );
                 if (ret == 0) {
-                    return wse::win_error{};
+                    const Error error{};
+                    instrument::missed(waited, error == wse::win_errc::wait_timeout);
+                    return error;
                 }
+                instrument::dequeued(waited, list.first(static_cast<std::size_t>(removed)));
 
                 // Return a non-owning view into the array, spanning only the successfully dequeued Completion Statuses.
                 return list.first(static_cast<std::size_t>(removed));
@@ -199,8 +212,11 @@ namespace laio {
                         overlappedEntry.lpOverlapped
                 );
                 if (ret == 0) {
-                    return wse::win_error{};
+                    const Error error{};
+                    instrument::posted(false);
+                    return error;
                 }
+                instrument::posted(true);
                 return std::monostate{};
             }
 
@@ -225,7 +241,7 @@ namespace laio {
                         0
                 );
                 if (ret == nullptr) {
-                    return wse::win_error{};
+                    return Error{};
                 }
 
                 // ret == this->handle_.raw()
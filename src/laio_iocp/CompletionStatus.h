@@ -42,12 +42,12 @@ namespace laio {
             ///
             /// \param bytes Number of bytes that were successfully transferred
             /// \param token Unique token to this I/O operation
-            /// \param overlapped Pointer to associated overlapped structure
+            /// \param overlapped Pointer to associated overlapped structure, may be `nullptr`
             /// \return CompletionStatus
             static CompletionStatus create(const uint32_t bytes, std::size_t token, Overlapped* overlapped) noexcept {
                 return CompletionStatus{OVERLAPPED_ENTRY{
                         static_cast<ULONG_PTR>(token),
-                        overlapped->raw(),
+                        overlapped != nullptr ? overlapped->raw() : nullptr,
                         0,
                         static_cast<DWORD>(bytes),
                 }};
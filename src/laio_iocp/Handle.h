@@ -15,17 +15,14 @@
 #include <variant>
 
 #include "gsl/span"
-#include "win_error.h"
+#include "Result.h"
 
-#include "Overload.h"
+#include "Instrument.h"
 
 namespace laio {
 
     using std::uint8_t;
 
-    template<typename T>
-    using Result = std::variant<T, wse::win_error>;
-
     namespace iocp {
 
         /// Generic handle to Windows system resources
@@ -66,7 +63,7 @@ namespace laio {
                 return *this;
             }
 
-            operator HANDLE() noexcept {
+            operator HANDLE() const noexcept {
                 return raw_handle_;
             }
 
@@ -110,7 +107,7 @@ namespace laio {
                 if (res) {
                     return static_cast<std::size_t>(bytes);
                 } else {
-                    return wse::win_error{};
+                    return Error{};
                 }
             }
 
@@ -139,7 +136,7 @@ namespace laio {
                 if (res) {
                     return static_cast<std::size_t>(bytes);
                 } else {
-                    return wse::win_error{};
+                    return Error{};
                 }
             }
 
@@ -172,10 +169,10 @@ namespace laio {
 
                 // Does not throw if it accesses a `std::nullopt`, but due to `wait == TRUE`, that would constitute a
                 // logic error.
-                return std::visit(Overload{
-                        [](const std::optional<std::size_t> &arg) -> Result<std::size_t> { return *arg; },
-                        [](const wse::win_error &arg) -> Result<std::size_t> { return arg; },
-                }, res);
+                if (!res.has_value()) {
+                    return res.error();
+                }
+                return **res;
             }
 
             /// Asynchronously write data to file or I/O device and return immediately
@@ -207,10 +204,55 @@ namespace laio {
 
                 // Does not throw if it accesses a `std::nullopt`, but due to `wait == TRUE`, that would constitute a
                 // logic error.
-                return std::visit(Overload{
-                        [](const std::optional<std::size_t> &arg) -> Result<std::size_t> { return *arg; },
-                        [](const wse::win_error &arg) -> Result<std::size_t> { return arg; },
-                }, res);
+                if (!res.has_value()) {
+                    return res.error();
+                }
+                return **res;
+            }
+
+            /// Retrieve the result of an overlapped operation on this handle
+            ///
+            /// \details Queries the status of a read or write that has previously been submitted with the provided
+            /// overlapped structure. If `wait` is `true`, block until the operation has completed. If the overlapped
+            /// structure carries an event, the function waits on that event rather than on the handle, which allows
+            /// multiple operations to be in flight on the same handle at once.
+            ///
+            /// \param overlapped Raw overlapped structure of the submitted operation
+            /// \param wait Block thread until the operation has completed if `true`
+            /// \return Variant with optional number of bytes transferred if completed, error type otherwise
+            Result<std::optional<std::size_t>> result(OVERLAPPED* overlapped, bool wait) noexcept {
+                DWORD bytes = 0;
+                const BOOL res = GetOverlappedResult(
+                        raw_handle_,
+                        overlapped,
+                        &bytes,
+                        static_cast<BOOL>(wait)
+                );
+                if (res == 0) {
+                    const auto err = static_cast<wse::win_errc>(GetLastError());
+                    if (err == wse::win_errc::io_incomplete && !wait) {
+                        return std::nullopt;
+                    } else {
+                        return Error{err};
+                    }
+                }
+                return static_cast<std::size_t>(bytes);
+            }
+
+            /// Request cancellation of an overlapped operation on this handle
+            ///
+            /// \details Cancellation is asynchronous: the operation still completes, usually with
+            /// `ERROR_OPERATION_ABORTED`, and its result must be retrieved before the overlapped structure or the
+            /// buffer may be reused.
+            ///
+            /// \param overlapped Raw overlapped structure of the operation to cancel, or `nullptr` for all operations
+            /// issued on this handle
+            /// \return Variant with error type, in case the cancellation request has failed
+            Result<std::monostate> cancel(OVERLAPPED* overlapped) noexcept {
+                if (CancelIoEx(raw_handle_, overlapped) == 0) {
+                    return Error{};
+                }
+                return std::monostate{};
             }
 
         private:
@@ -230,6 +272,7 @@ namespace laio {
                 // For unsigned char `buf.size_bytes() == buf.size()`
                 const DWORD len = (std::min)(static_cast<DWORD>(buf.size_bytes()),
                         static_cast<DWORD>((std::numeric_limits<std::size_t>::max)()));
+                instrument::submitted(overlapped, instrument::Op::Read, len);
                 BOOL res = ReadFile(
                         raw_handle_,
                         buf.data(),
@@ -240,7 +283,8 @@ namespace laio {
                 if (res == 0) {
                     const auto err = static_cast<wse::win_errc>(GetLastError());
                     if (err != wse::win_errc::io_pending) {
-                        return wse::win_error{err};
+                        instrument::rejected(overlapped);
+                        return Error{err};
                     }
                 }
                 DWORD bytes = 0;
@@ -257,7 +301,7 @@ namespace laio {
                     if (err == wse::win_errc::io_incomplete && wait == FALSE) {
                         return std::nullopt;
                     } else {
-                        return wse::win_error{err};
+                        return Error{err};
                     }
                 }
                 return static_cast<std::size_t>(bytes);
@@ -279,6 +323,7 @@ namespace laio {
                 // For unsigned char `buf.size_bytes() == buf.size()`
                 const DWORD len = (std::min)(static_cast<DWORD>(buf.size_bytes()),
                         static_cast<DWORD>((std::numeric_limits<std::size_t>::max)()));
+                instrument::submitted(overlapped, instrument::Op::Write, len);
                 BOOL res = WriteFile(
                         raw_handle_,
                         buf.data(),
@@ -289,7 +334,8 @@ namespace laio {
                 if (res == 0) {
                     const auto err = static_cast<wse::win_errc>(GetLastError());
                     if (err != wse::win_errc::io_pending) {
-                        return wse::win_error{err};
+                        instrument::rejected(overlapped);
+                        return Error{err};
                     }
                 }
                 DWORD bytes = 0;
@@ -299,7 +345,7 @@ namespace laio {
                     if (err == wse::win_errc::io_incomplete && wait == FALSE) {
                         return std::nullopt;
                     } else {
-                        return wse::win_error{err};
+                        return Error{err};
                     }
                 }
                 return static_cast<std::size_t>(bytes);
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace laio::iocp {
+
+    using std::uint64_t;
+
+    /// Log-linear histogram of durations in nanoseconds, modelled after HdrHistogram
+    ///
+    /// \details Each power of two is divided into `SUB_BUCKETS` buckets of equal width, so that a recorded value is
+    /// off by at most 1/`SUB_BUCKETS` of itself, across the whole range from nanoseconds to minutes. Values below
+    /// `SUB_BUCKETS` are counted exactly, values beyond the range are counted in the last bucket.
+    /// A histogram has a single writer: `record` is a plain load and store of a relaxed atomic, so that other threads
+    /// can `merge` it at any time without locking the writer out. Concurrent writers lose counts.
+    class Histogram {
+
+    public:
+        static constexpr unsigned SUB_BUCKET_BITS = 4;                          ///< Relative error of 1/16
+        static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;          ///< Buckets per power of two
+        static constexpr unsigned MAX_BITS = 40;                                ///< Values up to about 18 minutes
+        static constexpr std::size_t BUCKETS = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKETS> counts_{};
+
+        /// Return index of the most significant set bit of a non-zero value
+        static unsigned msb_(uint64_t value) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return static_cast<unsigned>(index);
+#elif defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+            if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32u)) != 0) return index + 32u;
+            _BitScanReverse(&index, static_cast<unsigned long>(value));
+            return static_cast<unsigned>(index);
+#else
+            return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+        }
+
+    public:
+        // # Constructors
+        Histogram() noexcept = default;
+
+        Histogram(const Histogram& other) noexcept {
+            merge(other);
+        }
+
+        // # Operator overloads
+        Histogram& operator=(const Histogram& rhs) noexcept {
+            if (this != &rhs) {
+                clear();
+                merge(rhs);
+            }
+            return *this;
+        }
+
+        // # Public member functions
+
+        /// Return index of the bucket counting the provided value
+        static std::size_t bucket(uint64_t value) noexcept {
+            if (value < SUB_BUCKETS) return static_cast<std::size_t>(value);
+            if (value >> MAX_BITS != 0) return BUCKETS - 1;
+            const unsigned shift = msb_(value) - SUB_BUCKET_BITS;
+            return static_cast<std::size_t>(shift + 1) * SUB_BUCKETS + static_cast<std::size_t>((value >> shift) - SUB_BUCKETS);
+        }
+
+        /// Return smallest value counted by the bucket at the provided index
+        static constexpr uint64_t lower_bound(std::size_t index) noexcept {
+            if (index < SUB_BUCKETS) return index;
+            const auto shift = static_cast<unsigned>(index / SUB_BUCKETS - 1);
+            return (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        }
+
+        /// Return largest value counted by the bucket at the provided index
+        static constexpr uint64_t upper_bound(std::size_t index) noexcept {
+            if (index < SUB_BUCKETS) return index;
+            const auto shift = static_cast<unsigned>(index / SUB_BUCKETS - 1);
+            return lower_bound(index) + (uint64_t{1} << shift) - 1;
+        }
+
+        /// Count a value
+        ///
+        /// \param value Duration in nanoseconds
+        void record(uint64_t value) noexcept {
+            std::atomic<uint64_t>& count = counts_[bucket(value)];
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        /// Add all counts of another histogram to this one
+        void merge(const Histogram& other) noexcept {
+            for (std::size_t i = 0; i < BUCKETS; ++i) {
+                const uint64_t count = other.counts_[i].load(std::memory_order_relaxed);
+                if (count != 0) counts_[i].fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+
+        /// Reset all counts to zero
+        void clear() noexcept {
+            for (std::atomic<uint64_t>& count : counts_) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /// Return number of values counted by the bucket at the provided index
+        [[nodiscard]] uint64_t count(std::size_t index) const noexcept {
+            return counts_[index].load(std::memory_order_relaxed);
+        }
+
+        /// Return number of values counted
+        [[nodiscard]] uint64_t count() const noexcept {
+            uint64_t total = 0;
+            for (const std::atomic<uint64_t>& count : counts_) {
+                total += count.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        /// Return value below which the provided fraction of all values lies
+        ///
+        /// \details Returns the largest value of the bucket the percentile falls into, like HdrHistogram, so that the
+        /// percentile is never underestimated.
+        ///
+        /// \param fraction Fraction of values between 0 and 1, e.g. 0.99 for the 99th percentile
+        /// \return Value in nanoseconds, or zero if the histogram is empty
+        [[nodiscard]] uint64_t value_at(double fraction) const noexcept {
+            const uint64_t total = count();
+            if (total == 0) return 0;
+            auto rank = static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5);
+            rank = rank == 0 ? 1 : (rank > total ? total : rank);
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < BUCKETS; ++i) {
+                seen += counts_[i].load(std::memory_order_relaxed);
+                if (seen >= rank) return upper_bound(i);
+            }
+            return upper_bound(BUCKETS - 1);
+        }
+
+    }; // class Histogram
+
+} // namespace laio::iocp
@@ -0,0 +1,632 @@
+#pragma once
+
+#include "WinIncludes.h"
+
+#include <minwinbase.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gsl/span"
+
+#include "CompletionStatus.h"
+#include "Histogram.h"
+#include "Metrics.h"
+#include "Overlapped.h"
+#include "TraceRing.h"
+
+// Number of events retained per thread by `LAIO_TRACE`, must be a power of two
+#if !defined(LAIO_TRACE_CAPACITY)
+    #define LAIO_TRACE_CAPACITY 32768
+#endif
+
+namespace laio::iocp::instrument {
+
+    using std::int64_t;
+    using std::uint8_t;
+    using std::uint32_t;
+    using std::uint64_t;
+
+    /// Whether operations are timed into histograms, selected at compile time through `LAIO_INSTRUMENT`
+    constexpr bool ENABLED = LAIO_INSTRUMENT != 0;
+
+    /// Whether operations are traced, selected at compile time through `LAIO_TRACE`
+    constexpr bool TRACED = LAIO_TRACE != 0;
+
+    /// Whether operations and dequeuing calls are counted, selected at compile time through `LAIO_METRICS`
+    constexpr bool METERED = LAIO_METRICS != 0;
+
+    /// Type of an overlapped operation
+    enum class Op : uint8_t {
+        Read,
+        Write,
+        Accept,
+        Connect,
+    };
+
+    constexpr std::size_t OPS = 4;              ///< Number of operation types
+    static_assert(OPS == MetricsCell::OPS);
+    constexpr std::size_t TOKEN_GROUPS = 4;     ///< Number of groups completion tokens are divided into
+
+    /// Return group of the provided completion token
+    ///
+    /// \details Tokens are grouped by their remainder, so that applications can assign tokens of one kind of handle,
+    /// e.g. listeners, clients and backends, to the same group.
+    constexpr std::size_t group_of(std::size_t token) noexcept {
+        return token % TOKEN_GROUPS;
+    }
+
+    /// Return name of the provided operation type
+    constexpr const char* name_of(Op op) noexcept {
+        switch (op) {
+            case Op::Read: return "read";
+            case Op::Write: return "write";
+            case Op::Accept: return "accept";
+            case Op::Connect: return "connect";
+        }
+        return "unknown";
+    }
+
+    /// Latency histograms of all combinations of operation type and token group
+    class Histograms {
+
+        std::array<Histogram, OPS * TOKEN_GROUPS> histograms_{};
+
+    public:
+        // # Public member functions
+
+        /// Return histogram of the provided operation type and token group
+        Histogram& of(Op op, std::size_t group) noexcept {
+            return histograms_[static_cast<std::size_t>(op) * TOKEN_GROUPS + group];
+        }
+
+        /// Return histogram of the provided operation type and token group
+        [[nodiscard]] const Histogram& of(Op op, std::size_t group) const noexcept {
+            return histograms_[static_cast<std::size_t>(op) * TOKEN_GROUPS + group];
+        }
+
+        /// Return histogram of the provided operation type across all token groups
+        [[nodiscard]] Histogram of(Op op) const noexcept {
+            Histogram merged{};
+            for (std::size_t group = 0; group < TOKEN_GROUPS; ++group) {
+                merged.merge(of(op, group));
+            }
+            return merged;
+        }
+
+        /// Add all counts of other histograms to these
+        void merge(const Histograms& other) noexcept {
+            for (std::size_t i = 0; i < histograms_.size(); ++i) {
+                histograms_[i].merge(other.histograms_[i]);
+            }
+        }
+
+        /// Return number of operations timed
+        [[nodiscard]] uint64_t count() const noexcept {
+            uint64_t total = 0;
+            for (const Histogram& histogram : histograms_) {
+                total += histogram.count();
+            }
+            return total;
+        }
+
+    }; // class Histograms
+
+#if LAIO_INSTRUMENT || LAIO_TRACE || LAIO_METRICS
+    namespace detail {
+
+        /// Instrumentation state of a single thread, which only that thread writes to
+        struct Thread {
+            std::size_t id = 0;
+            std::string name{};
+#if LAIO_INSTRUMENT
+            Histograms histograms{};
+#endif
+#if LAIO_TRACE
+            TraceRing ring{LAIO_TRACE_CAPACITY};
+#endif
+#if LAIO_METRICS
+            MetricsCell metrics{};
+#endif
+        };
+
+        /// State of all threads, which have ever been instrumented
+        ///
+        /// \details Threads are never freed before the process exits, so that the operations of threads that have
+        /// already exited still show up in snapshots and traces.
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Thread>> threads;
+        };
+
+        inline Registry& registry() {
+            static Registry registry{};
+            return registry;
+        }
+
+        /// Return state of the calling thread
+        inline Thread& local() {
+            thread_local Thread* thread = nullptr;
+            if (thread == nullptr) {
+                Registry& all = registry();
+                std::lock_guard<std::mutex> lock{all.mutex};
+                all.threads.push_back(std::make_unique<Thread>());
+                thread = all.threads.back().get();
+                thread->id = all.threads.size() - 1;
+            }
+            return *thread;
+        }
+
+        inline int64_t now() noexcept {
+            using namespace std::chrono;
+            return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        inline uint32_t clamp(std::size_t bytes) noexcept {
+            return static_cast<uint32_t>((std::min)(bytes, std::size_t{UINT32_MAX}));
+        }
+
+        /// Submission of an operation in flight
+        struct Stamp {
+            int64_t ticks = 0;      ///< Steady clock time in nanoseconds, zero if no operation is in flight
+            uint8_t op = 0;         ///< Type of the operation, see `Op`
+        };
+
+        /// Submissions of all operations in flight, keyed by their raw overlapped structures
+        ///
+        /// \details Kept apart from the structures, so that callers may submit any `OVERLAPPED`, not only the inner
+        /// structure of an `Overlapped`. Operations complete on other threads than they are submitted on, so that the
+        /// table is shared by all threads and split into independently locked shards to keep contention low.
+        class Stamps {
+
+            static constexpr std::size_t SHARDS = 64;
+
+            struct alignas(64) Shard {
+                std::mutex mutex;
+                std::unordered_map<const OVERLAPPED*, Stamp> stamps;
+            };
+
+            std::array<Shard, SHARDS> shards_{};
+
+            Shard& shard_(const OVERLAPPED* overlapped) noexcept {
+                const auto address = reinterpret_cast<std::uintptr_t>(overlapped);
+                return shards_[((address >> 4u) ^ (address >> 12u)) % SHARDS];
+            }
+
+        public:
+            /// Record submission of an operation, replacing any stale one of the same structure
+            ///
+            /// \details Operations, whose submission cannot be recorded for lack of memory, are not instrumented.
+            void insert(const OVERLAPPED* overlapped, Stamp stamp) noexcept {
+                Shard& shard = shard_(overlapped);
+                std::lock_guard<std::mutex> lock{shard.mutex};
+                try {
+                    shard.stamps.insert_or_assign(overlapped, stamp);
+                } catch (...) {
+                    shard.stamps.erase(overlapped);
+                }
+            }
+
+            /// Remove and return submission of an operation, with zero ticks if none has been recorded
+            Stamp take(const OVERLAPPED* overlapped) noexcept {
+                Shard& shard = shard_(overlapped);
+                std::lock_guard<std::mutex> lock{shard.mutex};
+                auto it = shard.stamps.find(overlapped);
+                if (it == shard.stamps.end()) {
+                    return Stamp{};
+                }
+                const Stamp stamp = it->second;
+                shard.stamps.erase(it);
+                return stamp;
+            }
+
+        }; // class Stamps
+
+        inline Stamps& stamps() {
+            static Stamps stamps{};
+            return stamps;
+        }
+
+        /// Return whether the raw structure of a dequeued operation holds an error status
+        inline bool failed(const OVERLAPPED* overlapped) noexcept {
+            return overlapped != nullptr && static_cast<uint32_t>(overlapped->Internal) >> 30u == 3u;
+        }
+
+        /// Record completion of a single operation and remove its submission
+        ///
+        /// \param thread State of the calling thread
+        /// \param time Time the completion has been observed
+        /// \param raw Raw overlapped structure, may be `nullptr`
+        /// \param token Completion key of the operation
+        /// \param bytes Number of bytes transferred
+        inline void finished(Thread& thread, [[maybe_unused]] int64_t time, OVERLAPPED* raw,
+                             [[maybe_unused]] std::size_t token, [[maybe_unused]] uint32_t bytes) noexcept {
+            const Stamp stamp = raw != nullptr ? stamps().take(raw) : Stamp{};
+#if LAIO_INSTRUMENT
+            if (stamp.ticks != 0) {
+                const int64_t elapsed = time - stamp.ticks;
+                thread.histograms.of(static_cast<Op>(stamp.op), group_of(token))
+                        .record(elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0);
+            }
+#endif
+#if LAIO_TRACE
+            thread.ring.push(TraceEvent{time, 0, reinterpret_cast<std::uintptr_t>(raw), token, bytes,
+                                        TraceEvent::Kind::Complete,
+                                        static_cast<uint8_t>(stamp.ticks != 0 ? stamp.op : UINT8_MAX)});
+#endif
+#if LAIO_METRICS
+            if (stamp.ticks != 0) {
+                MetricsCell::add(thread.metrics.completed[stamp.op]);
+                if (failed(raw)) {
+                    MetricsCell::add(thread.metrics.failed[stamp.op]);
+                }
+            }
+#endif
+        }
+
+    } // namespace detail
+#endif
+
+    /// Return current time for `dequeued`, if operations are traced or counted
+    ///
+    /// \return Steady clock time in nanoseconds, zero unless `LAIO_TRACE` or `LAIO_METRICS` is enabled
+    inline int64_t clock() noexcept {
+#if LAIO_TRACE || LAIO_METRICS
+        return detail::now();
+#else
+        return 0;
+#endif
+    }
+
+    /// Record submission of an overlapped operation
+    ///
+    /// \details Must be called before the operation is handed to the system, since it may complete on another thread
+    /// before the submitting call returns. Compiles to nothing, unless `LAIO_INSTRUMENT`, `LAIO_TRACE` or
+    /// `LAIO_METRICS` is enabled.
+    ///
+    /// \param overlapped Raw overlapped structure of the operation
+    /// \param op Type of the operation
+    /// \param bytes Size of the buffer handed to the system
+    inline void submitted([[maybe_unused]] OVERLAPPED* overlapped, [[maybe_unused]] Op op,
+                          [[maybe_unused]] std::size_t bytes = 0) noexcept {
+#if LAIO_INSTRUMENT || LAIO_TRACE || LAIO_METRICS
+        const int64_t time = detail::now();
+        detail::stamps().insert(overlapped, detail::Stamp{time, static_cast<uint8_t>(op)});
+#endif
+#if LAIO_TRACE
+        detail::local().ring.push(TraceEvent{time, 0, reinterpret_cast<std::uintptr_t>(overlapped), 0,
+                                             detail::clamp(bytes), TraceEvent::Kind::Submit,
+                                             static_cast<uint8_t>(op)});
+#endif
+#if LAIO_METRICS
+        MetricsCell::add(detail::local().metrics.submitted[static_cast<std::size_t>(op)]);
+#endif
+    }
+
+    /// Record an operation, which the system has failed immediately after its submission
+    ///
+    /// \details Such operations are never dequeued from a completion port, so that submitting calls must report them
+    /// to keep them from counting as in flight. Compiles to nothing, unless `LAIO_INSTRUMENT`, `LAIO_TRACE` or
+    /// `LAIO_METRICS` is enabled.
+    ///
+    /// \param overlapped Raw overlapped structure of the operation, as passed to `submitted`
+    inline void rejected([[maybe_unused]] OVERLAPPED* overlapped) noexcept {
+#if LAIO_INSTRUMENT || LAIO_TRACE || LAIO_METRICS
+        [[maybe_unused]] const detail::Stamp stamp = detail::stamps().take(overlapped);
+#if LAIO_METRICS
+        if (stamp.ticks != 0) {
+            MetricsCell::add(detail::local().metrics.rejected[stamp.op]);
+        }
+#endif
+#endif
+    }
+
+    /// Record completion statuses dequeued from a completion port
+    ///
+    /// \details Counts the time since submission of every operation in the histograms of the calling thread, and
+    /// removes their submissions. Completions of structures without a submission, e.g. posted ones, are not
+    /// counted. If traced, the dequeuing call and every completion are recorded in the ring of the calling thread. If
+    /// counted, the size of the batch, the time blocked in the call and busy since the previous one, and completed and
+    /// failed operations are added to the metrics of the calling thread. Compiles to nothing, unless `LAIO_INSTRUMENT`,
+    /// `LAIO_TRACE` or `LAIO_METRICS` is enabled.
+    ///
+    /// \param waited Time the dequeuing call has started, as returned by `clock`
+    /// \param statuses Dequeued completion statuses
+    inline void dequeued([[maybe_unused]] int64_t waited, [[maybe_unused]] gsl::span<CompletionStatus> statuses) noexcept {
+#if LAIO_INSTRUMENT || LAIO_TRACE || LAIO_METRICS
+        const int64_t time = detail::now();
+        detail::Thread& thread = detail::local();
+#if LAIO_TRACE
+        thread.ring.push(TraceEvent{waited, time - waited, 0, 0, detail::clamp(statuses.size()),
+                                    TraceEvent::Kind::Dequeue, 0});
+#endif
+#if LAIO_METRICS
+        thread.metrics.waited(waited, time);
+        MetricsCell::add(thread.metrics.batches[MetricsCell::bucket(statuses.size())]);
+        MetricsCell::add(thread.metrics.statuses, statuses.size());
+#endif
+        for (CompletionStatus& status : statuses) {
+            detail::finished(thread, time, status.overlapped(), status.token(), status.bytes_transferred());
+        }
+#endif
+    }
+
+    /// Record completion of an overlapped operation, which has been polled for instead of dequeued
+    ///
+    /// \details Counts the operation like a dequeued one with the provided completion key, e.g. a connect, whose result
+    /// is retrieved through `WSAGetOverlappedResult` on a socket without completion port. Must be called exactly once,
+    /// after the system has released the structure, and only for operations, which are never dequeued. Compiles to
+    /// nothing, unless `LAIO_INSTRUMENT`, `LAIO_TRACE` or `LAIO_METRICS` is enabled.
+    ///
+    /// \param overlapped Raw overlapped structure of the completed operation
+    /// \param bytes Number of bytes transferred
+    /// \param token Completion key to count the operation under
+    inline void completed([[maybe_unused]] OVERLAPPED* overlapped, [[maybe_unused]] std::size_t bytes = 0,
+                          [[maybe_unused]] std::size_t token = 0) noexcept {
+#if LAIO_INSTRUMENT || LAIO_TRACE || LAIO_METRICS
+        detail::finished(detail::local(), detail::now(), overlapped, token, detail::clamp(bytes));
+#endif
+    }
+
+    /// Record a dequeuing call, which has returned without a completion status
+    ///
+    /// \details Compiles to nothing, unless `LAIO_METRICS` is enabled.
+    ///
+    /// \param waited Time the dequeuing call has started, as returned by `clock`
+    /// \param timed_out Whether the call has timed out rather than failed
+    inline void missed([[maybe_unused]] int64_t waited, [[maybe_unused]] bool timed_out) noexcept {
+#if LAIO_METRICS
+        MetricsCell& metrics = detail::local().metrics;
+        metrics.waited(waited, detail::now());
+        MetricsCell::add(timed_out ? metrics.timeouts : metrics.dequeue_errors);
+#endif
+    }
+
+    /// Record a completion status posted to a completion port
+    ///
+    /// \details Compiles to nothing, unless `LAIO_METRICS` is enabled.
+    ///
+    /// \param succeeded Whether the status has been posted
+    inline void posted([[maybe_unused]] bool succeeded) noexcept {
+#if LAIO_METRICS
+        MetricsCell& metrics = detail::local().metrics;
+        MetricsCell::add(succeeded ? metrics.posts : metrics.post_errors);
+#endif
+    }
+
+    /// Scope of the handling of a completion status by the application, which is traced if `LAIO_TRACE` is enabled
+    ///
+    /// \details Dispatch loops create one on the stack for every completion status they handle, so that the time spent
+    /// per completion shows up in the trace between the dequeuing calls.
+    class Dispatch {
+
+#if LAIO_TRACE
+        TraceEvent event_;
+#endif
+
+    public:
+        // # Constructors
+        explicit Dispatch([[maybe_unused]] CompletionStatus& status) noexcept
+#if LAIO_TRACE
+            : event_{detail::now(), 0, reinterpret_cast<std::uintptr_t>(status.overlapped()), status.token(),
+                     status.bytes_transferred(), TraceEvent::Kind::Dispatch, 0}
+#endif
+        {}
+
+        Dispatch(const Dispatch& other) = delete;
+
+        ~Dispatch() {
+#if LAIO_TRACE
+            event_.duration = detail::now() - event_.time;
+            detail::local().ring.push(event_);
+#endif
+        }
+
+        // # Operator overloads
+        Dispatch& operator=(const Dispatch& rhs) = delete;
+
+    }; // class Dispatch
+
+    /// Name the calling thread in traces and metrics
+    ///
+    /// \param name Name shown for the thread, e.g. "worker 3"
+    inline void name_thread([[maybe_unused]] std::string name) {
+#if LAIO_INSTRUMENT || LAIO_TRACE || LAIO_METRICS
+        detail::Thread& thread = detail::local();
+        std::lock_guard<std::mutex> lock{detail::registry().mutex};
+        thread.name = std::move(name);
+#endif
+    }
+
+    /// Merge the histograms of all threads
+    ///
+    /// \details Threads keep recording while the snapshot is taken, so that an operation in the middle of being
+    /// recorded may or may not be counted.
+    ///
+    /// \return Merged histograms, which are empty unless `LAIO_INSTRUMENT` is enabled
+    inline Histograms snapshot() {
+        Histograms merged{};
+#if LAIO_INSTRUMENT
+        detail::Registry& all = detail::registry();
+        std::lock_guard<std::mutex> lock{all.mutex};
+        for (const std::unique_ptr<detail::Thread>& thread : all.threads) {
+            merged.merge(thread->histograms);
+        }
+#endif
+        return merged;
+    }
+
+    /// Read the counters of all threads
+    ///
+    /// \details Threads keep counting while the snapshot is taken, so that an operation in the middle of being counted
+    /// may or may not show up.
+    ///
+    /// \return Snapshot, which is empty unless `LAIO_METRICS` is enabled
+    inline Metrics metrics() {
+        Metrics snapshot{};
+#if LAIO_METRICS
+        detail::Registry& all = detail::registry();
+        std::lock_guard<std::mutex> lock{all.mutex};
+        for (const std::unique_ptr<detail::Thread>& thread : all.threads) {
+            snapshot.merge(thread->metrics, thread->id, thread->name);
+        }
+#endif
+        return snapshot;
+    }
+
+    /// Write the events retained by all threads as Chrome trace JSON
+    ///
+    /// \details The document opens in Perfetto and `chrome://tracing`. Every thread is a track, on which submissions
+    /// and completions are marks, while dequeuing calls and dispatches are slices, so that batch boundaries, stalls
+    /// and head-of-line blocking are visible. Flows connect the submission of an operation to its completion, which
+    /// may be on another thread. Threads keep tracing while the document is written.
+    ///
+    /// \param out Stream to write the document to
+    inline void write_trace([[maybe_unused]] std::ostream& out) {
+        out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+#if LAIO_TRACE
+        const char* separator = "\n";
+        const auto microseconds = [&out](int64_t nanoseconds) -> std::ostream& {
+            const char* sign = nanoseconds < 0 ? "-" : "";
+            const auto magnitude = static_cast<uint64_t>(nanoseconds < 0 ? -nanoseconds : nanoseconds);
+            const uint64_t fraction = magnitude % 1000;
+            return out << sign << magnitude / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+        };
+        const auto address = [&out](std::uintptr_t overlapped) -> std::ostream& {
+            return out << "0x" << std::hex << overlapped << std::dec;
+        };
+        detail::Registry& all = detail::registry();
+        std::lock_guard<std::mutex> lock{all.mutex};
+        for (const std::unique_ptr<detail::Thread>& thread : all.threads) {
+            out << separator << R"(  {"name": "thread_name", "ph": "M", "pid": 1, "tid": )" << thread->id
+                << R"(, "args": {"name": ")";
+            for (const char c : thread->name.empty() ? "thread " + std::to_string(thread->id) : thread->name) {
+                if (c == '"' || c == '\\') out << '\\';
+                if (static_cast<unsigned char>(c) >= 0x20) out << c;
+            }
+            out << "\"}}";
+            separator = ",\n";
+            for (const TraceEvent& event : thread->ring.events()) {
+                const char* name = event.op < OPS ? name_of(static_cast<Op>(event.op)) : "posted";
+                out << separator << "  {\"pid\": 1, \"tid\": " << thread->id << ", \"ts\": ";
+                microseconds(event.time);
+                switch (event.kind) {
+                    case TraceEvent::Kind::Submit:
+                        out << R"(, "ph": "X", "dur": 0, "cat": "submit", "name": "submit )" << name
+                            << R"(", "bind_id": ")";
+                        address(event.overlapped) << R"(", "flow_out": true, "args": {"overlapped": ")";
+                        address(event.overlapped) << R"(", "bytes": )" << event.bytes << "}}";
+                        break;
+                    case TraceEvent::Kind::Complete:
+                        out << R"(, "ph": "X", "dur": 0, "cat": "complete", "name": "complete )" << name << '"';
+                        if (event.op < OPS) {
+                            out << R"(, "bind_id": ")";
+                            address(event.overlapped) << R"(", "flow_in": true)";
+                        }
+                        out << R"(, "args": {"token": )" << event.token << R"(, "overlapped": ")";
+                        address(event.overlapped) << R"(", "bytes": )" << event.bytes << "}}";
+                        break;
+                    case TraceEvent::Kind::Dequeue:
+                        out << R"(, "ph": "X", "dur": )";
+                        microseconds(event.duration) << R"(, "cat": "dequeue", "name": "dequeue", "args": {"statuses": )"
+                                                     << event.bytes << "}}";
+                        break;
+                    case TraceEvent::Kind::Dispatch:
+                        out << R"(, "ph": "X", "dur": )";
+                        microseconds(event.duration) << R"(, "cat": "dispatch", "name": "dispatch", "args": {"token": )"
+                                                     << event.token << R"(, "overlapped": ")";
+                        address(event.overlapped) << R"(", "bytes": )" << event.bytes << "}}";
+                        break;
+                }
+            }
+        }
+#endif
+        out << "\n]}\n";
+    }
+
+    /// Write a snapshot of the counters of all threads in the Prometheus text format
+    ///
+    /// \details Counters of operations are labelled by operation type, batch sizes of dequeuing calls form a histogram,
+    /// and the time spent in and between dequeuing calls is labelled by thread. Rates, e.g. posts per second, are left
+    /// to the scraper.
+    ///
+    /// \param out Stream to write the metrics to
+    /// \param snapshot Counters as returned by `metrics`
+    inline void write_metrics(std::ostream& out, const Metrics& snapshot) {
+        const auto family = [&out](const char* name, const char* type, const char* help) {
+            out << "# HELP laio_" << name << ' ' << help << "\n# TYPE laio_" << name << ' ' << type << '\n';
+        };
+        const auto per_op = [&](const char* name, const char* type, const char* help, auto&& value) {
+            family(name, type, help);
+            for (std::size_t op = 0; op < OPS; ++op) {
+                out << "laio_" << name << "{op=\"" << name_of(static_cast<Op>(op)) << "\"} " << value(op) << '\n';
+            }
+        };
+        const auto label = [&out](const Metrics::Worker& worker) -> std::ostream& {
+            out << "{thread=\"";
+            for (const char c : worker.name.empty() ? "thread " + std::to_string(worker.id) : worker.name) {
+                if (c == '"' || c == '\\') out << '\\';
+                if (c == '\n') out << "\\n";
+                else out << c;
+            }
+            return out << "\"}";
+        };
+
+        per_op("operations_submitted_total", "counter", "Operations handed to the system.",
+               [&](std::size_t op) { return snapshot.submitted[op]; });
+        per_op("operations_rejected_total", "counter", "Operations the system has failed immediately.",
+               [&](std::size_t op) { return snapshot.rejected[op]; });
+        per_op("operations_completed_total", "counter", "Operations dequeued from a completion port.",
+               [&](std::size_t op) { return snapshot.completed[op]; });
+        per_op("operations_failed_total", "counter", "Operations dequeued with an error.",
+               [&](std::size_t op) { return snapshot.failed[op]; });
+        per_op("operations_in_flight", "gauge", "Operations submitted, but not dequeued yet.",
+               [&](std::size_t op) { return snapshot.in_flight(op); });
+
+        family("dequeue_batch_size", "histogram", "Completion statuses per successful dequeuing call.");
+        uint64_t calls = 0;
+        for (std::size_t i = 0; i < MetricsCell::BATCH_BUCKETS; ++i) {
+            calls += snapshot.batches[i];
+            out << "laio_dequeue_batch_size_bucket{le=\"";
+            if (i + 1 < MetricsCell::BATCH_BUCKETS) out << MetricsCell::upper_bound(i);
+            else out << "+Inf";
+            out << "\"} " << calls << '\n';
+        }
+        out << "laio_dequeue_batch_size_sum " << snapshot.statuses << '\n'
+            << "laio_dequeue_batch_size_count " << calls << '\n';
+
+        family("dequeue_timeouts_total", "counter", "Dequeuing calls, which have timed out.");
+        out << "laio_dequeue_timeouts_total " << snapshot.timeouts << '\n';
+        family("dequeue_errors_total", "counter", "Dequeuing calls, which have failed otherwise.");
+        out << "laio_dequeue_errors_total " << snapshot.dequeue_errors << '\n';
+        family("posts_total", "counter", "Completion statuses posted.");
+        out << "laio_posts_total " << snapshot.posts << '\n';
+        family("post_errors_total", "counter", "Completion statuses, which have failed to be posted.");
+        out << "laio_post_errors_total " << snapshot.post_errors << '\n';
+
+        family("worker_blocked_seconds_total", "counter", "Time spent inside dequeuing calls.");
+        for (const Metrics::Worker& worker : snapshot.workers) {
+            out << "laio_worker_blocked_seconds_total";
+            label(worker) << ' ' << static_cast<double>(worker.blocked) / 1e9 << '\n';
+        }
+        family("worker_busy_seconds_total", "counter", "Time spent between dequeuing calls.");
+        for (const Metrics::Worker& worker : snapshot.workers) {
+            out << "laio_worker_busy_seconds_total";
+            label(worker) << ' ' << static_cast<double>(worker.busy) / 1e9 << '\n';
+        }
+        family("worker_utilization", "gauge", "Fraction of the time spent between dequeuing calls.");
+        for (const Metrics::Worker& worker : snapshot.workers) {
+            out << "laio_worker_utilization";
+            label(worker) << ' ' << worker.utilization() << '\n';
+        }
+    }
+
+} // namespace laio::iocp::instrument
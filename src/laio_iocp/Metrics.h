@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace laio::iocp {
+
+    using std::int64_t;
+    using std::uint64_t;
+
+    /// Counters of a single thread, which only that thread writes to
+    ///
+    /// \details Every counter is a plain load and store of a relaxed atomic, so that other threads can read the cell at
+    /// any time without locking the writer out. The cell fills whole cache lines, so that the counters of different
+    /// threads never share one.
+    struct alignas(64) MetricsCell {
+
+        static constexpr std::size_t OPS = 4;               ///< Number of operation types, see `instrument::Op`
+        static constexpr std::size_t BATCH_BUCKETS = 11;    ///< Batches of 1, 2, up to 4, ... up to 512 and more
+
+        std::array<std::atomic<uint64_t>, OPS> submitted{};     ///< Operations handed to the system
+        std::array<std::atomic<uint64_t>, OPS> rejected{};      ///< Operations the system has failed immediately
+        std::array<std::atomic<uint64_t>, OPS> completed{};     ///< Operations dequeued from a port
+        std::array<std::atomic<uint64_t>, OPS> failed{};        ///< Operations dequeued with an error
+        std::array<std::atomic<uint64_t>, BATCH_BUCKETS> batches{};     ///< Dequeuing calls by number of statuses
+        std::atomic<uint64_t> statuses{0};          ///< Completion statuses dequeued
+        std::atomic<uint64_t> timeouts{0};          ///< Dequeuing calls, which have timed out
+        std::atomic<uint64_t> dequeue_errors{0};    ///< Dequeuing calls, which have failed otherwise
+        std::atomic<uint64_t> posts{0};             ///< Completion statuses posted
+        std::atomic<uint64_t> post_errors{0};       ///< Completion statuses, which have failed to be posted
+        std::atomic<uint64_t> blocked{0};           ///< Nanoseconds spent inside dequeuing calls
+        std::atomic<uint64_t> busy{0};              ///< Nanoseconds spent between dequeuing calls
+        int64_t returned = 0;                       ///< Time the last dequeuing call has returned, zero before the first
+
+        /// Return index of the batch bucket counting the provided number of dequeued statuses
+        static std::size_t bucket(uint64_t size) noexcept {
+            std::size_t index = 0;
+            while (index < BATCH_BUCKETS - 1 && (uint64_t{1} << index) < size) ++index;
+            return index;
+        }
+
+        /// Return largest number of statuses counted by the batch bucket at the provided index
+        static constexpr uint64_t upper_bound(std::size_t index) noexcept {
+            return uint64_t{1} << index;
+        }
+
+        /// Add value to a counter of this cell
+        ///
+        /// \details Must only be called by the thread owning the cell.
+        static void add(std::atomic<uint64_t>& counter, uint64_t value = 1) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        /// Count the time of a dequeuing call as blocked, and the time since the previous one as busy
+        ///
+        /// \details Must only be called by the thread owning the cell.
+        ///
+        /// \param waited Time the call has started, in nanoseconds
+        /// \param time Time the call has returned, in nanoseconds
+        void waited(int64_t waited, int64_t time) noexcept {
+            if (returned != 0 && waited > returned) add(busy, static_cast<uint64_t>(waited - returned));
+            if (time > waited) add(blocked, static_cast<uint64_t>(time - waited));
+            returned = time;
+        }
+
+    }; // struct MetricsCell
+
+    /// Snapshot of the counters of all threads
+    struct Metrics {
+
+        /// Time a single thread has spent in and between dequeuing calls
+        struct Worker {
+            std::size_t id = 0;     ///< Index of the thread in traces and snapshots
+            std::string name{};     ///< Name of the thread, empty unless named
+            uint64_t blocked = 0;   ///< Nanoseconds spent inside dequeuing calls
+            uint64_t busy = 0;      ///< Nanoseconds spent between dequeuing calls
+
+            /// Return fraction of the time spent between dequeuing calls, zero before the second call
+            [[nodiscard]] double utilization() const noexcept {
+                const uint64_t total = blocked + busy;
+                return total == 0 ? 0.0 : static_cast<double>(busy) / static_cast<double>(total);
+            }
+        };
+
+        std::array<uint64_t, MetricsCell::OPS> submitted{};
+        std::array<uint64_t, MetricsCell::OPS> rejected{};
+        std::array<uint64_t, MetricsCell::OPS> completed{};
+        std::array<uint64_t, MetricsCell::OPS> failed{};
+        std::array<uint64_t, MetricsCell::BATCH_BUCKETS> batches{};
+        uint64_t statuses = 0;
+        uint64_t timeouts = 0;
+        uint64_t dequeue_errors = 0;
+        uint64_t posts = 0;
+        uint64_t post_errors = 0;
+        std::vector<Worker> workers{};  ///< Threads, which have dequeued at least once
+
+        /// Add the counters of a cell to this snapshot
+        ///
+        /// \param cell Counters of a single thread
+        /// \param id Index of the thread
+        /// \param name Name of the thread
+        void merge(const MetricsCell& cell, std::size_t id, const std::string& name) {
+            const auto load = [](const std::atomic<uint64_t>& counter) {
+                return counter.load(std::memory_order_relaxed);
+            };
+            for (std::size_t op = 0; op < MetricsCell::OPS; ++op) {
+                submitted[op] += load(cell.submitted[op]);
+                rejected[op] += load(cell.rejected[op]);
+                completed[op] += load(cell.completed[op]);
+                failed[op] += load(cell.failed[op]);
+            }
+            uint64_t calls = 0;
+            for (std::size_t i = 0; i < MetricsCell::BATCH_BUCKETS; ++i) {
+                batches[i] += load(cell.batches[i]);
+                calls += load(cell.batches[i]);
+            }
+            statuses += load(cell.statuses);
+            timeouts += load(cell.timeouts);
+            dequeue_errors += load(cell.dequeue_errors);
+            posts += load(cell.posts);
+            post_errors += load(cell.post_errors);
+            if (calls + load(cell.timeouts) + load(cell.dequeue_errors) != 0) {
+                workers.push_back(Worker{id, name, load(cell.blocked), load(cell.busy)});
+            }
+        }
+
+        /// Return number of operations of the provided type in flight
+        ///
+        /// \details Counters are read one thread after the other, so that an operation completing while the snapshot
+        /// is taken may be counted as completed but not as submitted. The result is clamped to zero in that case.
+        ///
+        /// \param op Index of the operation type, see `instrument::Op`
+        [[nodiscard]] uint64_t in_flight(std::size_t op) const noexcept {
+            const uint64_t done = rejected[op] + completed[op];
+            return submitted[op] > done ? submitted[op] - done : 0;
+        }
+
+        /// Return number of successful dequeuing calls
+        [[nodiscard]] uint64_t dequeues() const noexcept {
+            uint64_t total = 0;
+            for (const uint64_t count : batches) {
+                total += count;
+            }
+            return total;
+        }
+
+    }; // struct Metrics
+
+} // namespace laio::iocp
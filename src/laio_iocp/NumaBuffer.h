@@ -0,0 +1,136 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "hicpp-move-const-arg"
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <memoryapi.h>
+#include <processthreadsapi.h>
+
+#include <cstdint>
+#include <variant>
+
+#include "gsl/span"
+#include "Result.h"
+
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint8_t;
+
+    namespace iocp {
+
+        /// Committed memory placed on a preferred NUMA node
+        ///
+        /// \details The pages are committed up front through `VirtualAllocExNuma`, so that they are backed by memory
+        /// of the preferred node, if available, as soon as they are first touched. Allocations are page-granular and
+        /// therefore aligned to any sector size as well. Enforces ownership semantics.
+        class NumaBuffer {
+
+            uint8_t* data_ = nullptr;   ///< Start of the committed region
+            std::size_t size_ = 0;      ///< Length of the committed region in bytes
+            unsigned long node_ = 0;    ///< Preferred NUMA node
+
+            NumaBuffer(uint8_t* data, std::size_t size, unsigned long node) noexcept
+                : data_{data}, size_{size}, node_{node} {}
+
+        public:
+            // # Constructors
+            constexpr NumaBuffer() noexcept = default;
+
+            NumaBuffer(const NumaBuffer& other) = delete;
+
+            NumaBuffer(NumaBuffer&& other) noexcept
+                : data_{other.data_}, size_{other.size_}, node_{other.node_}
+            {
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+
+            // # Destructor
+            ~NumaBuffer() noexcept {
+                if (data_ != nullptr) VirtualFree(data_, 0, MEM_RELEASE);
+            }
+
+            // # Operator overloads
+            NumaBuffer& operator=(const NumaBuffer& rhs) = delete;
+
+            NumaBuffer& operator=(NumaBuffer&& rhs) noexcept {
+                if (this != &rhs) {
+                    if (data_ != nullptr) VirtualFree(data_, 0, MEM_RELEASE);
+                    data_ = rhs.data_;
+                    size_ = rhs.size_;
+                    node_ = rhs.node_;
+                    rhs.data_ = nullptr;
+                    rhs.size_ = 0;
+                }
+                return *this;
+            }
+
+            // # Public member functions
+
+            /// Commit zeroed memory on the preferred NUMA node
+            ///
+            /// \param size Minimum number of bytes, rounded up to whole pages by the system
+            /// \param node Preferred NUMA node
+            /// \return Variant with NumaBuffer if successful, error type otherwise
+            static Result<NumaBuffer> allocate(std::size_t size, unsigned long node) noexcept {
+                if (size == 0) {
+                    return Error{static_cast<wse::win_errc>(ERROR_INVALID_PARAMETER)};
+                }
+                void* ret = VirtualAllocExNuma(
+                        GetCurrentProcess(),
+                        nullptr,
+                        size,
+                        MEM_RESERVE | MEM_COMMIT,
+                        PAGE_READWRITE,
+                        node
+                );
+                if (ret == nullptr) {
+                    return Error{};
+                }
+                return NumaBuffer{static_cast<uint8_t*>(ret), size, node};
+            }
+
+            /// Return mutable view over the whole buffer
+            gsl::span<uint8_t> as_mut_span() noexcept {
+                return gsl::span<uint8_t>{data_, size_};
+            }
+
+            /// Return view over the whole buffer
+            [[nodiscard]] gsl::span<const uint8_t> as_span() const noexcept {
+                return gsl::span<const uint8_t>{data_, size_};
+            }
+
+            /// Return pointer to the start of the buffer
+            uint8_t* data() noexcept {
+                return data_;
+            }
+
+            /// Return length of the buffer in bytes
+            [[nodiscard]] std::size_t size() const noexcept {
+                return size_;
+            }
+
+            /// Return NUMA node the buffer has been requested on
+            [[nodiscard]] unsigned long node() const noexcept {
+                return node_;
+            }
+
+        }; // class NumaBuffer
+
+    } // namespace iocp
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<iocp::NumaBuffer> = true;
+
+        template<>
+        constexpr bool is_sync<iocp::NumaBuffer> = true;
+
+    } // namespace trait
+
+} // namespace laio
+#pragma clang diagnostic pop
@@ -9,17 +9,25 @@
 #include <cstdint>
 #include <variant>
 
-#include "win_error.h"
+#include "Result.h"
 
 #include "traits.h"
 
+// Per-operation latency histograms, tracing and metrics, see `Instrument.h`
+#if !defined(LAIO_INSTRUMENT)
+    #define LAIO_INSTRUMENT 0
+#endif
+#if !defined(LAIO_TRACE)
+    #define LAIO_TRACE 0
+#endif
+#if !defined(LAIO_METRICS)
+    #define LAIO_METRICS 0
+#endif
+
 namespace laio {
 
     using std::uint64_t;
 
-    template<typename T>
-    using Result = std::variant<T, wse::win_error>;
-
     namespace iocp {
 
         /// Overlapped structure required for Windows Overlapped I/O
@@ -58,7 +66,7 @@ namespace laio {
                         nullptr
                 );
                 if (event == nullptr) {
-                    return wse::win_error{};
+                    return Error{};
                 }
                 Overlapped overlapped{};
                 overlapped.set_event(event);
@@ -111,6 +119,8 @@ namespace laio {
 
         }; // class Overlapped
 
+        static_assert(sizeof(Overlapped) == sizeof(OVERLAPPED));
+
     } // namespace iocp
 
     namespace trait {
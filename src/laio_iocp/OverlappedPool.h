@@ -0,0 +1,153 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "hicpp-move-const-arg"
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <variant>
+
+#include "Result.h"
+
+#include "NumaBuffer.h"
+#include "Overlapped.h"
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint32_t;
+
+    namespace iocp {
+
+        /// Fixed-size pool of overlapped structures placed on one NUMA node
+        ///
+        /// \details The structures and the free list live in a single `NumaBuffer`, so that a worker pinned to a core
+        /// of that node never touches remote memory when it submits or completes a request. The pool is meant to be
+        /// owned by exactly one worker and is therefore not synchronized. Structures are handed out zeroed and
+        /// recycled in LIFO order, which keeps recently used cache lines warm.
+        class OverlappedPool {
+
+            static_assert(std::is_trivially_destructible_v<Overlapped>);
+
+            NumaBuffer memory_;                 ///< Backing memory of structures and free list
+            Overlapped* slots_ = nullptr;       ///< Start of the structures
+            uint32_t* free_ = nullptr;          ///< Stack of indices of available structures
+            uint32_t capacity_ = 0;             ///< Number of structures in the pool
+            uint32_t available_ = 0;            ///< Number of indices on the free stack
+
+            OverlappedPool(NumaBuffer memory, uint32_t capacity) noexcept
+                : memory_{std::move(memory)}, capacity_{capacity}, available_{capacity}
+            {
+                slots_ = reinterpret_cast<Overlapped*>(memory_.data());
+                free_ = reinterpret_cast<uint32_t*>(memory_.data() + capacity * sizeof(Overlapped));
+                for (uint32_t i = 0; i < capacity; ++i) {
+                    new (slots_ + i) Overlapped{};
+                    free_[i] = capacity - 1 - i;
+                }
+            }
+
+        public:
+            // # Constructors
+            OverlappedPool(const OverlappedPool& other) = delete;
+
+            OverlappedPool(OverlappedPool&& other) noexcept
+                : memory_{std::move(other.memory_)}, slots_{other.slots_}, free_{other.free_},
+                  capacity_{other.capacity_}, available_{other.available_}
+            {
+                other.slots_ = nullptr;
+                other.free_ = nullptr;
+                other.capacity_ = 0;
+                other.available_ = 0;
+            }
+
+            // # Operator overloads
+            OverlappedPool& operator=(const OverlappedPool& rhs) = delete;
+
+            OverlappedPool& operator=(OverlappedPool&& rhs) noexcept {
+                if (this != &rhs) {
+                    memory_ = std::move(rhs.memory_);
+                    slots_ = rhs.slots_;
+                    free_ = rhs.free_;
+                    capacity_ = rhs.capacity_;
+                    available_ = rhs.available_;
+                    rhs.slots_ = nullptr;
+                    rhs.free_ = nullptr;
+                    rhs.capacity_ = 0;
+                    rhs.available_ = 0;
+                }
+                return *this;
+            }
+
+            // # Public member functions
+
+            /// Create new pool on the specified NUMA node
+            ///
+            /// \param capacity Number of overlapped structures
+            /// \param node Preferred NUMA node
+            /// \return Variant with OverlappedPool if successful, error type otherwise
+            static Result<OverlappedPool> create(uint32_t capacity, unsigned long node) noexcept {
+                Result<NumaBuffer> memory = NumaBuffer::allocate(
+                        static_cast<std::size_t>(capacity) * (sizeof(Overlapped) + sizeof(uint32_t)), node);
+                if (std::holds_alternative<Error>(memory)) {
+                    return std::get<Error>(memory);
+                }
+                return OverlappedPool{std::move(std::get<NumaBuffer>(memory)), capacity};
+            }
+
+            /// Take zeroed overlapped structure from the pool
+            ///
+            /// \return Pointer to overlapped structure, `nullptr` if the pool is exhausted
+            Overlapped* acquire() noexcept {
+                if (available_ == 0) {
+                    return nullptr;
+                }
+                Overlapped* overlapped = slots_ + free_[--available_];
+                *overlapped = Overlapped{};
+                return overlapped;
+            }
+
+            /// Return overlapped structure to the pool once its request has completed
+            ///
+            /// \param overlapped Structure previously taken from this pool
+            void release(Overlapped* overlapped) noexcept {
+                free_[available_++] = static_cast<uint32_t>(overlapped - slots_);
+            }
+
+            /// Return `true` if the structure has been taken from this pool
+            ///
+            /// \details Allows mapping the raw `OVERLAPPED` pointer of a completion status back to its pool.
+            [[nodiscard]] bool owns(const OVERLAPPED* overlapped) const noexcept {
+                const auto* raw = reinterpret_cast<const Overlapped*>(overlapped);
+                return raw >= slots_ && raw < slots_ + capacity_;
+            }
+
+            /// Return number of structures in the pool
+            [[nodiscard]] uint32_t capacity() const noexcept {
+                return capacity_;
+            }
+
+            /// Return number of structures currently available
+            [[nodiscard]] uint32_t available() const noexcept {
+                return available_;
+            }
+
+            /// Return NUMA node the pool has been placed on
+            [[nodiscard]] unsigned long node() const noexcept {
+                return memory_.node();
+            }
+
+        }; // class OverlappedPool
+
+    } // namespace iocp
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<iocp::OverlappedPool> = true;
+
+    } // namespace trait
+
+} // namespace laio
+#pragma clang diagnostic pop
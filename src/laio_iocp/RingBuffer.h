@@ -0,0 +1,268 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "hicpp-move-const-arg"
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <handleapi.h>
+#include <libloaderapi.h>
+#include <memoryapi.h>
+#include <sysinfoapi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <variant>
+
+#include "gsl/span"
+#include "Result.h"
+
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint8_t;
+
+    namespace iocp {
+
+        namespace detail {
+
+            /// Signature of `VirtualAlloc2`, without extended parameters
+            using VirtualAlloc2Fn = PVOID (WINAPI*)(HANDLE, PVOID, SIZE_T, ULONG, ULONG, void*, ULONG);
+
+            /// Signature of `MapViewOfFile3`, without extended parameters
+            using MapViewOfFile3Fn = PVOID (WINAPI*)(HANDLE, HANDLE, PVOID, ULONG64, SIZE_T, ULONG, ULONG, void*, ULONG);
+
+            /// Placeholder functions of the memory manager, which are looked up once
+            ///
+            /// \details Both are available from Windows 10 version 1803 and Windows Server 2019 onwards. They are
+            /// resolved at runtime, so that older systems fail to create a ring buffer instead of failing to load.
+            struct Placeholders {
+                VirtualAlloc2Fn virtual_alloc2 = nullptr;
+                MapViewOfFile3Fn map_view_of_file3 = nullptr;
+
+                static const Placeholders& get() noexcept {
+                    static const Placeholders functions = [] {
+                        Placeholders resolved{};
+                        HMODULE module = GetModuleHandleW(L"kernelbase.dll");
+                        if (module != nullptr) {
+                            resolved.virtual_alloc2 = reinterpret_cast<VirtualAlloc2Fn>(
+                                    reinterpret_cast<void*>(GetProcAddress(module, "VirtualAlloc2")));
+                            resolved.map_view_of_file3 = reinterpret_cast<MapViewOfFile3Fn>(
+                                    reinterpret_cast<void*>(GetProcAddress(module, "MapViewOfFile3")));
+                        }
+                        return resolved;
+                    }();
+                    return functions;
+                }
+            };
+
+        } // namespace detail
+
+        /// Receive buffer of a stream, whose readable and free regions are always contiguous
+        ///
+        /// \details The same pages are mapped twice back to back, so that bytes written past the end of the first
+        /// mapping appear at its start and vice versa. Neither the bytes received so far nor the space left ever wrap
+        /// around: `writable` is passed as is to `TcpStream::read_overlapped`, `commit` accounts for the bytes it has
+        /// received, and a parser sees every partial frame in one piece through `readable` until it `consume`s it.
+        /// The capacity is a multiple of the allocation granularity, 64 KiB on all current systems. Enforces ownership
+        /// semantics.
+        class RingBuffer {
+
+            uint8_t* data_ = nullptr;       ///< Start of the first of both mappings
+            std::size_t capacity_ = 0;      ///< Length of a single mapping in bytes
+            std::size_t read_ = 0;          ///< Offset of the first readable byte, less than the capacity
+            std::size_t len_ = 0;           ///< Number of readable bytes
+
+            RingBuffer(uint8_t* data, std::size_t capacity) noexcept
+                : data_{data}, capacity_{capacity} {}
+
+            /// Unmap both views of a ring buffer
+            static void unmap_(uint8_t* data, std::size_t capacity) noexcept {
+                UnmapViewOfFile(data);
+                UnmapViewOfFile(data + capacity);
+            }
+
+        public:
+            // # Constructors
+            constexpr RingBuffer() noexcept = default;
+
+            RingBuffer(const RingBuffer& other) = delete;
+
+            RingBuffer(RingBuffer&& other) noexcept
+                : data_{other.data_}, capacity_{other.capacity_}, read_{other.read_}, len_{other.len_}
+            {
+                other.data_ = nullptr;
+                other.capacity_ = 0;
+                other.read_ = 0;
+                other.len_ = 0;
+            }
+
+            // # Destructor
+            ~RingBuffer() noexcept {
+                if (data_ != nullptr) unmap_(data_, capacity_);
+            }
+
+            // # Operator overloads
+            RingBuffer& operator=(const RingBuffer& rhs) = delete;
+
+            RingBuffer& operator=(RingBuffer&& rhs) noexcept {
+                if (this != &rhs) {
+                    if (data_ != nullptr) unmap_(data_, capacity_);
+                    data_ = rhs.data_;
+                    capacity_ = rhs.capacity_;
+                    read_ = rhs.read_;
+                    len_ = rhs.len_;
+                    rhs.data_ = nullptr;
+                    rhs.capacity_ = 0;
+                    rhs.read_ = 0;
+                    rhs.len_ = 0;
+                }
+                return *this;
+            }
+
+            // # Public member functions
+
+            /// Map an empty ring buffer
+            ///
+            /// \details Backs the buffer with a pagefile-backed section, which is mapped into both halves of a
+            /// placeholder reservation. Fails with `ERROR_CALL_NOT_IMPLEMENTED` on systems without placeholder
+            /// support.
+            ///
+            /// \param capacity Minimum number of bytes, rounded up to the allocation granularity
+            /// \return Variant with RingBuffer if successful, error type otherwise
+            static Result<RingBuffer> create(std::size_t capacity) noexcept {
+                const detail::Placeholders& placeholders = detail::Placeholders::get();
+                if (placeholders.virtual_alloc2 == nullptr || placeholders.map_view_of_file3 == nullptr) {
+                    return Error{static_cast<wse::win_errc>(ERROR_CALL_NOT_IMPLEMENTED)};
+                }
+                if (capacity == 0) {
+                    return Error{static_cast<wse::win_errc>(ERROR_INVALID_PARAMETER)};
+                }
+                SYSTEM_INFO info{};
+                GetSystemInfo(&info);
+                const std::size_t granularity = info.dwAllocationGranularity;
+                capacity = (capacity + granularity - 1) / granularity * granularity;
+
+                const auto size = static_cast<ULONG64>(capacity);
+                HANDLE section = CreateFileMappingW(
+                        INVALID_HANDLE_VALUE,
+                        nullptr,
+                        PAGE_READWRITE,
+                        static_cast<DWORD>(size >> 32u),
+                        static_cast<DWORD>(size & 0xFFFF'FFFFu),
+                        nullptr
+                );
+                if (section == nullptr) {
+                    return Error{};
+                }
+
+                // Reserve both halves at once, then split the reservation into one placeholder per mapping
+                auto* data = static_cast<uint8_t*>(placeholders.virtual_alloc2(
+                        nullptr,
+                        nullptr,
+                        2 * capacity,
+                        MEM_RESERVE | MEM_RESERVE_PLACEHOLDER,
+                        PAGE_NOACCESS,
+                        nullptr,
+                        0
+                ));
+                if (data == nullptr) {
+                    const Error error{};
+                    CloseHandle(section);
+                    return error;
+                }
+                if (VirtualFree(data, capacity, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER) == 0) {
+                    const Error error{};
+                    VirtualFree(data, 0, MEM_RELEASE);
+                    CloseHandle(section);
+                    return error;
+                }
+
+                void* first = placeholders.map_view_of_file3(
+                        section, nullptr, data, 0, capacity, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+                if (first == nullptr) {
+                    const Error error{};
+                    VirtualFree(data, 0, MEM_RELEASE);
+                    VirtualFree(data + capacity, 0, MEM_RELEASE);
+                    CloseHandle(section);
+                    return error;
+                }
+                void* second = placeholders.map_view_of_file3(
+                        section, nullptr, data + capacity, 0, capacity, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE,
+                        nullptr, 0);
+                if (second == nullptr) {
+                    const Error error{};
+                    UnmapViewOfFile(first);
+                    VirtualFree(data + capacity, 0, MEM_RELEASE);
+                    CloseHandle(section);
+                    return error;
+                }
+
+                // Views keep the section alive
+                CloseHandle(section);
+                return RingBuffer{data, capacity};
+            }
+
+            /// Return contiguous view over all readable bytes
+            [[nodiscard]] gsl::span<const uint8_t> readable() const noexcept {
+                return gsl::span<const uint8_t>{data_ + read_, len_};
+            }
+
+            /// Return contiguous view over all free space, e.g. to receive into
+            ///
+            /// \details The view must stay alive and in place until the receive has completed, and neither `commit`
+            /// nor `consume` must be called while it is pending.
+            gsl::span<uint8_t> writable() noexcept {
+                return gsl::span<uint8_t>{data_ + read_ + len_, capacity_ - len_};
+            }
+
+            /// Mark bytes written to the start of `writable` as readable
+            ///
+            /// \param n Number of bytes written, clamped to the free space
+            void commit(std::size_t n) noexcept {
+                len_ += (std::min)(n, capacity_ - len_);
+            }
+
+            /// Release bytes at the start of `readable` as free space
+            ///
+            /// \param n Number of bytes processed, clamped to the readable bytes
+            void consume(std::size_t n) noexcept {
+                n = (std::min)(n, len_);
+                len_ -= n;
+                read_ += n;
+                if (read_ >= capacity_) read_ -= capacity_;
+                // Realign an empty buffer, so that the next receive does not straddle both mappings needlessly
+                if (len_ == 0) read_ = 0;
+            }
+
+            /// Return number of readable bytes
+            [[nodiscard]] std::size_t size() const noexcept {
+                return len_;
+            }
+
+            /// Return length of a single mapping in bytes
+            [[nodiscard]] std::size_t capacity() const noexcept {
+                return capacity_;
+            }
+
+            [[nodiscard]] bool empty() const noexcept {
+                return len_ == 0;
+            }
+
+            [[nodiscard]] bool full() const noexcept {
+                return len_ == capacity_;
+            }
+
+        }; // class RingBuffer
+
+    } // namespace iocp
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<iocp::RingBuffer> = true;
+
+    } // namespace trait
+
+} // namespace laio
+#pragma clang diagnostic pop
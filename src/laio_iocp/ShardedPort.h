@@ -0,0 +1,307 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "hicpp-move-const-arg"
+#pragma once
+
+#include <WinIncludes.h>
+
+#include <processthreadsapi.h>
+#include <systemtopologyapi.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "Result.h"
+
+#include "CompletionPort.h"
+#include "NumaBuffer.h"
+#include "OverlappedPool.h"
+#include "traits.h"
+
+namespace laio {
+
+    using std::uint32_t;
+
+    namespace iocp {
+
+        /// Completion port dedicated to a single processor
+        ///
+        /// \details Each shard is created with a concurrency value of 1 and is meant to be drained by exactly one
+        /// worker thread pinned to the shard's processor. Memory for requests submitted through the shard should be
+        /// taken from the shard's NUMA node.
+        class Shard {
+
+            CompletionPort port_;           ///< Completion port of this shard
+            PROCESSOR_NUMBER processor_;    ///< Processor the worker of this shard is pinned to
+            unsigned short node_;           ///< NUMA node of the processor
+
+        public:
+            // # Constructors
+            Shard(CompletionPort port, PROCESSOR_NUMBER processor, unsigned short node) noexcept
+                : port_{std::move(port)}, processor_{processor}, node_{node} {}
+
+            Shard(const Shard& other) = delete;
+
+            Shard(Shard&& other) noexcept = default;
+
+            // # Operator overloads
+            Shard& operator=(const Shard& rhs) = delete;
+
+            Shard& operator=(Shard&& rhs) noexcept = default;
+
+            // # Public member functions
+
+            /// Borrow completion port of this shard
+            CompletionPort& port() noexcept {
+                return port_;
+            }
+
+            /// Return processor the worker of this shard is pinned to
+            [[nodiscard]] PROCESSOR_NUMBER processor() const noexcept {
+                return processor_;
+            }
+
+            /// Return NUMA node of the processor of this shard
+            [[nodiscard]] unsigned short numa_node() const noexcept {
+                return node_;
+            }
+
+            /// Pin the calling thread to the processor of this shard
+            ///
+            /// \details Restricts the thread's group affinity to the single processor and sets it as the ideal
+            /// processor, so that the scheduler never migrates the worker away from its completion port.
+            ///
+            /// \return Variant with error type, in case the affinity cannot be changed
+            Result<std::monostate> pin_current_thread() const noexcept {
+                GROUP_AFFINITY affinity{};
+                affinity.Group = processor_.Group;
+                affinity.Mask = static_cast<KAFFINITY>(1) << processor_.Number;
+                if (SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) == 0) {
+                    return Error{};
+                }
+                PROCESSOR_NUMBER ideal = processor_;
+                if (SetThreadIdealProcessorEx(GetCurrentThread(), &ideal, nullptr) == 0) {
+                    return Error{};
+                }
+                return std::monostate{};
+            }
+
+            /// Commit zeroed memory on the NUMA node of this shard
+            ///
+            /// \param size Minimum number of bytes
+            /// \return Variant with NumaBuffer if successful, error type otherwise
+            [[nodiscard]] Result<NumaBuffer> allocate(std::size_t size) const noexcept {
+                return NumaBuffer::allocate(size, node_);
+            }
+
+            /// Create pool of overlapped structures on the NUMA node of this shard
+            ///
+            /// \param capacity Number of overlapped structures
+            /// \return Variant with OverlappedPool if successful, error type otherwise
+            [[nodiscard]] Result<OverlappedPool> overlapped_pool(uint32_t capacity) const noexcept {
+                return OverlappedPool::create(capacity, node_);
+            }
+
+        }; // class Shard
+
+        // Requires declaration for the signature of the shard policy
+        class ShardedPort;
+
+        /// Policy selecting the shard a new handle is associated with
+        ///
+        /// \details Invoked with the raw handle (or socket) and the sharded port, and returns the index of a shard.
+        /// Indices out of range are wrapped around.
+        using ShardPolicy = std::function<std::size_t(std::uintptr_t, const ShardedPort&)>;
+
+        namespace policy {
+
+            /// Assign handles to shards in turn
+            inline ShardPolicy round_robin() {
+                auto next = std::make_shared<std::atomic_size_t>(0);
+                return [next](std::uintptr_t, const ShardedPort&) {
+                    return next->fetch_add(1, std::memory_order_relaxed);
+                };
+            }
+
+            /// Assign handles to shards by a hash of the raw handle value
+            ///
+            /// \details Handle values are multiples of 4, so the low bits are mixed in before the shard is selected.
+            inline ShardPolicy hashed() {
+                return [](std::uintptr_t handle, const ShardedPort&) {
+                    std::uint64_t x = static_cast<std::uint64_t>(handle);
+                    x ^= x >> 33u;
+                    x *= 0xff51afd7ed558ccdull;
+                    x ^= x >> 33u;
+                    return static_cast<std::size_t>(x);
+                };
+            }
+
+            /// Assign handles to the shard of the processor the calling thread runs on
+            ///
+            /// \details Suited for connections accepted by a pinned worker, which then stay on the worker's core.
+            inline ShardPolicy local();
+
+        } // namespace policy
+
+        /// Set of completion ports with one shard per processor
+        ///
+        /// \details Thread-per-core counterpart of a single shared `CompletionPort`: every shard is pinned to one
+        /// processor and new handles are spread across the shards by a pluggable `ShardPolicy`. As a handle can only
+        /// ever be associated with a single completion port, all requests on the handle complete on its shard.
+        class ShardedPort {
+
+            std::vector<Shard> shards_;
+            ShardPolicy policy_;
+
+            ShardedPort(std::vector<Shard> shards, ShardPolicy policy) noexcept
+                : shards_{std::move(shards)}, policy_{std::move(policy)} {}
+
+        public:
+            // # Constructors
+            ShardedPort(const ShardedPort& other) = delete;
+
+            ShardedPort(ShardedPort&& other) noexcept = default;
+
+            // # Operator overloads
+            ShardedPort& operator=(const ShardedPort& rhs) = delete;
+
+            ShardedPort& operator=(ShardedPort&& rhs) noexcept = default;
+
+            // # Public member functions
+
+            /// Create one shard per active processor of the system
+            ///
+            /// \details Shards are ordered by processor group and number. If a number of shards is requested, only the
+            /// first processors are used, or processors are used repeatedly if there are more shards than processors.
+            ///
+            /// \param shards Number of shards, 0 for one per active processor
+            /// \param policy Policy assigning new handles to shards
+            /// \return Variant with ShardedPort if successful, error type otherwise
+            static Result<ShardedPort> create(std::size_t shards = 0, ShardPolicy policy = policy::round_robin()) {
+                std::vector<PROCESSOR_NUMBER> processors{};
+                const WORD groups = GetActiveProcessorGroupCount();
+                for (WORD group = 0; group < groups; ++group) {
+                    const DWORD count = GetActiveProcessorCount(group);
+                    for (DWORD number = 0; number < count; ++number) {
+                        processors.push_back(PROCESSOR_NUMBER{group, static_cast<BYTE>(number), 0});
+                    }
+                }
+                if (processors.empty()) {
+                    return Error{static_cast<wse::win_errc>(ERROR_NOT_FOUND)};
+                }
+                if (shards == 0) {
+                    shards = processors.size();
+                }
+
+                std::vector<Shard> list{};
+                list.reserve(shards);
+                for (std::size_t i = 0; i < shards; ++i) {
+                    PROCESSOR_NUMBER processor = processors[i % processors.size()];
+                    USHORT node = 0;
+                    if (GetNumaProcessorNodeEx(&processor, &node) == 0) {
+                        return Error{};
+                    }
+                    Result<CompletionPort> port = CompletionPort::create(1);
+                    if (std::holds_alternative<Error>(port)) {
+                        return std::get<Error>(port);
+                    }
+                    list.emplace_back(std::move(std::get<CompletionPort>(port)), processor, node);
+                }
+                return ShardedPort{std::move(list), std::move(policy)};
+            }
+
+            /// Return number of shards
+            [[nodiscard]] std::size_t size() const noexcept {
+                return shards_.size();
+            }
+
+            /// Borrow shard at the specified index
+            Shard& shard(std::size_t index) noexcept {
+                return shards_[index];
+            }
+
+            /// Borrow shard at the specified index
+            [[nodiscard]] const Shard& shard(std::size_t index) const noexcept {
+                return shards_[index];
+            }
+
+            /// Return index of the first shard pinned to the processor the calling thread runs on
+            ///
+            /// \return Index of the shard, or `std::nullopt` if no shard is pinned to the current processor
+            [[nodiscard]] std::optional<std::size_t> current() const noexcept {
+                PROCESSOR_NUMBER processor{};
+                GetCurrentProcessorNumberEx(&processor);
+                for (std::size_t i = 0; i < shards_.size(); ++i) {
+                    const PROCESSOR_NUMBER other = shards_[i].processor();
+                    if (other.Group == processor.Group && other.Number == processor.Number) {
+                        return i;
+                    }
+                }
+                return std::nullopt;
+            }
+
+            /// Associate a windows I/O handle to the shard selected by the policy
+            ///
+            /// \param token Unique token
+            /// \param t Type which implements the `as_raw_handle` trait
+            /// \return Variant with index of the selected shard, error type in case the association failed
+            template<typename T, typename = std::enable_if_t<trait::as_raw_handle<T>>>
+            Result<std::size_t> add_handle(const std::size_t token, const T& t) {
+                const std::size_t index = select_(reinterpret_cast<std::uintptr_t>(t.as_raw_handle()));
+                Result<std::monostate> ret = shards_[index].port().add_handle(token, t);
+                if (std::holds_alternative<Error>(ret)) {
+                    return std::get<Error>(ret);
+                }
+                return index;
+            }
+
+            /// Associate a windows socket to the shard selected by the policy
+            ///
+            /// \param token Unique token
+            /// \param t Type which implements the `as_raw_socket` trait
+            /// \return Variant with index of the selected shard, error type in case the association failed
+            template<typename T, typename = std::enable_if_t<trait::as_raw_socket<T>>>
+            Result<std::size_t> add_socket(const std::size_t token, const T& t) {
+                const std::size_t index = select_(static_cast<std::uintptr_t>(t.as_raw_socket()));
+                Result<std::monostate> ret = shards_[index].port().add_socket(token, t);
+                if (std::holds_alternative<Error>(ret)) {
+                    return std::get<Error>(ret);
+                }
+                return index;
+            }
+
+        private:
+            /// Ask the policy for a shard and wrap the index around
+            std::size_t select_(std::uintptr_t raw) const {
+                return policy_(raw, *this) % shards_.size();
+            }
+
+        }; // class ShardedPort
+
+        inline ShardPolicy policy::local() {
+            return [](std::uintptr_t, const ShardedPort& ports) {
+                return ports.current().value_or(0);
+            };
+        }
+
+    } // namespace iocp
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<iocp::Shard> = true;
+
+        template<>
+        constexpr bool is_sync<iocp::Shard> = true;
+
+        template<>
+        constexpr bool is_send<iocp::ShardedPort> = true;
+
+    } // namespace trait
+
+} // namespace laio
+#pragma clang diagnostic pop
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace laio::iocp {
+
+    using std::int64_t;
+    using std::uint8_t;
+    using std::uint32_t;
+    using std::uint64_t;
+
+    /// Event in the life of an overlapped operation
+    struct TraceEvent {
+
+        /// Type of an event
+        enum class Kind : uint8_t {
+            Submit,         ///< Operation handed to the system
+            Complete,       ///< Completion status dequeued from a port
+            Dequeue,        ///< Call dequeuing one or more completion statuses, from its start to its return
+            Dispatch,       ///< Handling of a completion status by the application
+        };
+
+        int64_t time;               ///< Steady clock time in nanoseconds, at the start of the event
+        int64_t duration;           ///< Duration in nanoseconds, zero for events without duration
+        std::uintptr_t overlapped;  ///< Address of the raw overlapped structure, zero if there is none
+        std::size_t token;          ///< Completion token, zero if not known yet
+        uint32_t bytes;             ///< Bytes submitted or transferred, or number of statuses dequeued
+        Kind kind;                  ///< Type of the event
+        uint8_t op;                 ///< Type of the operation, see `instrument::Op`
+
+    }; // struct TraceEvent
+
+    /// Ring buffer of the most recent trace events of a single thread
+    ///
+    /// \details The ring has a single writer, which overwrites the oldest events once the ring is full and never
+    /// blocks. Events are stored as relaxed atomic words behind a sequence counter, so that another thread can copy
+    /// the ring at any time and discard the events, which have been overwritten while it was copying.
+    class TraceRing {
+
+        static constexpr std::size_t WORDS = 5;     ///< Words per event
+
+        std::unique_ptr<std::atomic<uint64_t>[]> words_;
+        std::size_t capacity_;
+        std::atomic<uint64_t> started_{0};          ///< Number of events started to be written
+        std::atomic<uint64_t> written_{0};          ///< Number of events completely written
+
+    public:
+        // # Constructors
+
+        /// Create empty ring
+        ///
+        /// \param capacity Number of events retained, must be a power of two
+        explicit TraceRing(std::size_t capacity)
+            : words_{new std::atomic<uint64_t>[capacity * WORDS]}, capacity_{capacity} {}
+
+        // # Public member functions
+
+        /// Return number of events retained
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return capacity_;
+        }
+
+        /// Return number of events written since creation, including overwritten ones
+        [[nodiscard]] uint64_t written() const noexcept {
+            return written_.load(std::memory_order_acquire);
+        }
+
+        /// Append event, overwriting the oldest one if the ring is full
+        ///
+        /// \details Must only be called by the thread owning the ring.
+        void push(const TraceEvent& event) noexcept {
+            const uint64_t index = written_.load(std::memory_order_relaxed);
+            started_.store(index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::atomic<uint64_t>* slot = &words_[(index & (capacity_ - 1)) * WORDS];
+            slot[0].store(static_cast<uint64_t>(event.time), std::memory_order_relaxed);
+            slot[1].store(static_cast<uint64_t>(event.duration), std::memory_order_relaxed);
+            slot[2].store(static_cast<uint64_t>(event.overlapped), std::memory_order_relaxed);
+            slot[3].store(static_cast<uint64_t>(event.token), std::memory_order_relaxed);
+            slot[4].store(static_cast<uint64_t>(event.bytes)
+                          | static_cast<uint64_t>(event.kind) << 32u
+                          | static_cast<uint64_t>(event.op) << 40u, std::memory_order_relaxed);
+            written_.store(index + 1, std::memory_order_release);
+        }
+
+        /// Copy the retained events in the order they were written
+        ///
+        /// \details May be called by any thread, while the owning thread keeps writing.
+        ///
+        /// \return Events, which have not been overwritten
+        [[nodiscard]] std::vector<TraceEvent> events() const {
+            const uint64_t end = written_.load(std::memory_order_acquire);
+            const uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+            std::vector<TraceEvent> events{};
+            events.reserve(static_cast<std::size_t>(end - begin));
+            for (uint64_t index = begin; index < end; ++index) {
+                const std::atomic<uint64_t>* slot = &words_[(index & (capacity_ - 1)) * WORDS];
+                const uint64_t packed = slot[4].load(std::memory_order_relaxed);
+                events.push_back(TraceEvent{
+                        static_cast<int64_t>(slot[0].load(std::memory_order_relaxed)),
+                        static_cast<int64_t>(slot[1].load(std::memory_order_relaxed)),
+                        static_cast<std::uintptr_t>(slot[2].load(std::memory_order_relaxed)),
+                        static_cast<std::size_t>(slot[3].load(std::memory_order_relaxed)),
+                        static_cast<uint32_t>(packed),
+                        static_cast<TraceEvent::Kind>(static_cast<uint8_t>(packed >> 32u)),
+                        static_cast<uint8_t>(packed >> 40u),
+                });
+            }
+
+            // Events in slots the writer has started to reuse meanwhile may be torn
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t started = started_.load(std::memory_order_relaxed);
+            if (started > capacity_ && started - capacity_ > begin) {
+                const auto overwritten = static_cast<std::size_t>((std::min)(started - capacity_, end) - begin);
+                events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(overwritten));
+            }
+            return events;
+        }
+
+    }; // class TraceRing
+
+} // namespace laio::iocp
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "WinIncludes.h"
+
+#include <errhandlingapi.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "win_error.h"
+
+namespace laio {
+
+    /// Error code of a failed call
+    ///
+    /// \details Carries either a Windows system error code, as returned by `GetLastError` and `WSAGetLastError`, or an
+    /// `errno` value of the C runtime, in four bytes. It never allocates, so that expected failures on the hot path,
+    /// e.g. timeouts and incomplete operations, cost neither an allocation nor a string. Windows system error codes
+    /// range from 0 to 15999, which leaves the most significant bit to mark the domain.
+    class Error {
+
+    public:
+        /// Origin of an error code
+        enum class Domain : std::uint8_t {
+            Windows,    ///< Windows system error code
+            Posix,      ///< `errno` value of the C runtime
+        };
+
+    private:
+        static constexpr std::uint32_t POSIX = 1u << 31u;    ///< Marks `errno` values
+
+        std::uint32_t value_;   ///< Error code, with the domain in the most significant bit
+
+        constexpr Error(std::uint32_t code, Domain domain) noexcept
+            : value_{(code & ~POSIX) | (domain == Domain::Posix ? POSIX : 0u)} {}
+
+    public:
+        // # Constructors
+
+        /// Capture the error of the last failed Windows call on the calling thread
+        Error() noexcept
+            : Error{static_cast<std::uint32_t>(GetLastError()), Domain::Windows} {}
+
+        /// Wrap a Windows system error code
+        constexpr explicit Error(wse::win_errc code) noexcept
+            : Error{static_cast<std::uint32_t>(code), Domain::Windows} {}
+
+        // # Operator overloads
+        friend constexpr bool operator==(Error lhs, Error rhs) noexcept {
+            return lhs.value_ == rhs.value_;
+        }
+
+        friend constexpr bool operator!=(Error lhs, Error rhs) noexcept {
+            return lhs.value_ != rhs.value_;
+        }
+
+        friend constexpr bool operator==(Error lhs, wse::win_errc rhs) noexcept {
+            return lhs == Error{rhs};
+        }
+
+        friend constexpr bool operator!=(Error lhs, wse::win_errc rhs) noexcept {
+            return lhs != Error{rhs};
+        }
+
+        friend constexpr bool operator==(wse::win_errc lhs, Error rhs) noexcept {
+            return Error{lhs} == rhs;
+        }
+
+        friend constexpr bool operator!=(wse::win_errc lhs, Error rhs) noexcept {
+            return Error{lhs} != rhs;
+        }
+
+        // # Public member functions
+
+        /// Wrap an `errno` value of the C runtime
+        ///
+        /// \param code Value of `errno`
+        /// \return Error
+        static constexpr Error from_errno(int code) noexcept {
+            return Error{static_cast<std::uint32_t>(code), Domain::Posix};
+        }
+
+        /// Capture the error of the last failed call to the C runtime on the calling thread
+        ///
+        /// \return Error
+        static Error last_errno() noexcept {
+            return from_errno(errno);
+        }
+
+        /// Return origin of the error code
+        [[nodiscard]] constexpr Domain domain() const noexcept {
+            return (value_ & POSIX) != 0 ? Domain::Posix : Domain::Windows;
+        }
+
+        /// Return raw error code within its domain
+        [[nodiscard]] constexpr int code() const noexcept {
+            return static_cast<int>(value_ & ~POSIX);
+        }
+
+        /// Convert into standard error code, e.g. to throw it as `std::system_error`
+        [[nodiscard]] std::error_code error_code() const noexcept {
+            return std::error_code{code(), domain() == Domain::Posix ? std::generic_category() : std::system_category()};
+        }
+
+        /// Return description of the error
+        ///
+        /// \details Unlike all other member functions this allocates, so that it belongs on the cold path only.
+        [[nodiscard]] std::string message() const {
+            return error_code().message();
+        }
+
+    }; // class Error
+
+    static_assert(sizeof(Error) == sizeof(std::uint32_t));
+    static_assert(std::is_trivially_copyable_v<Error>);
+
+    /// Value of a fallible call or the error it has failed with
+    ///
+    /// \details A variant of the value and an `Error`, which is inspected with `std::get`, `std::get_if` and
+    /// `std::holds_alternative` like any other variant, or through the accessors modelled after `std::expected`. It is
+    /// trivially copyable whenever the value is.
+    template<typename T>
+    class Result : public std::variant<T, Error> {
+
+        using Variant = std::variant<T, Error>;
+
+    public:
+        // # Constructors
+        using Variant::Variant;
+
+        // # Operator overloads
+        using Variant::operator=;
+
+        T& operator*() & noexcept {
+            return *std::get_if<0>(this);
+        }
+
+        const T& operator*() const& noexcept {
+            return *std::get_if<0>(this);
+        }
+
+        T&& operator*() && noexcept {
+            return std::move(*std::get_if<0>(this));
+        }
+
+        T* operator->() noexcept {
+            return std::get_if<0>(this);
+        }
+
+        const T* operator->() const noexcept {
+            return std::get_if<0>(this);
+        }
+
+        // # Public member functions
+
+        /// Return whether the call has succeeded
+        [[nodiscard]] constexpr bool has_value() const noexcept {
+            return this->index() == 0;
+        }
+
+        /// Return value of the succeeded call
+        ///
+        /// \details Throws `std::bad_variant_access` if the call has failed.
+        T& value() & {
+            return std::get<0>(*this);
+        }
+
+        const T& value() const& {
+            return std::get<0>(*this);
+        }
+
+        T&& value() && {
+            return std::get<0>(std::move(*this));
+        }
+
+        /// Return error of the failed call, must only be called if the call has failed
+        [[nodiscard]] Error error() const noexcept {
+            return *std::get_if<1>(this);
+        }
+
+    }; // class Result
+
+} // namespace laio
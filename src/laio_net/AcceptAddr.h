@@ -1,12 +1,19 @@
 #pragma once
 
-#include "AcceptAddrBuf.h"
+#include <WinSock2.h>
+
+#include <optional>
+
+#include "SocketAddr.h"
 
 namespace laio::net {
 
     // Requires declaration due to cyclic inclusion of header files, definition can be found in <AcceptAddrBuf.h>
     class AcceptAddrBuf;
 
+    /// Addresses of a connection accepted through `AcceptEx`
+    ///
+    /// \details Borrows the address buffer the connection has been accepted into, which must outlive this object.
     class AcceptAddr {
 
         SOCKADDR* local_socket_address_{};
@@ -28,6 +35,16 @@ namespace laio::net {
             data_{std::move(addressBuffer)}                     // NOLINT(hicpp-move-const-arg,performance-move-const-arg)
         {}
 
+        /// Return local address of the accepted connection
+        [[nodiscard]] std::optional<SocketAddr> local() const noexcept {
+            return SocketAddr::from_raw(local_socket_address_, local_length_);
+        }
+
+        /// Return remote address of the accepted connection
+        [[nodiscard]] std::optional<SocketAddr> remote() const noexcept {
+            return SocketAddr::from_raw(remote_socket_address_, remote_length_);
+        }
+
     };
 
-} // namespace laio::net
\ No newline at end of file
+} // namespace laio::net
@@ -2,22 +2,30 @@
 
 #include <WinSock2.h>
 
+#include <cstdint>
 #include <variant>
 
+#include "Result.h"
+
 #include "AcceptAddr.h"
-#include "TcpListener.h"
 
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
-
     namespace net {
 
+        // Requires declaration due to cyclic inclusion of header files, definition can be found in <TcpListener.h>
+        class TcpListener;
+
+        /// Buffer receiving the addresses of a connection accepted through `AcceptEx`
+        ///
+        /// \details `AcceptEx` requires 16 bytes more than the largest address for each of the two addresses. The
+        /// buffer must stay alive and in place until the accept operation has completed.
         class AcceptAddrBuf {
 
             SOCKADDR_STORAGE local_socket_address_buffer_{};
+            std::uint8_t local_padding_[16]{};
             SOCKADDR_STORAGE remote_socket_address_buffer_{};
+            std::uint8_t remote_padding_[16]{};
 
         public:
 
@@ -27,18 +35,25 @@ namespace laio {
                 return AcceptAddrBuf{};
             }
 
-            Result<AcceptAddr> parse(TcpListener& socket) noexcept {
-                AcceptAddr ret{
-                    nullptr,
-                    0,
-                    nullptr,
-                    0,
-                    this,
-                };
-                return ret;
+            /// Return pointer to the start of the buffer passed to `AcceptEx`
+            void* data() noexcept {
+                return &local_socket_address_buffer_;
             }
+
+            /// Return number of bytes reserved for each of the addresses
+            static constexpr DWORD address_length() noexcept {
+                return static_cast<DWORD>(sizeof(SOCKADDR_STORAGE) + 16);
+            }
+
+            /// Extract addresses from the buffer after the accept operation has completed
+            ///
+            /// \details Implementation of this function is in "TcpListener.h".
+            ///
+            /// \param socket Listener the connection has been accepted on
+            /// \return Variant with addresses of the connection if successful, error type otherwise
+            Result<AcceptAddr> parse(TcpListener& socket) noexcept;
         };
 
     } // namespace net
 
-} // namespace laio
\ No newline at end of file
+} // namespace laio
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gsl/span"
+
+#include "Ipv4Addr.h"
+#include "Ipv6Addr.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define LAIO_CLASSIFY_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define LAIO_CLASSIFY_SSE2 0
+#endif
+
+namespace laio::net {
+
+    using std::uint16_t;
+    using std::uint32_t;
+
+    /// Set of address classes, one bit per class of `addr_class`
+    using AddrClass = uint16_t;
+
+    namespace addr_class {
+
+        constexpr AddrClass UNSPECIFIED = 1u << 0u;                 ///< `is_unspecified`
+        constexpr AddrClass LOOPBACK = 1u << 1u;                    ///< `is_loopback`
+        constexpr AddrClass MULTICAST = 1u << 2u;                   ///< `is_multicast`
+        constexpr AddrClass DOCUMENTATION = 1u << 3u;               ///< `is_documentation`
+        constexpr AddrClass GLOBAL = 1u << 4u;                      ///< `is_global`
+        constexpr AddrClass LINK_LOCAL = 1u << 5u;                  ///< `is_link_local`, `is_unicast_link_local`
+        constexpr AddrClass PRIVATE = 1u << 6u;                     ///< IPv4 `is_private`
+        constexpr AddrClass BROADCAST = 1u << 7u;                   ///< IPv4 `is_broadcast`
+        constexpr AddrClass SHARED = 1u << 8u;                      ///< IPv4 `is_shared`
+        constexpr AddrClass IETF_PROTOCOL_ASSIGNMENT = 1u << 9u;    ///< IPv4 `is_ietf_protocol_assignment`
+        constexpr AddrClass RESERVED = 1u << 10u;                   ///< IPv4 `is_reserved`
+        constexpr AddrClass BENCHMARKING = 1u << 11u;               ///< IPv4 `is_benchmarking`
+        constexpr AddrClass UNIQUE_LOCAL = 1u << 12u;               ///< IPv6 `is_unique_local`
+        constexpr AddrClass SITE_LOCAL = 1u << 13u;                 ///< IPv6 `is_unicast_site_local`
+
+    } // namespace addr_class
+
+    /// Return classes of an IPv4 address
+    ///
+    /// \details Combines the predicates of the address, and is the reference for the batch classifier.
+    constexpr AddrClass classify(const Ipv4Addr& address) noexcept {
+        using namespace addr_class;
+        return static_cast<AddrClass>(
+                  (address.is_unspecified() ? UNSPECIFIED : 0)
+                | (address.is_loopback() ? LOOPBACK : 0)
+                | (address.is_multicast() ? MULTICAST : 0)
+                | (address.is_documentation() ? DOCUMENTATION : 0)
+                | (address.is_global() ? GLOBAL : 0)
+                | (address.is_link_local() ? LINK_LOCAL : 0)
+                | (address.is_private() ? PRIVATE : 0)
+                | (address.is_broadcast() ? BROADCAST : 0)
+                | (address.is_shared() ? SHARED : 0)
+                | (address.is_ietf_protocol_assignment() ? IETF_PROTOCOL_ASSIGNMENT : 0)
+                | (address.is_reserved() ? RESERVED : 0)
+                | (address.is_benchmarking() ? BENCHMARKING : 0));
+    }
+
+    /// Return classes of an IPv6 address
+    ///
+    /// \details Combines the predicates of the address, and is the reference for the batch classifier.
+    constexpr AddrClass classify(const Ipv6Addr& address) noexcept {
+        using namespace addr_class;
+        return static_cast<AddrClass>(
+                  (address.is_unspecified() ? UNSPECIFIED : 0)
+                | (address.is_loopback() ? LOOPBACK : 0)
+                | (address.is_multicast() ? MULTICAST : 0)
+                | (address.is_documentation() ? DOCUMENTATION : 0)
+                | (address.is_global() ? GLOBAL : 0)
+                | (address.is_unicast_link_local() ? LINK_LOCAL : 0)
+                | (address.is_unique_local() ? UNIQUE_LOCAL : 0)
+                | (address.is_unicast_site_local() ? SITE_LOCAL : 0));
+    }
+
+#if LAIO_CLASSIFY_SSE2
+
+    namespace detail {
+
+        /// Return 32 bits in network byte order as loaded into a lane, e.g. the address `a.b.c.d` as `0xddccbbaa`
+        constexpr uint32_t lane_bits(uint32_t bits) noexcept {
+            return bits >> 24u | (bits >> 8u & 0xff'00u) | (bits << 8u & 0xff'00'00u) | bits << 24u;
+        }
+
+        /// Return all-ones lanes where the masked lane equals the prefix, both given in host byte order
+        inline __m128i match_prefix(__m128i lanes, uint32_t mask, uint32_t prefix) noexcept {
+            const __m128i masked = _mm_and_si128(lanes, _mm_set1_epi32(static_cast<int>(lane_bits(mask))));
+            return _mm_cmpeq_epi32(masked, _mm_set1_epi32(static_cast<int>(lane_bits(prefix))));
+        }
+
+        /// Return class in the lanes selected by the condition, zero in the others
+        inline __m128i select_class(__m128i condition, AddrClass addrClass) noexcept {
+            return _mm_and_si128(condition, _mm_set1_epi32(addrClass));
+        }
+
+        /// Narrow the classes of four lanes to 16 bits and store them
+        inline void store_classes(__m128i classes, AddrClass* out) noexcept {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(classes, classes));
+        }
+
+        /// Classify four IPv4 addresses at once
+        ///
+        /// \details Addresses are compared as loaded, i.e. in network byte order, against prefixes and masks
+        /// converted accordingly, so that every range costs one AND and one comparison for all four addresses.
+        inline __m128i classify_ipv4(__m128i v) noexcept {
+            using namespace addr_class;
+            const __m128i ones = _mm_set1_epi32(-1);
+            const __m128i unspecified = match_prefix(v, 0xff'ff'ff'ffu, 0x00'00'00'00u);
+            const __m128i loopback = match_prefix(v, 0xff'00'00'00u, 0x7f'00'00'00u);
+            const __m128i multicast = match_prefix(v, 0xf0'00'00'00u, 0xe0'00'00'00u);
+            const __m128i documentation = _mm_or_si128(_mm_or_si128(
+                    match_prefix(v, 0xff'ff'ff'00u, 0xc0'00'02'00u),
+                    match_prefix(v, 0xff'ff'ff'00u, 0xc6'33'64'00u)),
+                    match_prefix(v, 0xff'ff'ff'00u, 0xcb'00'71'00u));
+            const __m128i linkLocal = match_prefix(v, 0xff'ff'00'00u, 0xa9'fe'00'00u);
+            const __m128i privateUse = _mm_or_si128(_mm_or_si128(
+                    match_prefix(v, 0xff'00'00'00u, 0x0a'00'00'00u),
+                    match_prefix(v, 0xff'f0'00'00u, 0xac'10'00'00u)),
+                    match_prefix(v, 0xff'ff'00'00u, 0xc0'a8'00'00u));
+            const __m128i broadcast = match_prefix(v, 0xff'ff'ff'ffu, 0xff'ff'ff'ffu);
+            const __m128i shared = match_prefix(v, 0xff'c0'00'00u, 0x64'40'00'00u);
+            const __m128i ietf = match_prefix(v, 0xff'ff'ff'00u, 0xc0'00'00'00u);
+            const __m128i future = match_prefix(v, 0xf0'00'00'00u, 0xf0'00'00'00u);
+            const __m128i reserved = _mm_andnot_si128(broadcast, future);
+            const __m128i benchmarking = match_prefix(v, 0xff'fe'00'00u, 0xc6'12'00'00u);
+            const __m128i thisNetwork = match_prefix(v, 0xff'00'00'00u, 0x00'00'00'00u);
+
+            // Only 192.0.0.9 and 192.0.0.10 are globally routable in 192.0.0.0/24
+            const __m128i routable = _mm_or_si128(
+                    match_prefix(v, 0xff'ff'ff'ffu, 0xc0'00'00'09u),
+                    match_prefix(v, 0xff'ff'ff'ffu, 0xc0'00'00'0au));
+            const __m128i excluded = _mm_or_si128(
+                    _mm_or_si128(_mm_or_si128(privateUse, loopback), _mm_or_si128(linkLocal, future)),
+                    _mm_or_si128(_mm_or_si128(documentation, shared), _mm_or_si128(_mm_or_si128(ietf, benchmarking),
+                                                                                    thisNetwork)));
+            const __m128i global = _mm_or_si128(routable, _mm_xor_si128(excluded, ones));
+
+            return _mm_or_si128(
+                    _mm_or_si128(
+                            _mm_or_si128(select_class(unspecified, UNSPECIFIED), select_class(loopback, LOOPBACK)),
+                            _mm_or_si128(select_class(multicast, MULTICAST), select_class(documentation, DOCUMENTATION))),
+                    _mm_or_si128(
+                            _mm_or_si128(
+                                    _mm_or_si128(select_class(global, GLOBAL), select_class(linkLocal, LINK_LOCAL)),
+                                    _mm_or_si128(select_class(privateUse, PRIVATE), select_class(broadcast, BROADCAST))),
+                            _mm_or_si128(
+                                    _mm_or_si128(select_class(shared, SHARED), select_class(ietf, IETF_PROTOCOL_ASSIGNMENT)),
+                                    _mm_or_si128(select_class(reserved, RESERVED), select_class(benchmarking, BENCHMARKING)))));
+        }
+
+        /// Classify four IPv6 addresses at once
+        ///
+        /// \details The addresses are transposed, so that lane `i` of the k-th register holds the k-th 32 bits of
+        /// address `i`. All classes but the unspecified and the loopback address only depend on the first 32 bits.
+        inline __m128i classify_ipv6(__m128i a0, __m128i a1, __m128i a2, __m128i a3) noexcept {
+            using namespace addr_class;
+            const __m128i lo01 = _mm_unpacklo_epi32(a0, a1);
+            const __m128i lo23 = _mm_unpacklo_epi32(a2, a3);
+            const __m128i hi01 = _mm_unpackhi_epi32(a0, a1);
+            const __m128i hi23 = _mm_unpackhi_epi32(a2, a3);
+            const __m128i first = _mm_unpacklo_epi64(lo01, lo23);
+            const __m128i middle = _mm_or_si128(_mm_unpackhi_epi64(lo01, lo23), _mm_unpacklo_epi64(hi01, hi23));
+            const __m128i last = _mm_unpackhi_epi64(hi01, hi23);
+
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i ones = _mm_set1_epi32(-1);
+            const __m128i head = _mm_cmpeq_epi32(_mm_or_si128(first, middle), zero);
+            const __m128i unspecified = _mm_and_si128(head, _mm_cmpeq_epi32(last, zero));
+            const __m128i loopback = _mm_and_si128(head, match_prefix(last, 0xff'ff'ff'ffu, 0x00'00'00'01u));
+            const __m128i multicast = match_prefix(first, 0xff'00'00'00u, 0xff'00'00'00u);
+            const __m128i multicastGlobal = match_prefix(first, 0xff'0f'00'00u, 0xff'0e'00'00u);
+            const __m128i documentation = match_prefix(first, 0xff'ff'ff'ffu, 0x20'01'0d'b8u);
+            const __m128i linkLocal = match_prefix(first, 0xff'c0'00'00u, 0xfe'80'00'00u);
+            const __m128i uniqueLocal = match_prefix(first, 0xfe'00'00'00u, 0xfc'00'00'00u);
+            const __m128i siteLocal = match_prefix(first, 0xff'c0'00'00u, 0xfe'c0'00'00u);
+
+            const __m128i excluded = _mm_or_si128(
+                    _mm_or_si128(_mm_or_si128(multicast, loopback), _mm_or_si128(linkLocal, uniqueLocal)),
+                    _mm_or_si128(unspecified, documentation));
+            const __m128i global = _mm_or_si128(multicastGlobal, _mm_xor_si128(excluded, ones));
+
+            return _mm_or_si128(
+                    _mm_or_si128(
+                            _mm_or_si128(select_class(unspecified, UNSPECIFIED), select_class(loopback, LOOPBACK)),
+                            _mm_or_si128(select_class(multicast, MULTICAST), select_class(documentation, DOCUMENTATION))),
+                    _mm_or_si128(
+                            _mm_or_si128(select_class(global, GLOBAL), select_class(linkLocal, LINK_LOCAL)),
+                            _mm_or_si128(select_class(uniqueLocal, UNIQUE_LOCAL), select_class(siteLocal, SITE_LOCAL))));
+        }
+
+    } // namespace detail
+
+#endif // LAIO_CLASSIFY_SSE2
+
+    /// Classify a batch of IPv4 addresses
+    ///
+    /// \details Equivalent to calling `classify` on every address, but tests four addresses per SSE2 comparison
+    /// against all ranges at once, without branches.
+    ///
+    /// \param addresses Addresses to classify
+    /// \param classes Output of the classes of every address. Must be at least as long as the addresses.
+    inline void classify(gsl::span<const Ipv4Addr> addresses, gsl::span<AddrClass> classes) noexcept {
+        std::size_t i = 0;
+#if LAIO_CLASSIFY_SSE2
+        for (; i + 4 <= addresses.size(); i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(addresses.data() + i));
+            detail::store_classes(detail::classify_ipv4(v), classes.data() + i);
+        }
+#endif
+        for (; i < addresses.size(); ++i) {
+            classes[i] = classify(addresses[i]);
+        }
+    }
+
+    /// Classify a batch of IPv6 addresses
+    ///
+    /// \details Equivalent to calling `classify` on every address, but classifies four addresses at once with SSE2.
+    ///
+    /// \param addresses Addresses to classify
+    /// \param classes Output of the classes of every address. Must be at least as long as the addresses.
+    inline void classify(gsl::span<const Ipv6Addr> addresses, gsl::span<AddrClass> classes) noexcept {
+        std::size_t i = 0;
+#if LAIO_CLASSIFY_SSE2
+        for (; i + 4 <= addresses.size(); i += 4) {
+            const auto* v = reinterpret_cast<const __m128i*>(addresses.data() + i);
+            const __m128i result = detail::classify_ipv6(_mm_loadu_si128(v), _mm_loadu_si128(v + 1),
+                                                         _mm_loadu_si128(v + 2), _mm_loadu_si128(v + 3));
+            detail::store_classes(result, classes.data() + i);
+        }
+#endif
+        for (; i < addresses.size(); ++i) {
+            classes[i] = classify(addresses[i]);
+        }
+    }
+
+} // namespace laio::net
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <WinSock2.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gsl/span"
+
+#include "IpAddr.h"
+#include "Ipv4Addr.h"
+#include "Ipv6Addr.h"
+#include "traits.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace laio {
+
+    using std::uint8_t;
+    using std::uint32_t;
+
+    namespace net {
+
+        namespace detail {
+
+            /// Hint the processor to load the cache line of an entry ahead of its use
+            inline void prefetch(const void* address) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+                _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+                __builtin_prefetch(address);
+#endif
+            }
+
+            /// Multibit trie with leaf pushing over keys of a fixed number of bytes
+            ///
+            /// \details The first level is indexed by the 16 most significant bits of the key and every further level
+            /// by the next byte, i.e. DIR-16-8-8 for IPv4 and DIR-16-8-...-8 for IPv6, so that a lookup takes one
+            /// memory access per level and at most three for IPv4. All levels are stored in a single vector of 32-bit
+            /// entries, where an entry either refers to the chunk of 256 entries of the next level, or holds the value
+            /// of the longest prefix covering it (0 if there is none). Prefixes must be inserted in ascending order of
+            /// their length, which lets every insertion overwrite the entries of its range.
+            template<std::size_t Bytes>
+            class MultibitTrie {
+
+                static_assert(Bytes >= 2);
+
+            public:
+                using Key = std::array<uint8_t, Bytes>;
+
+                static constexpr uint32_t CHILD = 0x80'00'00'00u;     ///< Flag of entries referring to a chunk
+                static constexpr uint32_t ROOT_SIZE = 1u << 16u;      ///< Number of entries on the first level
+                static constexpr uint32_t CHUNK_SIZE = 1u << 8u;      ///< Number of entries on further levels
+                static constexpr std::size_t AHEAD = 16;              ///< Prefetch distance of batch lookups
+
+            private:
+                std::vector<uint32_t> entries_{};
+
+                static uint32_t root_(const Key& key) noexcept {
+                    return static_cast<uint32_t>(key[0]) << 8u | key[1];
+                }
+
+                /// Set `count` entries from `first` on, which are never chunk references in ascending insertion order
+                void fill_(std::size_t first, std::size_t count, uint32_t value) noexcept {
+                    std::fill_n(entries_.begin() + static_cast<std::ptrdiff_t>(first), count, value);
+                }
+
+            public:
+                /// Insert prefix with value
+                ///
+                /// \param key Prefix in network byte order, bits beyond its length must be zero
+                /// \param length Length of the prefix in bits
+                /// \param value Non-zero value with the most significant bit clear
+                void insert(const Key& key, unsigned length, uint32_t value) {
+                    if (entries_.empty()) {
+                        entries_.assign(ROOT_SIZE, 0);
+                    }
+                    if (length <= 16) {
+                        fill_(root_(key), std::size_t{1} << (16 - length), value);
+                        return;
+                    }
+                    std::size_t slot = root_(key);
+                    length -= 16;
+                    for (std::size_t i = 2;; ++i) {
+                        uint32_t entry = entries_[slot];
+                        if (!(entry & CHILD)) {
+                            // Push the value of the shorter prefix down into the new chunk
+                            const auto chunk = static_cast<uint32_t>(entries_.size());
+                            entries_.resize(entries_.size() + CHUNK_SIZE, entry);
+                            entry = CHILD | chunk;
+                            entries_[slot] = entry;
+                        }
+                        const std::size_t chunk = entry & ~CHILD;
+                        if (length <= 8) {
+                            fill_(chunk + key[i], std::size_t{1} << (8 - length), value);
+                            return;
+                        }
+                        slot = chunk + key[i];
+                        length -= 8;
+                    }
+                }
+
+                /// Look up value of the longest prefix matching the key
+                ///
+                /// \return Value of the prefix, 0 if no prefix matches
+                [[nodiscard]] uint32_t find(const Key& key) const noexcept {
+                    if (entries_.empty()) return 0;
+                    uint32_t entry = entries_[root_(key)];
+                    for (std::size_t i = 2; (entry & CHILD) && i < Bytes; ++i) {
+                        entry = entries_[(entry & ~CHILD) + key[i]];
+                    }
+                    return entry;
+                }
+
+                /// Look up values of the longest prefixes matching a batch of keys
+                ///
+                /// \details While a key is looked up, the second-level entry of the key `AHEAD` positions further is
+                /// prefetched. The first level is small enough to stay in cache, so that only the second level, which
+                /// holds most of the entries of a routing table, incurs cache misses, and these overlap.
+                ///
+                /// \param keys Keys to look up
+                /// \param values Output of values, 0 if no prefix matches
+                /// \param count Number of keys
+                void find(const Key* keys, uint32_t* values, std::size_t count) const noexcept {
+                    if (entries_.empty()) {
+                        std::fill_n(values, count, 0u);
+                        return;
+                    }
+                    for (std::size_t i = 0; i < count; ++i) {
+                        if (i + AHEAD < count) {
+                            const Key& ahead = keys[i + AHEAD];
+                            const uint32_t entry = entries_[root_(ahead)];
+                            if (entry & CHILD) {
+                                prefetch(&entries_[(entry & ~CHILD) + ahead[2]]);
+                            }
+                        }
+                        values[i] = find(keys[i]);
+                    }
+                }
+
+                /// Return number of bytes occupied by the entries
+                [[nodiscard]] std::size_t memory_usage() const noexcept {
+                    return entries_.size() * sizeof(uint32_t);
+                }
+
+            }; // class MultibitTrie
+
+            inline MultibitTrie<4>::Key key(const Ipv4Addr& address) noexcept {
+                const IN_ADDR raw = address;
+                MultibitTrie<4>::Key bytes{};
+                std::memcpy(bytes.data(), &raw.S_un.S_addr, bytes.size());
+                return bytes;
+            }
+
+            inline MultibitTrie<16>::Key key(const Ipv6Addr& address) noexcept {
+                const IN6_ADDR raw = address;
+                MultibitTrie<16>::Key bytes{};
+                std::memcpy(bytes.data(), raw.u.Byte, bytes.size());
+                return bytes;
+            }
+
+        } // namespace detail
+
+        template<typename T>
+        class CidrTableBuilder;
+
+        /// Immutable longest-prefix-match table of IPv4 and IPv6 CIDR ranges
+        ///
+        /// \details Maps every address to the value of the most specific range containing it, e.g. the rule of an
+        /// access control list. Both address families are held in separate multibit tries of compact 32-bit entries,
+        /// which take 256 KiB for the first level plus 1 KiB for every further chunk. Tables are built from scratch by
+        /// a `CidrTableBuilder`; updates are applied by building a new table and swapping it in through a
+        /// `SharedCidrTable`, so lookups never wait on writers.
+        ///
+        /// \tparam T Type of the values of the ranges
+        template<typename T>
+        class CidrTable {
+
+            detail::MultibitTrie<4> v4_{};
+            detail::MultibitTrie<16> v6_{};
+            std::vector<T> values_{};       ///< Values of all ranges, referred to by their index + 1
+
+            friend class CidrTableBuilder<T>;
+
+            [[nodiscard]] const T* value_(uint32_t entry) const noexcept {
+                return entry ? &values_[entry - 1] : nullptr;
+            }
+
+        public:
+            // # Constructors
+            CidrTable() noexcept = default;
+
+            CidrTable(const CidrTable& other) = delete;
+
+            CidrTable(CidrTable&& other) noexcept = default;
+
+            // # Operator overloads
+            CidrTable& operator=(const CidrTable& rhs) = delete;
+
+            CidrTable& operator=(CidrTable&& rhs) noexcept = default;
+
+            // # Public member functions
+
+            /// Look up value of the most specific range containing the IPv4 address
+            ///
+            /// \return Pointer to the value, `nullptr` if no range contains the address
+            [[nodiscard]] const T* find(const Ipv4Addr& address) const noexcept {
+                return value_(v4_.find(detail::key(address)));
+            }
+
+            /// Look up value of the most specific range containing the IPv6 address
+            ///
+            /// \return Pointer to the value, `nullptr` if no range contains the address
+            [[nodiscard]] const T* find(const Ipv6Addr& address) const noexcept {
+                return value_(v6_.find(detail::key(address)));
+            }
+
+            /// Look up value of the most specific range containing the address of either version
+            ///
+            /// \return Pointer to the value, `nullptr` if no range contains the address
+            [[nodiscard]] const T* find(const IpAddr& address) const noexcept {
+                if (std::optional<Ipv4Addr> ipv4 = address.as_v4()) return find(*ipv4);
+                return find(*address.as_v6());
+            }
+
+            /// Look up values for a batch of IPv4 addresses
+            ///
+            /// \details Prefetches the entries of upcoming addresses, which pays off once the table no longer fits
+            /// into the last-level cache.
+            ///
+            /// \param addresses Addresses to look up
+            /// \param values Output of pointers to the values, `nullptr` where no range contains the address. Must be
+            /// at least as long as the addresses.
+            void find(gsl::span<const Ipv4Addr> addresses, gsl::span<const T*> values) const noexcept {
+                find_batch_(v4_, addresses, values);
+            }
+
+            /// Look up values for a batch of IPv6 addresses
+            ///
+            /// \param addresses Addresses to look up
+            /// \param values Output of pointers to the values, `nullptr` where no range contains the address. Must be
+            /// at least as long as the addresses.
+            void find(gsl::span<const Ipv6Addr> addresses, gsl::span<const T*> values) const noexcept {
+                find_batch_(v6_, addresses, values);
+            }
+
+            /// Return number of ranges in the table
+            [[nodiscard]] std::size_t size() const noexcept {
+                return values_.size();
+            }
+
+            /// Return number of bytes occupied by both tries
+            [[nodiscard]] std::size_t memory_usage() const noexcept {
+                return v4_.memory_usage() + v6_.memory_usage();
+            }
+
+        private:
+            /// Convert addresses to keys in blocks on the stack and look them up
+            template<std::size_t Bytes, typename Address>
+            void find_batch_(const detail::MultibitTrie<Bytes>& trie, gsl::span<const Address> addresses,
+                             gsl::span<const T*> values) const noexcept {
+                constexpr std::size_t BLOCK = 256;
+                typename detail::MultibitTrie<Bytes>::Key keys[BLOCK];
+                uint32_t entries[BLOCK];
+                for (std::size_t first = 0; first < addresses.size(); first += BLOCK) {
+                    const std::size_t count = std::min<std::size_t>(BLOCK, addresses.size() - first);
+                    for (std::size_t j = 0; j < count; ++j) {
+                        keys[j] = detail::key(addresses[first + j]);
+                    }
+                    trie.find(keys, entries, count);
+                    for (std::size_t j = 0; j < count; ++j) {
+                        values[first + j] = value_(entries[j]);
+                    }
+                }
+            }
+
+        }; // class CidrTable
+
+        /// Builder collecting the ranges of a `CidrTable`
+        ///
+        /// \details Ranges may be inserted in any order. If the same range is inserted more than once, the value
+        /// inserted last takes precedence.
+        ///
+        /// \tparam T Type of the values of the ranges
+        template<typename T>
+        class CidrTableBuilder {
+
+            template<std::size_t Bytes>
+            struct Range_ {
+                typename detail::MultibitTrie<Bytes>::Key key;
+                unsigned length;
+                uint32_t value;
+            };
+
+            std::vector<Range_<4>> v4_{};
+            std::vector<Range_<16>> v6_{};
+            std::vector<T> values_{};
+
+            /// Clear all bits of the key beyond the prefix length
+            template<std::size_t Bytes>
+            static void mask_(typename detail::MultibitTrie<Bytes>::Key& key, unsigned length) noexcept {
+                for (std::size_t i = 0; i < Bytes; ++i) {
+                    const unsigned bits = length > 8 * i ? std::min(length - 8 * static_cast<unsigned>(i), 8u) : 0u;
+                    key[i] &= static_cast<uint8_t>(0xff'00u >> bits);
+                }
+            }
+
+            template<std::size_t Bytes>
+            static detail::MultibitTrie<Bytes> build_(std::vector<Range_<Bytes>> ranges) {
+                std::stable_sort(ranges.begin(), ranges.end(), [](const Range_<Bytes>& lhs, const Range_<Bytes>& rhs) {
+                    return lhs.length < rhs.length;
+                });
+                detail::MultibitTrie<Bytes> trie{};
+                for (const Range_<Bytes>& range : ranges) {
+                    trie.insert(range.key, range.length, range.value);
+                }
+                return trie;
+            }
+
+        public:
+            // # Public member functions
+
+            /// Insert IPv4 range
+            ///
+            /// \param address Network address of the range, host bits are ignored
+            /// \param length Prefix length of the range, 0 to 32
+            /// \param value Value of the range
+            /// \return `true` if the prefix length is valid and the range has been inserted
+            bool insert(const Ipv4Addr& address, unsigned length, T value) {
+                if (length > 32) return false;
+                Range_<4> range{detail::key(address), length, 0};
+                mask_<4>(range.key, length);
+                range.value = push_(std::move(value));
+                v4_.push_back(range);
+                return true;
+            }
+
+            /// Insert IPv6 range
+            ///
+            /// \param address Network address of the range, host bits are ignored
+            /// \param length Prefix length of the range, 0 to 128
+            /// \param value Value of the range
+            /// \return `true` if the prefix length is valid and the range has been inserted
+            bool insert(const Ipv6Addr& address, unsigned length, T value) {
+                if (length > 128) return false;
+                Range_<16> range{detail::key(address), length, 0};
+                mask_<16>(range.key, length);
+                range.value = push_(std::move(value));
+                v6_.push_back(range);
+                return true;
+            }
+
+            /// Insert range in CIDR notation, e.g. `10.0.0.0/8` or `2001:db8::/32`
+            ///
+            /// \param cidr Network address and prefix length separated by a slash
+            /// \param value Value of the range
+            /// \return `true` if the text is well-formed and the range has been inserted
+            bool insert(std::string_view cidr, T value) {
+                const std::size_t slash = cidr.find('/');
+                if (slash == std::string_view::npos || slash + 1 == cidr.size()) return false;
+                unsigned length = 0;
+                const char* last = cidr.data() + cidr.size();
+                auto [end, ec] = std::from_chars(cidr.data() + slash + 1, last, length);
+                if (ec != std::errc{} || end != last) return false;
+                std::optional<IpAddr> address = IpAddr::from(cidr.substr(0, slash));
+                if (!address) return false;
+                if (std::optional<Ipv4Addr> ipv4 = address->as_v4()) return insert(*ipv4, length, std::move(value));
+                return insert(*address->as_v6(), length, std::move(value));
+            }
+
+            /// Return number of inserted ranges
+            [[nodiscard]] std::size_t size() const noexcept {
+                return values_.size();
+            }
+
+            /// Build table of all inserted ranges
+            ///
+            /// \details The builder is left untouched, so that ranges can be added to it and a table rebuilt later.
+            [[nodiscard]] CidrTable<T> build() const {
+                CidrTable<T> table{};
+                table.v4_ = build_(v4_);
+                table.v6_ = build_(v6_);
+                table.values_ = values_;
+                return table;
+            }
+
+        private:
+            uint32_t push_(T value) {
+                values_.push_back(std::move(value));
+                return static_cast<uint32_t>(values_.size());
+            }
+
+        }; // class CidrTableBuilder
+
+        /// Current `CidrTable` shared between readers, replaced as a whole on update
+        ///
+        /// \details Readers take a reference to the current table, which stays valid while they hold it, even if a
+        /// new table is stored concurrently. The previous table is released once its last reader drops it.
+        template<typename T>
+        class SharedCidrTable {
+
+            std::shared_ptr<const CidrTable<T>> current_;
+
+        public:
+            // # Constructors
+            explicit SharedCidrTable(CidrTable<T> table = CidrTable<T>{})
+                : current_{std::make_shared<const CidrTable<T>>(std::move(table))} {}
+
+            SharedCidrTable(const SharedCidrTable& other) = delete;
+
+            // # Operator overloads
+            SharedCidrTable& operator=(const SharedCidrTable& rhs) = delete;
+
+            // # Public member functions
+
+            /// Take reference to the current table
+            [[nodiscard]] std::shared_ptr<const CidrTable<T>> load() const noexcept {
+                return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+            }
+
+            /// Replace the current table
+            void store(CidrTable<T> table) {
+                std::atomic_store_explicit(&current_, std::make_shared<const CidrTable<T>>(std::move(table)),
+                                           std::memory_order_release);
+            }
+
+        }; // class SharedCidrTable
+
+    } // namespace net
+
+    namespace trait {
+
+        template<typename T>
+        constexpr bool is_send<net::CidrTable<T>> = true;
+
+        template<typename T>
+        constexpr bool is_sync<net::CidrTable<T>> = true;
+
+        template<typename T>
+        constexpr bool is_sync<net::SharedCidrTable<T>> = true;
+
+    } // namespace trait
+
+} // namespace laio
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <WinSock2.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "Result.h"
+
+#include "Instrument.h"
+#include "Overlapped.h"
+#include "SocketAddr.h"
+#include "SocketAddrV4.h"
+#include "SocketAddrV6.h"
+#include "TcpStream.h"
+
+namespace laio {
+
+    namespace net {
+
+        /// Builder for the limits of a connection pool
+        class ConnectionPoolOptions {
+
+            std::size_t max_per_host_ = 16;
+            std::size_t min_idle_ = 0;
+            std::chrono::milliseconds max_idle_time_{60'000};
+            std::chrono::milliseconds connect_timeout_{5'000};
+
+            friend class ConnectionPool;
+
+        public:
+            // # Public member functions
+
+            /// Set maximum number of connections per host, whether idle, connecting or handed out
+            ConnectionPoolOptions& max_per_host(std::size_t max) noexcept {
+                max_per_host_ = max;
+                return *this;
+            }
+
+            /// Set number of idle connections `maintain` keeps open to each known host
+            ConnectionPoolOptions& min_idle(std::size_t min) noexcept {
+                min_idle_ = min;
+                return *this;
+            }
+
+            /// Set duration after which idle connections are closed
+            ConnectionPoolOptions& max_idle_time(std::chrono::milliseconds duration) noexcept {
+                max_idle_time_ = duration;
+                return *this;
+            }
+
+            /// Set duration after which pending connects are cancelled
+            ConnectionPoolOptions& connect_timeout(std::chrono::milliseconds duration) noexcept {
+                connect_timeout_ = duration;
+                return *this;
+            }
+
+        }; // class ConnectionPoolOptions
+
+        /// Pool of outbound TCP connections keyed by remote address
+        ///
+        /// \details Connections are established asynchronously through `ConnectEx` and are never waited for: `acquire`
+        /// hands out an idle connection if one is ready and otherwise starts a new connect in the background, as long
+        /// as the host is below its cap. Progress is made by `maintain`, which completes pending connects, closes
+        /// stale or broken idle connections and pre-connects up to the configured minimum.
+        /// Connections of the pool are not associated with any completion port until they are handed out, so that
+        /// the caller can associate them with the port of its choice. A released connection must not have any
+        /// requests in flight. The pool is meant to be owned by a single worker and is not synchronized.
+        class ConnectionPool {
+
+            /// Connection, which is established and not in use
+            struct Idle_ {
+                TcpStream stream;
+                std::chrono::steady_clock::time_point since;
+            };
+
+            /// Connection, which is being established
+            struct Pending_ {
+                TcpStream stream;
+                iocp::Overlapped overlapped{};
+                std::chrono::steady_clock::time_point started;
+            };
+
+            /// Connections to a single remote address
+            struct Host_ {
+                std::deque<Idle_> idle{};
+                std::vector<std::unique_ptr<Pending_>> pending{};
+                std::size_t active = 0;         ///< Number of connections handed out
+                std::optional<Error> error{};
+
+                [[nodiscard]] std::size_t total() const noexcept {
+                    return idle.size() + pending.size() + active;
+                }
+            };
+
+            ConnectionPoolOptions options_;
+            std::unordered_map<SocketAddr, Host_> hosts_{};
+
+        public:
+            // # Constructors
+            explicit ConnectionPool(ConnectionPoolOptions options = ConnectionPoolOptions{}) noexcept
+                : options_{options} {}
+
+            ConnectionPool(const ConnectionPool& other) = delete;
+
+            ConnectionPool(ConnectionPool&& other) noexcept = default;
+
+            // # Destructor
+            ~ConnectionPool() noexcept {
+                cancel_all_();
+            }
+
+            // # Operator overloads
+            ConnectionPool& operator=(const ConnectionPool& rhs) = delete;
+
+            ConnectionPool& operator=(ConnectionPool&& rhs) noexcept {
+                if (this != &rhs) {
+                    // Pending connects own their overlapped structures, which must outlive the connects
+                    cancel_all_();
+                    options_ = rhs.options_;
+                    hosts_ = std::move(rhs.hosts_);
+                    rhs.hosts_.clear();
+                }
+                return *this;
+            }
+
+            // # Public member functions
+
+            /// Take a ready connection to the provided address without blocking
+            ///
+            /// \details Idle connections are health-checked before they are handed out. If no healthy connection is
+            /// ready, a new connect is started, unless the host has reached its cap, and `std::nullopt` is returned.
+            /// The caller retries after the next `maintain`.
+            ///
+            /// \param address Remote socket address
+            /// \return Variant with connection if one is ready, `std::nullopt` if not, error type if the last connect
+            /// to the host has failed
+            Result<std::optional<TcpStream>> acquire(const SocketAddr& address) {
+                Host_& host = hosts_.try_emplace(address).first->second;
+                const auto now = std::chrono::steady_clock::now();
+                while (!host.idle.empty()) {
+                    Idle_ idle = std::move(host.idle.back());
+                    host.idle.pop_back();
+                    if (now - idle.since <= options_.max_idle_time_ && healthy(idle.stream)) {
+                        ++host.active;
+                        return std::optional<TcpStream>{std::move(idle.stream)};
+                    }
+                }
+                if (host.error) {
+                    const Error error = *host.error;
+                    host.error.reset();
+                    return error;
+                }
+                if (host.pending.empty() && host.total() < options_.max_per_host_) {
+                    if (auto res = connect_(address, host); std::holds_alternative<Error>(res)) {
+                        return std::get<Error>(res);
+                    }
+                }
+                return std::optional<TcpStream>{};
+            }
+
+            /// Return a connection to the pool
+            ///
+            /// \param address Remote socket address the connection has been acquired for
+            /// \param stream Connection without any requests in flight
+            /// \param reusable `false` if the connection is broken or in an unknown protocol state and must be closed
+            void release(const SocketAddr& address, TcpStream&& stream, bool reusable = true) {
+                Host_& host = hosts_.try_emplace(address).first->second;
+                if (host.active > 0) {
+                    --host.active;
+                }
+                if (reusable) {
+                    host.idle.push_back(Idle_{std::move(stream), std::chrono::steady_clock::now()});
+                }
+            }
+
+            /// Drive connects and idle connections of all hosts
+            ///
+            /// \details Moves completed connects to the idle connections, cancels connects that exceed the connect
+            /// timeout, closes idle connections that exceeded the idle time or fail the health check, and starts
+            /// connects until each host has at least the minimum number of idle or pending connections.
+            void maintain() {
+                const auto now = std::chrono::steady_clock::now();
+                for (auto& [address, host] : hosts_) {
+                    for (auto it = host.pending.begin(); it != host.pending.end();) {
+                        Pending_& pending = **it;
+                        Result<std::tuple<std::size_t, unsigned long>> res = pending.stream.result(pending.overlapped.raw());
+                        if (auto* err = std::get_if<Error>(&res)) {
+                            if (*err == static_cast<wse::win_errc>(WSA_IO_INCOMPLETE)) {
+                                if (now - pending.started <= options_.connect_timeout_) {
+                                    ++it;
+                                    continue;
+                                }
+                                cancel_(pending);
+                                host.error = Error{static_cast<wse::win_errc>(WSAETIMEDOUT)};
+                            } else {
+                                // Connects are polled for, so that they never pass a completion port
+                                iocp::instrument::completed(pending.overlapped.raw());
+                                host.error = *err;
+                            }
+                        } else {
+                            iocp::instrument::completed(pending.overlapped.raw(), std::get<0>(*res));
+                            if (auto completed = pending.stream.connect_complete();
+                                    std::holds_alternative<Error>(completed)) {
+                                host.error = std::get<Error>(completed);
+                            } else {
+                                host.idle.push_back(Idle_{std::move(pending.stream), now});
+                            }
+                        }
+                        it = host.pending.erase(it);
+                    }
+
+                    for (auto it = host.idle.begin(); it != host.idle.end();) {
+                        if (now - it->since > options_.max_idle_time_ || !healthy(it->stream)) {
+                            it = host.idle.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+
+                    while (host.idle.size() + host.pending.size() < options_.min_idle_
+                            && host.total() < options_.max_per_host_) {
+                        if (std::holds_alternative<Error>(connect_(address, host))) {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            /// Register host, so that `maintain` pre-connects to it
+            ///
+            /// \param address Remote socket address
+            void warm(const SocketAddr& address) {
+                hosts_.try_emplace(address);
+            }
+
+            /// Return number of idle connections to the provided address
+            [[nodiscard]] std::size_t idle(const SocketAddr& address) const {
+                auto it = hosts_.find(address);
+                return it == hosts_.end() ? 0 : it->second.idle.size();
+            }
+
+            /// Return number of connects to the provided address in progress
+            [[nodiscard]] std::size_t pending(const SocketAddr& address) const {
+                auto it = hosts_.find(address);
+                return it == hosts_.end() ? 0 : it->second.pending.size();
+            }
+
+            /// Check whether an idle connection can be handed out
+            ///
+            /// \details An idle connection must neither be readable nor report an error: readability means either that
+            /// the peer has closed the connection or that it has sent data nobody asked for.
+            ///
+            /// \param stream Connection without any requests in flight
+            /// \return `true` if the connection is usable
+            static bool healthy(const TcpStream& stream) noexcept {
+                WSAPOLLFD fd{};
+                fd.fd = stream.as_raw_socket();
+                fd.events = POLLRDNORM;
+                const int ret = WSAPoll(&fd, 1, 0);
+                if (ret == SOCKET_ERROR) {
+                    return false;
+                }
+                if (ret > 0 && (fd.revents & (POLLRDNORM | POLLERR | POLLHUP | POLLNVAL)) != 0) {
+                    return false;
+                }
+                Result<std::optional<Error>> error = stream.take_error();
+                return std::holds_alternative<std::optional<Error>>(error)
+                       && !std::get<std::optional<Error>>(error);
+            }
+
+        private:
+            /// Start asynchronous connect to the provided address
+            Result<std::monostate> connect_(const SocketAddr& address, Host_& host) {
+                Result<TcpStream> stream = TcpStream::create(address);
+                if (std::holds_alternative<Error>(stream)) {
+                    return std::get<Error>(stream);
+                }
+                auto pending = std::make_unique<Pending_>(Pending_{
+                        std::move(std::get<TcpStream>(stream)),
+                        iocp::Overlapped{},
+                        std::chrono::steady_clock::now()});
+
+                // `ConnectEx` requires a bound socket
+                const SocketAddr local = address.is_ipv4()
+                        ? SocketAddr{SocketAddrV4{ipv4::UNSPECIFIED, 0}}
+                        : SocketAddr{SocketAddrV6{ipv6::UNSPECIFIED, 0, 0, 0}};
+                if (auto res = pending->stream.socket().bind(local); std::holds_alternative<Error>(res)) {
+                    return res;
+                }
+                Result<std::optional<std::size_t>> res = pending->stream.connect_overlapped(
+                        address, gsl::span<const uint8_t>{}, pending->overlapped.raw());
+                if (std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                host.pending.push_back(std::move(pending));
+                return std::monostate{};
+            }
+
+            /// Cancel pending connects of all hosts and wait until the system has released their overlapped structures
+            void cancel_all_() noexcept {
+                for (auto& [address, host] : hosts_) {
+                    for (auto& pending : host.pending) {
+                        cancel_(*pending);
+                    }
+                }
+            }
+
+            /// Cancel pending connect and wait until the system has released the overlapped structure
+            static void cancel_(Pending_& pending) noexcept {
+                const HANDLE socket = reinterpret_cast<HANDLE>(pending.stream.as_raw_socket());
+                CancelIoEx(socket, pending.overlapped.raw());
+                DWORD transferred = 0;
+                DWORD flags = 0;
+                WSAGetOverlappedResult(pending.stream.as_raw_socket(), pending.overlapped.raw(), &transferred, TRUE, &flags);
+                iocp::instrument::completed(pending.overlapped.raw(), transferred);
+            }
+
+        }; // class ConnectionPool
+
+    } // namespace net
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<net::ConnectionPool> = true;
+
+    } // namespace trait
+
+} // namespace laio
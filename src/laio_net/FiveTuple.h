@@ -0,0 +1,78 @@
+#pragma once
+
+#include <WinSock2.h>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+
+#include "Hash.h"
+#include "IpAddr.h"
+#include "SocketAddr.h"
+
+namespace laio::net {
+
+    using std::uint8_t;
+    using std::uint16_t;
+    using std::uint64_t;
+
+    /// Connection key of source and destination address and port, and transport protocol
+    ///
+    /// \details Trivially copyable and 48 bytes large, so that connection tables such as a `FlatMap` can store keys
+    /// inline.
+    struct FiveTuple {
+        IpAddr source;                  ///< Source address
+        IpAddr destination;             ///< Destination address
+        uint16_t source_port;           ///< Source port in host byte order
+        uint16_t destination_port;      ///< Destination port in host byte order
+        uint8_t protocol;               ///< Transport protocol, e.g. `IPPROTO_TCP`
+
+        /// Create key of a connection between two socket addresses
+        ///
+        /// \param source Source socket address, e.g. the peer address of an accepted connection
+        /// \param destination Destination socket address, e.g. the local address of an accepted connection
+        /// \param protocol Transport protocol
+        static FiveTuple from(const SocketAddr& source, const SocketAddr& destination, uint8_t protocol) noexcept {
+            return FiveTuple{source.ip(), destination.ip(), source.port(), destination.port(), protocol};
+        }
+
+        bool operator==(const FiveTuple& rhs) const noexcept {
+            return source_port == rhs.source_port
+                && destination_port == rhs.destination_port
+                && protocol == rhs.protocol
+                && source == rhs.source
+                && destination == rhs.destination;
+        }
+
+    }; // struct FiveTuple
+
+    static_assert(sizeof(FiveTuple) <= 48 && std::is_trivially_copyable_v<FiveTuple>);
+
+} // namespace laio::net
+
+namespace std {
+
+    template<>
+    struct hash<laio::net::FiveTuple> {
+        std::size_t operator()(const laio::net::FiveTuple& key) const noexcept {
+            using laio::net::IpAddr;
+            using laio::net::Ipv4Addr;
+            namespace hash = laio::net::hash;
+            std::uint64_t addresses = 0;
+            std::optional<Ipv4Addr> source = key.source.as_v4();
+            std::optional<Ipv4Addr> destination = key.destination.as_v4();
+            if (source && destination) {
+                // Both IPv4 addresses fit into a single integer
+                addresses = hash::mix(static_cast<std::uint64_t>(source->to_bits()) << 32u | destination->to_bits());
+            } else {
+                addresses = hash::combine(std::hash<IpAddr>{}(key.source), std::hash<IpAddr>{}(key.destination));
+            }
+            const std::uint64_t ports = static_cast<std::uint64_t>(key.source_port) << 24u
+                                      | static_cast<std::uint64_t>(key.destination_port) << 8u
+                                      | key.protocol;
+            return static_cast<std::size_t>(hash::combine(addresses, ports));
+        }
+    };
+
+} // namespace std
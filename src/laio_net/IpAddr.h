@@ -0,0 +1,171 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "HidingNonVirtualFunction"
+#pragma once
+
+#include <WinSock2.h>
+
+#include <charconv>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "fmt/format.h"
+#include "Result.h"
+
+#include "Format.h"
+#include "IpAddrExt.h"
+#include "Ipv4Addr.h"
+#include "Ipv6Addr.h"
+
+namespace laio {
+
+    namespace net {
+
+        /// IP address of either version
+        ///
+        /// \details In the Rust Standard Library this is an enum over both versions of IP addresses. The address is
+        /// stored as a union tagged with its address family, which takes 20 bytes and, unlike `std::variant`, is
+        /// guaranteed to be trivially copyable and standard-layout, so that large tables of addresses can be copied
+        /// with `memcpy`.
+        class IpAddr final : public interface::IpAddrExt<IpAddr> {
+
+            union {
+                Ipv4Addr v4_;               ///< IPv4 address, if the family is `AF_INET`
+                Ipv6Addr v6_;               ///< IPv6 address, if the family is `AF_INET6`
+            };
+            ADDRESS_FAMILY family_;         ///< Address family of the active member
+
+        public:
+            static constexpr std::size_t MAX_STR_LEN = Ipv6Addr::MAX_STR_LEN;     ///< Length of longest address text
+
+            // # Constructors
+            constexpr IpAddr(Ipv4Addr ipv4Address) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+                : v4_{ipv4Address}, family_{AF_INET} {}
+
+            constexpr IpAddr(Ipv6Addr ipv6Address) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+                : v6_{ipv6Address}, family_{AF_INET6} {}
+
+            // # Operator overloads
+            explicit operator std::string() const {
+                char buf[MAX_STR_LEN];
+                return std::string{buf, to_chars(buf, buf + sizeof buf).ptr};
+            }
+
+            bool operator==(const IpAddr& rhs) const noexcept {
+                if (family_ != rhs.family_) return false;
+                return is_ipv4() ? v4_ == rhs.v4_ : v6_ == rhs.v6_;
+            }
+
+            /// Order addresses by version first, IPv4 addresses before IPv6 addresses
+            bool operator<(const IpAddr& rhs) const noexcept {
+                if (family_ != rhs.family_) return is_ipv4();
+                return is_ipv4() ? v4_ < rhs.v4_ : v6_ < rhs.v6_;
+            }
+
+            // # Public member functions
+
+            /// Parse address of either version from string
+            ///
+            /// \param ipAddress Address text, e.g. `192.168.0.1` or `2001:db8::1`
+            /// \return IP address if the text is a well-formed IPv4 or IPv6 address, `std::nullopt` otherwise
+            static std::optional<IpAddr> from(std::string_view ipAddress) noexcept {
+                if (std::optional<Ipv4Addr> ipv4 = Ipv4Addr::from(ipAddress)) return *ipv4;
+                if (std::optional<Ipv6Addr> ipv6 = Ipv6Addr::from(ipAddress)) return *ipv6;
+                return std::nullopt;
+            }
+
+            /// Format address into a character buffer
+            ///
+            /// \details Writes no more than `MAX_STR_LEN` characters and allocates nothing. The output is not
+            /// null-terminated.
+            ///
+            /// \param first Start of output
+            /// \param last End of output
+            /// \return Result with end of the written text, or `std::errc::value_too_large` if the output is too small
+            std::to_chars_result to_chars(char* first, char* last) const noexcept {
+                return is_ipv4() ? v4_.to_chars(first, last) : v6_.to_chars(first, last);
+            }
+
+            /// Return address family of this address (`AF_INET` or `AF_INET6`)
+            [[nodiscard]] constexpr int family() const noexcept {
+                return family_;
+            }
+
+            /// Return `true` if this address is unspecified
+            [[nodiscard]] constexpr bool is_unspecified() const noexcept {
+                return is_ipv4() ? v4_.is_unspecified() : v6_.is_unspecified();
+            }
+
+            /// Return `true` if this is a loopback address
+            [[nodiscard]] constexpr bool is_loopback() const noexcept {
+                return is_ipv4() ? v4_.is_loopback() : v6_.is_loopback();
+            }
+
+            /// Return `true` if this address appears to be globally routable
+            [[nodiscard]] constexpr bool is_global() const noexcept {
+                return is_ipv4() ? v4_.is_global() : v6_.is_global();
+            }
+
+            /// Return `true` if this address is of the multicast address space
+            [[nodiscard]] constexpr bool is_multicast() const noexcept {
+                return is_ipv4() ? v4_.is_multicast() : v6_.is_multicast();
+            }
+
+            /// Return `true` if this address is of the range designated for documentation
+            [[nodiscard]] constexpr bool is_documentation() const noexcept {
+                return is_ipv4() ? v4_.is_documentation() : v6_.is_documentation();
+            }
+
+            /// Return `true` if this is an IPv4 address
+            [[nodiscard]] constexpr bool is_ipv4() const noexcept {
+                return family_ == AF_INET;
+            }
+
+            /// Return `true` if this is an IPv6 address
+            [[nodiscard]] constexpr bool is_ipv6() const noexcept {
+                return family_ == AF_INET6;
+            }
+
+            /// Return IPv4 address if this is one
+            [[nodiscard]] std::optional<Ipv4Addr> as_v4() const noexcept {
+                if (is_ipv4()) return v4_;
+                return std::nullopt;
+            }
+
+            /// Return IPv6 address if this is one
+            [[nodiscard]] std::optional<Ipv6Addr> as_v6() const noexcept {
+                if (is_ipv6()) return v6_;
+                return std::nullopt;
+            }
+
+        }; // class IpAddr
+
+        static_assert(sizeof(IpAddr) <= 20 && std::is_trivially_copyable_v<IpAddr> && std::is_standard_layout_v<IpAddr>);
+
+    } // namespace net
+
+} // namespace laio
+
+namespace fmt {
+
+    template<>
+    struct formatter<laio::net::IpAddr> : laio::net::format::ToCharsFormatter<laio::net::IpAddr> {};
+
+} // namespace fmt
+
+namespace std {
+
+    template<>
+    struct hash<laio::net::IpAddr> {
+        std::size_t operator()(const laio::net::IpAddr& address) const noexcept {
+            if (std::optional<laio::net::Ipv4Addr> ipv4 = address.as_v4()) return hash<laio::net::Ipv4Addr>{}(*ipv4);
+            return hash<laio::net::Ipv6Addr>{}(*address.as_v6());
+        }
+    };
+
+} // namespace std
+
+#pragma clang diagnostic pop
@@ -6,17 +6,24 @@
 
 #include <WinSock2.h>
 
+#include <charconv>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <variant>
 
 #include "fmt/format.h"
-#include "win_error.h"
+#include "Result.h"
 
-#include "IpAddr.h"
+#include "Format.h"
+#include "Hash.h"
+#include "IpAddrExt.h"
 #include "Ipv6Addr.h"
 #include "Parser.h"
 
@@ -27,35 +34,28 @@ namespace laio {
     using std::uint8_t;
     using std::uint32_t;
 
-    template<typename T>
-    using Result = std::variant<T, wse::win_error>;
-
     namespace net {
 
         /// IPv4 address implementation
         ///
         /// \details IPv4 address as a 32-bit integer represented through four single bytes. This implementation assumes
         /// host system with little-endian byte order. The class contains a Windows `IN_ADDR` structure that abstracts
-        /// the handling of endianness, but requires unsafely accessing inactive union variants.
-        class Ipv4Addr final : public interface::IpAddr<Ipv4Addr>  {
+        /// the handling of endianness, but requires unsafely accessing inactive union variants. The class is exactly as
+        /// large as the structure and trivially copyable.
+        class Ipv4Addr final : public interface::IpAddrExt<Ipv4Addr>  {
 
             IN_ADDR raw_ipv4_address_{};        ///< Windows IpV4 address structure (unsafe union access!)
 
         public:
+            static constexpr std::size_t MAX_STR_LEN = format::IPV4_MAX_LEN;     ///< Length of longest address text
+
             // # Constructors
             constexpr Ipv4Addr() noexcept = default;
 
             constexpr Ipv4Addr(IN_ADDR ipv4Address) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
                 : raw_ipv4_address_{std::move(ipv4Address)} {}
 
-            Ipv4Addr(const Ipv4Addr& other) noexcept = default;
-
-            Ipv4Addr(Ipv4Addr&& other) noexcept
-                    : raw_ipv4_address_{std::move(other.raw_ipv4_address_)}
-            {
-                other.raw_ipv4_address_.S_un.S_addr = 0;
-            }
-
+            constexpr Ipv4Addr(const Ipv4Addr& other) noexcept = default;
 
             explicit constexpr Ipv4Addr(const uint8_t a, const uint8_t b, const uint8_t c, const uint8_t d) noexcept
                 : raw_ipv4_address_{ { {a, b, c, d} /* struct */ } /* union */ } {}
@@ -65,9 +65,9 @@ namespace laio {
                 return raw_ipv4_address_;
             }
 
-            explicit operator std::string() const noexcept {
-                auto [a, b, c, d] = octets();
-                return fmt::format("{}.{}.{}.{}", a, b, c, d);
+            explicit operator std::string() const {
+                char buf[MAX_STR_LEN];
+                return std::string{buf, to_chars(buf, buf + sizeof buf).ptr};
             }
 
             bool operator==(const Ipv4Addr& rhs) const noexcept {
@@ -75,12 +75,7 @@ namespace laio {
             }
 
             bool operator<(const Ipv4Addr& rhs) const noexcept {
-                auto [lhs_a, lhs_b, lhs_c, lhs_d] = octets();
-                auto [rhs_a, rhs_b, rhs_c, rhs_d] = rhs.octets();
-                return lhs_a <= rhs_b
-                    && lhs_b <= rhs_b
-                    && lhs_c <= rhs_c
-                    && lhs_d < rhs_d;
+                return to_bits() < rhs.to_bits();
             }
 
             bool operator==(const Ipv6Addr& rhs) const noexcept {
@@ -95,35 +90,30 @@ namespace laio {
 
             /// Parse address from string
             ///
-            /// \return IPv4 address structure
-            static std::optional<Ipv4Addr> from(const std::string& ipv4Address) {
-                uint_fast16_t buf[4] = {0};
-                uint_fast8_t pos = 0, octet = 0;
-                for (auto i = ipv4Address.begin(); i < ipv4Address.end(); ++i) {
-
-                    // Each octet is representable with max 3 digits
-                    if (*i >= '0' && *i <= '9' && pos < 3 && octet < 4) {
-                        buf[octet] = buf[octet] * 10 + (*i - '0');
-
-                        // The maximum valid value an octet can hold is 255
-                        if (buf[octet] > (std::numeric_limits<uint8_t>::max)()) return std::nullopt;
-                        ++pos;
-                    }
-
-                    // There should be precisely 3 periods in the address, each maximum 3 digits apart
-                    else if (*i == '.' && pos > 0 && pos < 4 && octet < 3) {
-                        pos = 0;
-                        ++octet;
-                    } else {
-                        return std::nullopt;
-                    }
-                }
-                return Ipv4Addr{
-                    static_cast<uint8_t>(buf[0]),
-                    static_cast<uint8_t>(buf[1]),
-                    static_cast<uint8_t>(buf[2]),
-                    static_cast<uint8_t>(buf[3])
-                };
+            /// \details Accepts exactly four decimal octets of one to three digits each, separated by periods. Uses
+            /// the vectorized parser if the target supports SSE4.1 and the scalar parser otherwise.
+            ///
+            /// \param ipv4Address Address text, e.g. `192.168.0.1`
+            /// \return IPv4 address structure if the text is well-formed, `std::nullopt` otherwise
+            static std::optional<Ipv4Addr> from(std::string_view ipv4Address) noexcept {
+                std::optional<parser::Ipv4Octets> octets = parser::ipv4(ipv4Address);
+                if (!octets) return std::nullopt;
+                auto [a, b, c, d] = *octets;
+                return Ipv4Addr{a, b, c, d};
+            }
+
+            /// Format address in dotted-decimal notation into a character buffer
+            ///
+            /// \details Writes no more than `MAX_STR_LEN` characters and allocates nothing. The output is not
+            /// null-terminated.
+            ///
+            /// \param first Start of output
+            /// \param last End of output
+            /// \return Result with end of the written text, or `std::errc::value_too_large` if the output is too small
+            std::to_chars_result to_chars(char* first, char* last) const noexcept {
+                char buf[format::IPV4_MAX_LEN + 1];
+                auto [a, b, c, d] = octets();
+                return format::copy(first, last, buf, format::ipv4(buf, a, b, c, d));
             }
 
             /// Extract address in four 8-bit integer format
@@ -139,11 +129,20 @@ namespace laio {
                 return {a, b, c, d};
             }
 
+            /// Return address as 32-bit integer in host byte order
+            ///
+            /// \details The integer orders addresses like their octets, e.g. `a.b.c.d` is `a << 24 | b << 16 | c << 8 | d`.
+            [[nodiscard]] constexpr uint32_t to_bits() const noexcept {
+                auto [a, b, c, d] = octets();
+                return static_cast<uint32_t>(a) << 24u | static_cast<uint32_t>(b) << 16u
+                     | static_cast<uint32_t>(c) << 8u | static_cast<uint32_t>(d);
+            }
+
             /// Return `true` if this address is unspecified
             ///
             /// \details For IPv4 the unspecified address is: 0.0.0.0
             [[nodiscard]] constexpr bool is_unspecified() const noexcept {
-                return raw_ipv4_address_.S_un.S_addr == 0x00'00'00'00;
+                return to_bits() == 0x00'00'00'00u;
             }
 
             /// Return `true` if this is a loopback address
@@ -182,7 +181,7 @@ namespace laio {
             ///
             /// \details For IPv4 the broadcast address is: 255.255.255.255
             [[nodiscard]] constexpr bool is_broadcast() const noexcept {
-                return raw_ipv4_address_.S_un.S_addr == 0xff'ff'ff'ff;
+                return to_bits() == 0xff'ff'ff'ffu;
             }
 
             /// Return `true` if this address is of the range designated for documentation
@@ -190,10 +189,10 @@ namespace laio {
             /// \details For IPv4 the address space designated for documentation is: 192.0.2.0/24, 198.51.100.0/24,
             /// 203.0.113.0/24
             [[nodiscard]] constexpr bool is_documentation() const noexcept {
-                switch (raw_ipv4_address_.S_un.S_addr & 0x00'ff'ff'ffu) {
-                    case 0x00'02'00'c0: return true;
-                    case 0x00'64'33'c6: return true;
-                    case 0x00'71'00'cb: return true;
+                switch (to_bits() >> 8u) {
+                    case 0xc0'00'02: return true;
+                    case 0xc6'33'64: return true;
+                    case 0xcb'00'71: return true;
                     default: return false;
                 }
             }
@@ -239,7 +238,7 @@ namespace laio {
             [[nodiscard]] constexpr bool is_global() const noexcept {
 
                 // Only 192.0.0.9 and 192.0.0.10 are globally routable in 192.0.0.0/24
-                if (raw_ipv4_address_.S_un.S_addr == 0x09'00'00'c0 || raw_ipv4_address_.S_un.S_addr == 0x0a'00'00'c0)
+                if (to_bits() == 0xc0'00'00'09u || to_bits() == 0xc0'00'00'0au)
                     return true;
                 return !is_private()
                     && !is_loopback()
@@ -295,7 +294,10 @@ namespace laio {
 
         }; // class Ipv4Addr
 
-        [[nodiscard]] std::optional<Ipv4Addr> Ipv6Addr::to_ipv4() const noexcept {
+        static_assert(sizeof(Ipv4Addr) == sizeof(IN_ADDR) && std::is_trivially_copyable_v<Ipv4Addr>
+                      && std::is_standard_layout_v<Ipv4Addr>);
+
+        [[nodiscard]] inline std::optional<Ipv4Addr> Ipv6Addr::to_ipv4() const noexcept {
             auto [a, b, c, d, e, f, g, h] = segments();
             if (!a && !b && !c && !d && !e && (!f || f == 0xff'ff))
                 return Ipv4Addr{static_cast<uint8_t>(g >> 8u),
@@ -307,15 +309,48 @@ namespace laio {
 
         namespace ipv4 {
 
-            const Ipv4Addr LOCALHOST{127, 0, 0, 1};         ///< IPv4 localhost address
+            constexpr Ipv4Addr LOCALHOST{127, 0, 0, 1};         ///< IPv4 localhost address
 
-            const Ipv4Addr UNSPECIFIED{0, 0, 0, 0};         ///< IPv4 unspecified address
+            constexpr Ipv4Addr UNSPECIFIED{0, 0, 0, 0};         ///< IPv4 unspecified address
 
-            const Ipv4Addr BROADCAST{255, 255, 255, 255};   ///< IPv4 broadcast address
+            constexpr Ipv4Addr BROADCAST{255, 255, 255, 255};   ///< IPv4 broadcast address
 
         } // namespace ipv4
 
+        namespace literals {
+
+            /// Create IPv4 address from literal, e.g. `constexpr Ipv4Addr gateway = "10.0.0.1"_ipv4;`
+            ///
+            /// \details The literal is parsed at compile time wherever a constant is required, e.g. to initialize a
+            /// `constexpr` variable, so that malformed literals fail the build. Evaluated at run time, malformed literals
+            /// throw `std::invalid_argument`.
+            constexpr Ipv4Addr operator""_ipv4(const char* text, std::size_t len) {
+                const std::optional<parser::Ipv4Octets> octets = parser::ipv4_scalar({text, len});
+                if (!octets) throw std::invalid_argument{"malformed IPv4 address literal"};
+                return Ipv4Addr{(*octets)[0], (*octets)[1], (*octets)[2], (*octets)[3]};
+            }
+
+        } // namespace literals
+
     } // namespace net
 
 } // namespace laio
+
+namespace fmt {
+
+    template<>
+    struct formatter<laio::net::Ipv4Addr> : laio::net::format::ToCharsFormatter<laio::net::Ipv4Addr> {};
+
+} // namespace fmt
+
+namespace std {
+
+    template<>
+    struct hash<laio::net::Ipv4Addr> {
+        std::size_t operator()(const laio::net::Ipv4Addr& address) const noexcept {
+            return static_cast<std::size_t>(laio::net::hash::mix(address.to_bits()));
+        }
+    };
+
+} // namespace std
 #pragma clang diagnostic pop
\ No newline at end of file
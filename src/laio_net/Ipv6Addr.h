@@ -5,27 +5,37 @@
 
 #include <WS2tcpip.h>
 
+#include <charconv>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <optional>
+#include <stdexcept>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <variant>
 
 #include "fmt/format.h"
-#include "win_error.h"
+#include "Result.h"
 
-#include "IpAddr.h"
+#include "Format.h"
+#include "Hash.h"
+#include "IpAddrExt.h"
 #include "Parser.h"
 
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <stdlib.h>
+#endif
+
 namespace laio {
 
     using std::uint_fast8_t;
     using std::uint8_t;
     using std::uint16_t;
-
-    template<typename T>
-    using Result = std::variant<T, wse::win_error>;
+    using std::uint64_t;
 
     namespace net {
 
@@ -45,13 +55,16 @@ namespace laio {
         /// IPv6 address implementation
         ///
         /// \details IPv6 as a 128-bit integer represented through eight 16-bit segments. This implementation assumes
-        // host system with little-endian byte order. The class contains a Windows `IN6_ADDR` structure that abstracts
-        // the handling of endianness, but requires unsafely accessing inactive union variants.
-        class Ipv6Addr final : public interface::IpAddr<Ipv6Addr> {
+        /// host system with little-endian byte order. The class contains a Windows `IN6_ADDR` structure that abstracts
+        /// the handling of endianness, but requires unsafely accessing inactive union variants. The class is exactly as
+        /// large as the structure and trivially copyable, and compares as two 64-bit integers.
+        class Ipv6Addr final : public interface::IpAddrExt<Ipv6Addr> {
 
             IN6_ADDR raw_ipv6_address_{};     ///< Windows IpV6 address structure (unsafe union access!)
 
         public:
+            static constexpr std::size_t MAX_STR_LEN = format::IPV6_MAX_LEN;     ///< Length of longest address text
+
             // # Constructors
             constexpr Ipv6Addr() noexcept = default;
 
@@ -80,110 +93,21 @@ namespace laio {
                 return raw_ipv6_address_;
             }
 
-            explicit operator std::string() const noexcept {
-                auto [a, b, c, d, e, f, g, h] = segments();
-
-                // IPv4 convertible addresses, that require special formatting are handled first
-                if (!a && !b && !c && !d && !e && (!f || f == 0xff'ff)) {
-
-                    // Special case [0, 0, 0, 0, 0, 0, 0, 0] -> `::`
-                    if (!g && !h) {
-                        return "::";
-                    }
-
-                    // Special case [0, 0, 0, 0, 0, 0, 0, 1] -> `::1`
-                    else if (!g && h == 1) {
-                        return "::1";
-                    }
-
-                    // IPv4-compatible [0, 0, 0, 0, 0, 0, g, h]
-                    else if (!f) {
-                        return fmt::format("::{}.{}.{}.{}",
-                                static_cast<uint8_t>(g >> 8u), static_cast<uint8_t>(g),
-                                static_cast<uint8_t>(h >> 8u), static_cast<uint8_t>(h));
-                    }
-
-                    // IPv4-mapped [0, 0, 0, 0, 0, 0xff'ff, g, h]
-                    else {
-                        return fmt::format("::ffff:{}.{}.{}.{}",
-                                           static_cast<uint8_t>(g >> 8u), static_cast<uint8_t>(g),
-                                           static_cast<uint8_t>(h >> 8u), static_cast<uint8_t>(h));
-
-                    }
-                } // if IPv4 compatible addresses
-
-                // General formatting rules for IPv6 addresses:
-                // The 16-bit segments are represented in hexadecimal notation, separated by a double-colon each. The
-                // longest sequence of zero segments can be contracted from e.g. `:0000:0000:` to `::`. Only one
-                // sequence can be contracted in this manner. Leading zeros are omitted.
-                else {
-                    uint_fast8_t zero_span_len = 0;
-                    uint_fast8_t zero_span_at = 0;
-                    uint_fast8_t cur_span_len = 0;
-                    uint_fast8_t cur_span_at = 0;
-                    uint16_t segments[] = {a, b, c, d, e, f, g, h};
-
-                    // Determine the longest span of consecutive zero-segments
-                    for (uint_fast8_t i = 0; i < 8; ++i) {
-                        if (!segments[i]) {
-                            if (!cur_span_len) {
-                                cur_span_at = i;
-                            }
-                            ++cur_span_len;
-                            if (cur_span_len > zero_span_len) {
-                                zero_span_len = cur_span_len;
-                                zero_span_at = cur_span_at;
-                            }
-                        }
-                        else {
-                            cur_span_len = 0;
-                            cur_span_at = 0;
-                        }
-                    }
-
-                    // Format leading and trailing non-zero segments, omitting them if they are empty
-                    if (zero_span_len > 1) {
-                        std::stringstream builder{};
-                        uint_fast8_t i = 1;
-
-                        // If leading subspan is empty, then skip
-                        if (zero_span_at) {
-                            builder << fmt::format("{:x}", segments[0]);
-                            for (; i < zero_span_at; ++i) {
-                                builder << fmt::format(":{:x}", segments[i]);
-                            }
-                        }
-                        builder << "::";
-                        i = zero_span_at + zero_span_len;
-
-                        // If trailing subspan is empty, then skip
-                        if (i < 8) {
-                            builder << fmt::format("{:x}", segments[i++]);
-                            for (; i < 8; ++i) {
-                                builder << fmt::format(":{:x}", segments[i]);
-                            }
-                        }
-                        return builder.str();
-                    }
-
-                    // If no span with more than one zero segment has been found, then no special rules apply other than
-                    // omitting leading zeroes
-                    else {
-                        return fmt::format("{:x}:{:x}:{:x}:{:x}:{:x}:{:x}:{:x}:{:x}", a, b, c, d, e, f, g, h);
-                    }
-                }
+            explicit operator std::string() const {
+                char buf[MAX_STR_LEN];
+                return std::string{buf, to_chars(buf, buf + sizeof buf).ptr};
             }
 
             bool operator==(const Ipv6Addr& rhs) const noexcept {
-                for (uint_fast8_t i = 0; i < 8; ++i) {
-                    if (raw_ipv6_address_.u.Word[i] != rhs.raw_ipv6_address_.u.Word[i])
-                        return false;
-                }
-                return true;
+                uint64_t lhs_halves[2];
+                uint64_t rhs_halves[2];
+                std::memcpy(lhs_halves, raw_ipv6_address_.u.Byte, sizeof lhs_halves);
+                std::memcpy(rhs_halves, rhs.raw_ipv6_address_.u.Byte, sizeof rhs_halves);
+                return ((lhs_halves[0] ^ rhs_halves[0]) | (lhs_halves[1] ^ rhs_halves[1])) == 0;
             }
 
             bool operator<(const Ipv6Addr& rhs) const noexcept {
-                return segments() < rhs.segments();
+                return to_bits() < rhs.to_bits();
             }
 
             bool operator==(const Ipv4Addr& rhs) const noexcept {
@@ -198,29 +122,43 @@ namespace laio {
 
             /// Parse address from string
             ///
-            /// \return IPv6 address structure
-            /*static std::optional<Ipv6Addr> from(const std::string& ipv6Address) {
-                uint_fast32_t buf[8] = {0};
-                uint_fast8_t pos = 0, octet = 0;
-                for (auto i = ipv4Address.begin(); i < ipv4Address.end(); ++i) {
-                    if (*i >= '0' && *i <= '9' && pos < 3 && octet < 4) {
-                        buf[octet] = buf[octet] * 10 + (*i - '0');
-                        if (buf[octet] > 255) return std::nullopt;
-                        ++pos;
-                    } else if (*i == '.' && pos < 4 && octet < 3) {
-                        pos = 0;
-                        ++octet;
-                    } else {
-                        return std::nullopt;
-                    }
-                }
-                return Ipv6Addr{
-                        static_cast<uint8_t>(buf[0]),
-                        static_cast<uint8_t>(buf[1]),
-                        static_cast<uint8_t>(buf[2]),
-                        static_cast<uint8_t>(buf[3])
-                };
-            }*/
+            /// \details Accepts all text representations of RFC 4291, including `::` compression and embedded IPv4
+            /// addresses. Zone identifiers are rejected, as they belong to the socket address.
+            ///
+            /// \param ipv6Address Address text, e.g. `2001:db8::1`
+            /// \return IPv6 address structure if the text is well-formed, `std::nullopt` otherwise
+            static std::optional<Ipv6Addr> from(std::string_view ipv6Address) noexcept {
+                std::optional<parser::Ipv6Text> parsed = parser::ipv6(ipv6Address);
+                if (!parsed || !parsed->zone.empty()) return std::nullopt;
+                IN6_ADDR address{};
+                std::memcpy(address.u.Byte, parsed->octets.data(), sizeof address.u.Byte);
+                return Ipv6Addr{address};
+            }
+
+            /// Format address in the canonical notation of RFC 5952 into a character buffer
+            ///
+            /// \details IPv4-compatible and IPv4-mapped addresses are written with a dotted-decimal tail. Writes no
+            /// more than `MAX_STR_LEN` characters and allocates nothing. The output is not null-terminated.
+            ///
+            /// \param first Start of output
+            /// \param last End of output
+            /// \return Result with end of the written text, or `std::errc::value_too_large` if the output is too small
+            std::to_chars_result to_chars(char* first, char* last) const noexcept {
+                char buf[format::IPV6_MAX_LEN + 1];
+                auto [a, b, c, d, e, f, g, h] = segments();
+                const uint16_t groups[8] = {a, b, c, d, e, f, g, h};
+                return format::copy(first, last, buf, format::ipv6(buf, groups));
+            }
+
+            /// Return address as a pair of 64-bit integers in host byte order
+            ///
+            /// \details The first integer holds the upper and the second the lower half of the address, so that the
+            /// pair orders addresses like their segments.
+            [[nodiscard]] std::pair<uint64_t, uint64_t> to_bits() const noexcept {
+                uint64_t halves[2];
+                std::memcpy(halves, raw_ipv6_address_.u.Byte, sizeof halves);
+                return {byteswap_(halves[0]), byteswap_(halves[1])};
+            }
 
             /// Extract address in eight 16-bit integer segments
             ///
@@ -229,37 +167,30 @@ namespace laio {
             /// \return Tuple with eight 16-bit integers
             [[nodiscard]] constexpr std::tuple<uint16_t, uint16_t, uint16_t, uint16_t,
                                                uint16_t, uint16_t, uint16_t, uint16_t> segments() const noexcept {
-                uint16_t a = raw_ipv6_address_.u.Word[0] << 8u | raw_ipv6_address_.u.Word[0] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                uint16_t b = raw_ipv6_address_.u.Word[1] << 8u | raw_ipv6_address_.u.Word[1] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                uint16_t c = raw_ipv6_address_.u.Word[2] << 8u | raw_ipv6_address_.u.Word[2] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                uint16_t d = raw_ipv6_address_.u.Word[3] << 8u | raw_ipv6_address_.u.Word[3] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                uint16_t e = raw_ipv6_address_.u.Word[4] << 8u | raw_ipv6_address_.u.Word[4] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                uint16_t f = raw_ipv6_address_.u.Word[5] << 8u | raw_ipv6_address_.u.Word[5] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                uint16_t g = raw_ipv6_address_.u.Word[6] << 8u | raw_ipv6_address_.u.Word[6] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                uint16_t h = raw_ipv6_address_.u.Word[7] << 8u | raw_ipv6_address_.u.Word[7] >> 8u; // NOLINT(hicpp-signed-bitwise)
-                return {a, b, c, d, e, f, g, h};
+                return {segment_(0), segment_(1), segment_(2), segment_(3),
+                        segment_(4), segment_(5), segment_(6), segment_(7)};
             }
 
             /// Return `true` if this address is of the multicast address space
             ///
             /// \details For IPv6 the multicast address space is: `ff00::/8`
             [[nodiscard]] constexpr bool is_multicast() const noexcept {
-                return (raw_ipv6_address_.u.Word[0] & 0x00'ffu) == 0x00'ffu;
+                return (segment_(0) & 0xff'00u) == 0xff'00u;
             }
 
             /// Determine the address' multicast scope if the address is multicast
             ///
             /// \return Scope of the IPv6 address if the address is multicast, `std::nullopt` otherwise
-            [[nodiscard]] std::optional<Ipv6MulticastScope> multicast_scope() const noexcept {
+            [[nodiscard]] constexpr std::optional<Ipv6MulticastScope> multicast_scope() const noexcept {
                 if (is_multicast()) {
-                    switch (raw_ipv6_address_.u.Word[0] & 0x0f'00u) {
-                        case 0x01'00: return Ipv6MulticastScope::InterfaceLocal;
-                        case 0x02'00: return Ipv6MulticastScope::LinkLocal;
-                        case 0x03'00: return Ipv6MulticastScope::RealmLocal;
-                        case 0x04'00: return Ipv6MulticastScope::AdminLocal;
-                        case 0x05'00: return Ipv6MulticastScope::SiteLocal;
-                        case 0x08'00: return Ipv6MulticastScope::OrganizationLocal;
-                        case 0x0e'00: return Ipv6MulticastScope::Global;
+                    switch (segment_(0) & 0x00'0fu) {
+                        case 0x00'01: return Ipv6MulticastScope::InterfaceLocal;
+                        case 0x00'02: return Ipv6MulticastScope::LinkLocal;
+                        case 0x00'03: return Ipv6MulticastScope::RealmLocal;
+                        case 0x00'04: return Ipv6MulticastScope::AdminLocal;
+                        case 0x00'05: return Ipv6MulticastScope::SiteLocal;
+                        case 0x00'08: return Ipv6MulticastScope::OrganizationLocal;
+                        case 0x00'0e: return Ipv6MulticastScope::Global;
                         default: return std::nullopt;
                     }
                 }
@@ -270,8 +201,8 @@ namespace laio {
             ///
             /// \details For IPv6 the unspecified address is: `::`
             [[nodiscard]] constexpr bool is_unspecified() const noexcept {
-                for (uint16_t segment: raw_ipv6_address_.u.Word) {
-                    if (segment != 0)
+                for (uint_fast8_t i = 0; i < 8; ++i) {
+                    if (segment_(i) != 0)
                         return false;
                 }
                 return true;
@@ -282,17 +213,17 @@ namespace laio {
             /// \details For IPv6 the loopback address is: `::1`
             [[nodiscard]] constexpr bool is_loopback() const noexcept {
                 for (uint_fast8_t i = 0; i < 7; ++i) {
-                    if (raw_ipv6_address_.u.Word[i] != 0)
+                    if (segment_(i) != 0)
                         return false;
                 }
-                return raw_ipv6_address_.u.Word[7] == 0x01'00;
+                return segment_(7) == 0x00'01;
             }
 
             /// Return `true` if this address is of the unique local address space
             ///
             /// \details For IPv6 the unique local address space is: `fc00::/7`
             [[nodiscard]] constexpr bool is_unique_local() const noexcept {
-                return (raw_ipv6_address_.u.Word[0] & 0x00'feu) == 0x00'fcu;
+                return (segment_(0) & 0xfe'00u) == 0xfc'00u;
             }
 
             /// Return `true` if this address is of the unicast link-local address space
@@ -300,10 +231,10 @@ namespace laio {
             /// \details This method validates the address as strictly adhering to the format defined in IETF RFC 4291.
             /// For IPv6 the unicast link-local address is strictly defined as: `fe80::/64`
             [[nodiscard]] constexpr bool is_unicast_link_local_strict() const noexcept {
-                return raw_ipv6_address_.u.Word[0] == 0x80'feu
-                    && raw_ipv6_address_.u.Word[1] == 0
-                    && raw_ipv6_address_.u.Word[2] == 0
-                    && raw_ipv6_address_.u.Word[3] == 0;
+                return segment_(0) == 0xfe'80u
+                    && segment_(1) == 0
+                    && segment_(2) == 0
+                    && segment_(3) == 0;
             }
 
             /// Return `true` if this address is of the unicast link-local address space
@@ -311,21 +242,21 @@ namespace laio {
             /// \details This method validates the address as unicast link-local according to common conception as of
             /// the format: `fe80::/10`
             [[nodiscard]] constexpr bool is_unicast_link_local() const noexcept {
-                return (raw_ipv6_address_.u.Word[0] & 0xc0'ff) == 0x80'feu; // NOLINT(hicpp-signed-bitwise)
+                return (segment_(0) & 0xff'c0u) == 0xfe'80u;
             }
 
             /// Return `true` if this address is of the unicast site-local address space
             ///
             /// \details For IPv6 the unicast site-local address space is: `fec0::/10`
             [[nodiscard]] constexpr bool is_unicast_site_local() const noexcept {
-                return (raw_ipv6_address_.u.Word[0] & 0xc0'ff) == 0xc0'feu; // NOLINT(hicpp-signed-bitwise)
+                return (segment_(0) & 0xff'c0u) == 0xfe'c0u;
             }
 
             /// Return `true` if this address is of the range reserved for documentation
             ///
             /// \details For IPv6 this address space is: `2001:db8::/32`
             [[nodiscard]] constexpr bool is_documentation() const noexcept {
-                return raw_ipv6_address_.u.Word[0] == 0x01'20u && raw_ipv6_address_.u.Word[1] == 0xb8'0du;
+                return segment_(0) == 0x20'01u && segment_(1) == 0x0d'b8u;
             }
 
             /// Return `true` if this address is a globally routable unicast address
@@ -367,18 +298,78 @@ namespace laio {
             /// otherwise.
             [[nodiscard]] std::optional<Ipv4Addr> to_ipv4() const noexcept;
 
+        private:
+            /// Return segment in host byte order
+            ///
+            /// \details Reads the bytes rather than the 16-bit words of the structure, as only the bytes are initialized
+            /// by the constructors, and reading another union member is not a constant expression.
+            [[nodiscard]] constexpr uint16_t segment_(std::size_t index) const noexcept {
+                return static_cast<uint16_t>(raw_ipv6_address_.u.Byte[2 * index] << 8u
+                                             | raw_ipv6_address_.u.Byte[2 * index + 1]);
+            }
+
+            /// Convert between network and host byte order
+            static uint64_t byteswap_(uint64_t value) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+                return _byteswap_uint64(value);
+#else
+                return __builtin_bswap64(value);
+#endif
+            }
+
         }; // class Ipv6Addr
 
+        static_assert(sizeof(Ipv6Addr) == sizeof(IN6_ADDR) && std::is_trivially_copyable_v<Ipv6Addr>
+                      && std::is_standard_layout_v<Ipv6Addr>);
+
         namespace ipv6 {
 
-            const Ipv6Addr LOCALHOST{0, 0, 0, 0, 0, 0, 0, 1};   ///< IPv6 localhost address
+            constexpr Ipv6Addr LOCALHOST{0, 0, 0, 0, 0, 0, 0, 1};   ///< IPv6 localhost address
 
-            const Ipv6Addr UNSPECIFIED{0, 0, 0, 0, 0, 0, 0, 0}; ///< IPv6 unspecified address
+            constexpr Ipv6Addr UNSPECIFIED{0, 0, 0, 0, 0, 0, 0, 0}; ///< IPv6 unspecified address
 
         } // namespace ipv6
 
+        namespace literals {
+
+            /// Create IPv6 address from literal, e.g. `constexpr Ipv6Addr server = "2001:db8::1"_ipv6;`
+            ///
+            /// \details The literal is parsed at compile time wherever a constant is required, e.g. to initialize a
+            /// `constexpr` variable, so that malformed literals fail the build. Evaluated at run time, malformed literals
+            /// throw `std::invalid_argument`. Zone identifiers are rejected, as they belong to the socket address.
+            constexpr Ipv6Addr operator""_ipv6(const char* text, std::size_t len) {
+                const std::optional<parser::Ipv6Text> parsed = parser::ipv6_scalar({text, len});
+                if (!parsed || !parsed->zone.empty()) throw std::invalid_argument{"malformed IPv6 address literal"};
+                const parser::Ipv6Octets& o = parsed->octets;
+                return Ipv6Addr{o[0], o[1], o[2], o[3], o[4], o[5], o[6], o[7],
+                                o[8], o[9], o[10], o[11], o[12], o[13], o[14], o[15]};
+            }
+
+        } // namespace literals
+
     } // namespace net
 
 } // namespace laio
 
+namespace fmt {
+
+    template<>
+    struct formatter<laio::net::Ipv6Addr> : laio::net::format::ToCharsFormatter<laio::net::Ipv6Addr> {};
+
+} // namespace fmt
+
+namespace std {
+
+    template<>
+    struct hash<laio::net::Ipv6Addr> {
+        std::size_t operator()(const laio::net::Ipv6Addr& address) const noexcept {
+            const IN6_ADDR raw = address;
+            std::uint64_t halves[2];
+            std::memcpy(halves, raw.u.Byte, sizeof halves);
+            return static_cast<std::size_t>(laio::net::hash::combine(laio::net::hash::mix(halves[0]), halves[1]));
+        }
+    };
+
+} // namespace std
+
 #pragma clang diagnostic pop
\ No newline at end of file
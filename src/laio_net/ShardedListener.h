@@ -0,0 +1,256 @@
+#pragma once
+
+#include <WinSock2.h>
+#include <mstcpip.h>
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "Result.h"
+
+#include "CompletionPort.h"
+#include "Socket.h"
+#include "SocketAddr.h"
+#include "TcpListener.h"
+#include "TcpStream.h"
+#include "traits.h"
+
+namespace laio {
+
+    namespace net {
+
+        /// Processor a connection has been steered to by receive side scaling
+        struct IncomingCpu {
+            unsigned short group;       ///< Processor group
+            unsigned char number;       ///< Processor number within the group
+            unsigned short numa_node;   ///< NUMA node of the processor
+        };
+
+        // Requires declaration to befriend the builder
+        class ShardedListener;
+
+        /// Builder for a set of listeners sharing one local address
+        ///
+        /// \details Each shard is an independent listening socket with its own accept queue, so that each worker can
+        /// accept on its own shard without contending for a single queue.
+        class ShardedListenerBuilder {
+
+            std::size_t shards_ = 0;
+            int backlog_ = SOMAXCONN;
+            bool cpu_affinity_ = false;
+            unsigned short first_cpu_ = 0;
+
+        public:
+            // # Public member functions
+
+            /// Set number of listening sockets, 0 for the default
+            ///
+            /// \details Defaults to one per active processor of the current group from the first pinned processor on,
+            /// if shards are pinned to processors, and to a single shard otherwise. More than one shard requires
+            /// `cpu_affinity`, as the system only balances connections between listeners pinned to processors.
+            ShardedListenerBuilder& shards(std::size_t shards) noexcept {
+                shards_ = shards;
+                return *this;
+            }
+
+            /// Set maximum length of the accept queue of each shard
+            ShardedListenerBuilder& backlog(int backlog) noexcept {
+                backlog_ = backlog;
+                return *this;
+            }
+
+            /// Pin shard `i` to processor `first + i` of the current processor group
+            ///
+            /// \details Uses `SIO_CPU_AFFINITY`, so that the system hands a new connection to the shard whose processor
+            /// receive side scaling has steered the connection to. This keeps the accept and all subsequent completions
+            /// of a connection on the same core. Without affinity, the system does not balance connections between
+            /// listeners sharing a port, so that all connections would end up in the accept queue of a single shard.
+            ///
+            /// \param affinity Pin shards to processors if `true`
+            /// \param first First processor number within the group
+            ShardedListenerBuilder& cpu_affinity(bool affinity, unsigned short first = 0) noexcept {
+                cpu_affinity_ = affinity;
+                first_cpu_ = first;
+                return *this;
+            }
+
+            /// Create all shards and bind them to the provided address
+            ///
+            /// \details If port 0 is requested, the ephemeral port assigned to the first shard is used for all others.
+            /// Only pinned shards share the address, which leaves it open to other sockets, see `ShardedListener`; a
+            /// single shard binds it exclusively. Fails with `WSAEINVAL` if
+            /// more than one shard is requested without processor affinity, or if the pinned processors exceed the
+            /// active processors of the current group.
+            ///
+            /// \param address Local socket address to listen on
+            /// \return Variant with ShardedListener if successful, error type otherwise
+            [[nodiscard]] Result<ShardedListener> bind(SocketAddr address) const noexcept;
+
+        }; // class ShardedListenerBuilder
+
+        /// Set of TCP listeners bound to the same local address
+        ///
+        /// \details Windows counterpart of a `SO_REUSEPORT` listener group: the shards are pinned to processors through
+        /// `SIO_CPU_AFFINITY` and share the address through `SO_REUSEADDR`. Typically, each shard is
+        /// associated with the completion port of the worker running on its processor, and each worker keeps a number
+        /// of accepts outstanding on its own shard only.
+        ///
+        /// Unlike `SO_REUSEPORT`, `SO_REUSEADDR` does not restrict sharing to sockets of the same owner: any other
+        /// socket on the host, which sets `SO_REUSEADDR` as well, may bind the same address while the shards are
+        /// listening and is then handed part of their connections. Use more than one shard only on hosts where all
+        /// processes able to bind the port are trusted, and a single, exclusively bound shard otherwise.
+        class ShardedListener {
+
+            std::vector<TcpListener> shards_;
+
+            friend class ShardedListenerBuilder;
+
+            explicit ShardedListener(std::vector<TcpListener> shards) noexcept
+                : shards_{std::move(shards)} {}
+
+        public:
+            // # Constructors
+            ShardedListener(const ShardedListener& other) = delete;
+
+            ShardedListener(ShardedListener&& other) noexcept = default;
+
+            // # Operator overloads
+            ShardedListener& operator=(const ShardedListener& rhs) = delete;
+
+            ShardedListener& operator=(ShardedListener&& rhs) noexcept = default;
+
+            // # Public member functions
+
+            /// Return number of shards
+            [[nodiscard]] std::size_t size() const noexcept {
+                return shards_.size();
+            }
+
+            /// Borrow shard at the specified index
+            TcpListener& shard(std::size_t index) noexcept {
+                return shards_[index];
+            }
+
+            /// Return local address shared by all shards
+            [[nodiscard]] Result<SocketAddr> local_addr() const noexcept {
+                return shards_.front().local_addr();
+            }
+
+            /// Associate shard at the specified index with a completion port
+            ///
+            /// \param index Index of the shard
+            /// \param port Completion port of the worker serving the shard
+            /// \param token Completion key of accepts completing on this shard
+            /// \return Variant with error type, in case the association has failed
+            Result<std::monostate> associate(std::size_t index, iocp::CompletionPort& port, std::size_t token) noexcept {
+                return port.add_socket(token, shards_[index]);
+            }
+
+            /// Return processor receive side scaling has steered the provided connection to
+            ///
+            /// \details Uses `SIO_QUERY_RSS_PROCESSOR_INFO`, which is only available on adapters with receive side
+            /// scaling enabled; loopback connections report an error.
+            ///
+            /// \param stream Accepted or connected stream
+            /// \return Variant with processor of the connection if successful, error type otherwise
+            static Result<IncomingCpu> incoming_cpu(const TcpStream& stream) noexcept {
+                SOCKET_PROCESSOR_AFFINITY affinity{};
+                DWORD bytes = 0;
+                const int ret = WSAIoctl(
+                        stream.as_raw_socket(),
+                        SIO_QUERY_RSS_PROCESSOR_INFO,
+                        nullptr,
+                        0,
+                        &affinity,
+                        static_cast<DWORD>(sizeof affinity),
+                        &bytes,
+                        nullptr,
+                        nullptr
+                );
+                if (ret == SOCKET_ERROR) {
+                    return Socket::last_error();
+                }
+                return IncomingCpu{affinity.Processor.Group, affinity.Processor.Number, affinity.NumaNodeId};
+            }
+
+        }; // class ShardedListener
+
+        inline Result<ShardedListener> ShardedListenerBuilder::bind(SocketAddr address) const noexcept {
+            // Processor numbers passed to `SIO_CPU_AFFINITY` are relative to the group of the calling thread
+            PROCESSOR_NUMBER current{};
+            GetCurrentProcessorNumberEx(&current);
+            const std::size_t processors = GetActiveProcessorCount(current.Group);
+
+            std::size_t count = shards_;
+            if (count == 0) {
+                count = cpu_affinity_ && first_cpu_ < processors ? processors - first_cpu_ : 1;
+            }
+            if (count > 1 && !cpu_affinity_) {
+                return Error{static_cast<wse::win_errc>(WSAEINVAL)};
+            }
+            if (cpu_affinity_ && first_cpu_ + count > processors) {
+                return Error{static_cast<wse::win_errc>(WSAEINVAL)};
+            }
+            std::vector<TcpListener> listeners{};
+            listeners.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                Result<Socket> socket = Socket::create(address, SOCK_STREAM);
+                if (std::holds_alternative<Error>(socket)) {
+                    return std::get<Error>(socket);
+                }
+                Socket& sock = std::get<Socket>(socket);
+                // Keeps other sockets, including those of other processes, from binding the address of a single shard
+                const int sharing = count > 1 ? SO_REUSEADDR : SO_EXCLUSIVEADDRUSE;
+                if (auto res = sock.set_option<BOOL>(SOL_SOCKET, sharing, TRUE); std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                if (cpu_affinity_) {
+                    USHORT processor = static_cast<USHORT>(first_cpu_ + i);
+                    DWORD bytes = 0;
+                    const int ret = WSAIoctl(
+                            sock.as_raw_socket(),
+                            SIO_CPU_AFFINITY,
+                            &processor,
+                            static_cast<DWORD>(sizeof processor),
+                            nullptr,
+                            0,
+                            &bytes,
+                            nullptr,
+                            nullptr
+                    );
+                    if (ret == SOCKET_ERROR) {
+                        return Socket::last_error();
+                    }
+                }
+                if (auto res = sock.bind(address); std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                if (auto res = sock.listen(backlog_); std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                if (address.port() == 0) {
+                    Result<SocketAddr> local = sock.local_addr();
+                    if (std::holds_alternative<Error>(local)) {
+                        return std::get<Error>(local);
+                    }
+                    address.set_port(std::get<SocketAddr>(local).port());
+                }
+                listeners.emplace_back(std::move(sock));
+            }
+            return ShardedListener{std::move(listeners)};
+        }
+
+    } // namespace net
+
+    namespace trait {
+
+        template<>
+        constexpr bool is_send<net::ShardedListener> = true;
+
+        template<>
+        constexpr bool is_sync<net::ShardedListener> = true;
+
+    } // namespace trait
+
+} // namespace laio
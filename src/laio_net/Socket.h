@@ -2,33 +2,58 @@
 
 #include <winsock2.h>
 
+#include <algorithm>
 #include <chrono>
+#include <climits>
 #include <mutex>
+#include <optional>
 #include <variant>
 
 #include "gsl/span"
+#include "Result.h"
 
 #include "IoSpanMut.h"
 #include "SocketAddr.h"
 
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
-
     namespace net {
 
+        /// Owned Windows socket
+        ///
+        /// \details Wraps a raw Windows socket and enforces ownership semantics. All sockets are created in
+        /// overlapped mode, so that they can be associated with a completion port. Errors reported by Winsock are
+        /// Windows system error codes and are returned as such.
         class Socket {
             SOCKET raw_socket_;
         public:
             // # Constructors
             explicit constexpr Socket(SOCKET socket) noexcept
                 : raw_socket_{std::move(socket)} {} // NOLINT(hicpp-move-const-arg,performance-move-const-arg)
-                
+
+            Socket(const Socket& other) = delete;
+
+            Socket(Socket&& other) noexcept
+                : raw_socket_{other.raw_socket_}
+            {
+                other.raw_socket_ = INVALID_SOCKET;
+            }
+
+            // # Destructor
             ~Socket() noexcept {
-                
-                // TODO: Handle consumption of the object through call to `into_raw_socket`
-                closesocket(raw_socket_);
+                if (raw_socket_ != INVALID_SOCKET) closesocket(raw_socket_);
+            }
+
+            // # Operator overloads
+            Socket& operator=(const Socket& rhs) = delete;
+
+            Socket& operator=(Socket&& rhs) noexcept {
+                if (this != &rhs) {
+                    if (raw_socket_ != INVALID_SOCKET) closesocket(raw_socket_);
+                    raw_socket_ = rhs.raw_socket_;
+                    rhs.raw_socket_ = INVALID_SOCKET;
+                }
+                return *this;
             }
 
             // # Public member functions
@@ -44,11 +69,188 @@ namespace laio {
                 });
             }
 
+            /// Create new overlapped socket for the address family of the provided address
+            ///
+            /// \param address Socket address, which determines the address family
+            /// \param type Socket type, e.g. `SOCK_STREAM` or `SOCK_DGRAM`
+            /// \return Variant with Socket if successful, error type otherwise
             static Result<Socket> create(const SocketAddr& address, const int type) noexcept {
-                
+                return create(address.family(), type);
+            }
+
+            /// Create new overlapped socket for the specified address family
+            ///
+            /// \param family Address family, `AF_INET` or `AF_INET6`
+            /// \param type Socket type, e.g. `SOCK_STREAM` or `SOCK_DGRAM`
+            /// \return Variant with Socket if successful, error type otherwise
+            static Result<Socket> create(const int family, const int type) noexcept {
+                init();
+                SOCKET ret = WSASocketW(
+                        family,
+                        type,
+                        0,
+                        nullptr,
+                        0,
+                        WSA_FLAG_OVERLAPPED | WSA_FLAG_NO_HANDLE_INHERIT
+                );
+                if (ret == INVALID_SOCKET) {
+                    return last_error();
+                }
+                return Socket{ret};
+            }
+
+            /// Return error of the last failed Winsock call on this thread
+            static Error last_error() noexcept {
+                return Error{static_cast<wse::win_errc>(WSAGetLastError())};
+            }
+
+            /// Borrow raw Windows socket
+            ///
+            /// \details Callee retains ownership over the socket and no manual clean-up is required!
+            [[nodiscard]] SOCKET as_raw_socket() const noexcept {
+                return raw_socket_;
+            }
+
+            /// Extract raw Windows socket and consume wrapper
+            ///
+            /// \details Caller takes ownership over the socket and must clean-up manually!
+            SOCKET into_raw_socket() && noexcept {
+                SOCKET temp = raw_socket_;
+                raw_socket_ = INVALID_SOCKET;
+                return temp;
+            }
+
+            /// Bind this socket to the provided address
+            ///
+            /// \param address Local socket address
+            /// \return Variant with error type, in case the binding has failed
+            Result<std::monostate> bind(const SocketAddr& address) noexcept {
+                auto [addr, len] = address.as_raw();
+                if (::bind(raw_socket_, addr, len) == SOCKET_ERROR) {
+                    return last_error();
+                }
+                return std::monostate{};
+            }
+
+            /// Start listening for incoming connections on this socket
+            ///
+            /// \param backlog Maximum length of the queue of pending connections
+            /// \return Variant with error type, in case the socket cannot listen
+            Result<std::monostate> listen(int backlog) noexcept {
+                if (::listen(raw_socket_, backlog) == SOCKET_ERROR) {
+                    return last_error();
+                }
+                return std::monostate{};
+            }
+
+            /// Set socket option
+            ///
+            /// \param level Level at which the option is defined, e.g. `SOL_SOCKET`
+            /// \param name Option to set, e.g. `SO_REUSEADDR`
+            /// \param value New value of the option
+            /// \return Variant with error type, in case the option cannot be set
+            template<typename T>
+            Result<std::monostate> set_option(int level, int name, const T& value) noexcept {
+                const int ret = setsockopt(
+                        raw_socket_,
+                        level,
+                        name,
+                        reinterpret_cast<const char*>(&value),
+                        static_cast<int>(sizeof value)
+                );
+                if (ret == SOCKET_ERROR) {
+                    return last_error();
+                }
+                return std::monostate{};
+            }
+
+            /// Retrieve socket option
+            ///
+            /// \param level Level at which the option is defined, e.g. `SOL_SOCKET`
+            /// \param name Option to retrieve, e.g. `SO_ERROR`
+            /// \return Variant with current value of the option, error type otherwise
+            template<typename T>
+            Result<T> option(int level, int name) const noexcept {
+                T value{};
+                int len = static_cast<int>(sizeof value);
+                if (getsockopt(raw_socket_, level, name, reinterpret_cast<char*>(&value), &len) == SOCKET_ERROR) {
+                    return last_error();
+                }
+                return value;
             }
 
-            Result<std::monostate> connect_timeout(const SocketAddr& addr, const std::chrono::nanoseconds timeout) noexcept;
+            /// Return local address this socket is bound to
+            ///
+            /// \return Variant with local socket address if successful, error type otherwise
+            [[nodiscard]] Result<SocketAddr> local_addr() const noexcept {
+                SOCKADDR_STORAGE storage{};
+                int len = static_cast<int>(sizeof storage);
+                if (getsockname(raw_socket_, reinterpret_cast<SOCKADDR*>(&storage), &len) == SOCKET_ERROR) {
+                    return last_error();
+                }
+                return into_addr_(storage, len);
+            }
+
+            /// Return remote address this socket is connected to
+            ///
+            /// \return Variant with remote socket address if successful, error type otherwise
+            [[nodiscard]] Result<SocketAddr> peer_addr() const noexcept {
+                SOCKADDR_STORAGE storage{};
+                int len = static_cast<int>(sizeof storage);
+                if (getpeername(raw_socket_, reinterpret_cast<SOCKADDR*>(&storage), &len) == SOCKET_ERROR) {
+                    return last_error();
+                }
+                return into_addr_(storage, len);
+            }
+
+            /// Retrieve and clear pending error on this socket
+            ///
+            /// \return Variant with pending error if any, error type if the retrieval itself has failed
+            [[nodiscard]] Result<std::optional<Error>> take_error() const noexcept {
+                Result<int> res = option<int>(SOL_SOCKET, SO_ERROR);
+                if (std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                const int err = std::get<int>(res);
+                if (err == 0) {
+                    return std::nullopt;
+                }
+                return std::optional{Error{static_cast<wse::win_errc>(err)}};
+            }
+
+            /// Move this socket in or out of non-blocking mode
+            ///
+            /// \param nonblocking Non-blocking mode if `true`
+            /// \return Variant with error type, in case the mode cannot be changed
+            Result<std::monostate> set_nonblocking(bool nonblocking) noexcept {
+                u_long mode = nonblocking ? 1 : 0;
+                if (ioctlsocket(raw_socket_, FIONBIO, &mode) == SOCKET_ERROR) {
+                    return last_error();
+                }
+                return std::monostate{};
+            }
+
+            /// Connect this socket to the provided address, failing if the connection is not established in time
+            ///
+            /// \details Temporarily moves the socket into non-blocking mode, initiates the connection and waits for it
+            /// to become writable. Modelled after `Socket::connect_timeout` in the Rust Standard Library.
+            ///
+            /// \param addr Remote socket address
+            /// \param timeout Maximum duration to wait for the connection, must not be zero
+            /// \return Variant with error type, in case the connection has failed or timed out
+            Result<std::monostate> connect_timeout(const SocketAddr& addr, const std::chrono::nanoseconds timeout) noexcept {
+                if (timeout <= std::chrono::nanoseconds::zero()) {
+                    return Error{static_cast<wse::win_errc>(WSAEINVAL)};
+                }
+                if (auto res = set_nonblocking(true); std::holds_alternative<Error>(res)) {
+                    return res;
+                }
+                Result<std::monostate> ret = connect_nonblocking_(addr, timeout);
+                if (auto res = set_nonblocking(false); std::holds_alternative<Error>(res)) {
+                    return res;
+                }
+                return ret;
+            }
 
             Result<Socket> accept(SOCKADDR* storage, int len) noexcept;
 
@@ -59,8 +261,56 @@ namespace laio {
             Result<std::size_t> read(gsl::span<unsigned char> buf) noexcept;
 
             Result<std::size_t> read_vectored(gsl::span<IoSpanMut> buf) noexcept;
+
+        private:
+            /// Initiate connection on non-blocking socket and wait until it is established or the timeout elapses
+            Result<std::monostate> connect_nonblocking_(const SocketAddr& addr, const std::chrono::nanoseconds timeout) noexcept {
+                auto [raw, len] = addr.as_raw();
+                if (::connect(raw_socket_, raw, len) != SOCKET_ERROR) {
+                    return std::monostate{};
+                }
+                if (WSAGetLastError() != WSAEWOULDBLOCK) {
+                    return last_error();
+                }
+
+                // Round up, so that sub-microsecond timeouts do not turn into a non-blocking poll
+                const auto micros = std::chrono::ceil<std::chrono::microseconds>(timeout).count();
+                TIMEVAL time{};
+                time.tv_sec = static_cast<long>((std::min)(micros / 1'000'000, static_cast<long long>(LONG_MAX)));
+                time.tv_usec = static_cast<long>(micros % 1'000'000);
+                fd_set writable{};
+                FD_SET(raw_socket_, &writable);
+                fd_set failed{};
+                FD_SET(raw_socket_, &failed);
+                const int ret = select(1, nullptr, &writable, &failed, &time);
+                if (ret == SOCKET_ERROR) {
+                    return last_error();
+                }
+                if (ret == 0) {
+                    return Error{static_cast<wse::win_errc>(WSAETIMEDOUT)};
+                }
+                if (FD_ISSET(raw_socket_, &failed)) {
+                    Result<std::optional<Error>> pending = take_error();
+                    if (std::holds_alternative<Error>(pending)) {
+                        return std::get<Error>(pending);
+                    }
+                    if (auto err = std::get<std::optional<Error>>(pending)) {
+                        return *err;
+                    }
+                }
+                return std::monostate{};
+            }
+
+            /// Convert address storage filled in by the system into a socket address
+            static Result<SocketAddr> into_addr_(const SOCKADDR_STORAGE& storage, int len) noexcept {
+                std::optional<SocketAddr> address = SocketAddr::from_raw(reinterpret_cast<const SOCKADDR*>(&storage), len);
+                if (!address) {
+                    return Error{static_cast<wse::win_errc>(WSAEAFNOSUPPORT)};
+                }
+                return *address;
+            }
         };
 
     } // namespace net
 
-} // namespace laio
\ No newline at end of file
+} // namespace laio
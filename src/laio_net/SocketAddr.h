@@ -1,32 +1,244 @@
 #pragma once
 
+#include <WinSock2.h>
+
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <variant>
 
-#include "win_error.h"
+#include "gsl/span"
+#include "Result.h"
 
+#include "IpAddr.h"
 #include "SocketAddrV4.h"
 #include "SocketAddrV6.h"
 
-// Symbol defined as __STRUCT__ in <combaseapi.h>
-#ifdef interface
-    #undef interface
-#endif
-
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, wse::win_error>;
+    namespace net {
 
-    namespace net::interface {
+        /// Outcome of parsing a list of socket addresses
+        struct SocketAddrList {
+            std::size_t count;          ///< Number of addresses written to the output
+            std::string_view rest;      ///< Text from the first entry that has not been parsed, empty if all have been
+        };
 
-        /// Socket address interface, implemented either for IpV4 or IpV6 address types
+        /// Socket address of either IP version
         ///
-        ///
-        template<typename Derived>
-        struct SocketAddr {
+        /// \details In the Rust Standard Library this is an enum over both versions of socket addresses. Sockets are
+        /// created and bound through this type, as the address family is only known at runtime. Both Windows
+        /// structures begin with their address family, which serves as the tag of a union that is exactly as large as
+        /// the IPv6 structure and trivially copyable.
+        class SocketAddr {
 
-        };
+            union {
+                SOCKADDR_IN v4_;            ///< IPv4 socket address, if the family is `AF_INET`
+                SOCKADDR_IN6 v6_;           ///< IPv6 socket address, if the family is `AF_INET6`
+            };
+
+        public:
+            static constexpr std::size_t MAX_STR_LEN = SocketAddrV6::MAX_STR_LEN;     ///< Length of longest address text
+
+            // # Constructors
+
+            /// Create unspecified IPv4 socket address `0.0.0.0:0`, e.g. to be overwritten by a parser
+            SocketAddr() noexcept
+                : v4_{} {
+                v4_.sin_family = AF_INET;
+            }
+
+            SocketAddr(SocketAddrV4 socketAddrV4) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+                : v4_{static_cast<SOCKADDR_IN>(socketAddrV4)} {}
+
+            SocketAddr(SocketAddrV6 socketAddrV6) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+                : v6_{static_cast<SOCKADDR_IN6>(socketAddrV6)} {}
+
+            // # Operator overloads
+            explicit operator std::string() const {
+                char buf[MAX_STR_LEN];
+                return std::string{buf, to_chars(buf, buf + sizeof buf).ptr};
+            }
+
+            bool operator==(const SocketAddr& rhs) const noexcept {
+                if (is_ipv4() != rhs.is_ipv4()) return false;
+                return is_ipv4() ? SocketAddrV4{v4_} == SocketAddrV4{rhs.v4_} : SocketAddrV6{v6_} == SocketAddrV6{rhs.v6_};
+            }
+
+            // # Public member functions
+
+            /// Parse socket address of either version from string
+            ///
+            /// \details The version is told by the first character, as only IPv6 addresses are written in brackets.
+            /// Allocates nothing.
+            ///
+            /// \param socketAddress Socket address text, e.g. `192.168.0.1:8080` or `[fe80::1%3]:8080`
+            /// \return Socket address if the text is well-formed, `std::nullopt` otherwise
+            static std::optional<SocketAddr> from(std::string_view socketAddress) noexcept {
+                if (!socketAddress.empty() && socketAddress[0] == '[') {
+                    if (std::optional<SocketAddrV6> v6 = SocketAddrV6::from(socketAddress)) return *v6;
+                    return std::nullopt;
+                }
+                if (std::optional<SocketAddrV4> v4 = SocketAddrV4::from(socketAddress)) return *v4;
+                return std::nullopt;
+            }
+
+            /// Parse list of socket addresses separated by commas or whitespace
+            ///
+            /// \details Meant for long lists of endpoints in configuration files. Entries are parsed in place and
+            /// written to the output without allocating. Parsing stops at the first malformed entry, or once the output
+            /// is full.
+            ///
+            /// \param text List text, e.g. `10.0.0.1:80, 10.0.0.2:80 [2001:db8::1]:80`
+            /// \param addresses Output of the parsed addresses
+            /// \return Number of parsed addresses, and the rest of the text from the entry that could not be parsed or
+            /// did not fit into the output
+            static SocketAddrList from_list(std::string_view text, gsl::span<SocketAddr> addresses) noexcept {
+                const auto separator = [](char c) {
+                    return c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+                };
+                std::size_t count = 0;
+                std::size_t pos = 0;
+                while (true) {
+                    while (pos < text.size() && separator(text[pos])) ++pos;
+                    if (pos == text.size()) return {count, {}};
+                    std::size_t end = pos;
+                    while (end < text.size() && !separator(text[end])) ++end;
+                    std::optional<SocketAddr> address{};
+                    if (count < static_cast<std::size_t>(addresses.size())) address = from(text.substr(pos, end - pos));
+                    if (!address) return {count, text.substr(pos)};
+                    addresses[count++] = *address;
+                    pos = end;
+                }
+            }
+
+            /// Convert raw Windows socket address structure into a socket address
+            ///
+            /// \param address Pointer to generic socket address structure, e.g. filled in by `getsockname`
+            /// \param len Length of the structure in bytes
+            /// \return Socket address if the structure holds an IPv4 or IPv6 address, `std::nullopt` otherwise
+            static std::optional<SocketAddr> from_raw(const SOCKADDR* address, int len) noexcept {
+                if (address == nullptr) {
+                    return std::nullopt;
+                }
+                switch (address->sa_family) {
+                    case AF_INET:
+                        if (len < static_cast<int>(sizeof(SOCKADDR_IN))) return std::nullopt;
+                        return SocketAddr{SocketAddrV4{*reinterpret_cast<const SOCKADDR_IN*>(address)}};
+                    case AF_INET6:
+                        if (len < static_cast<int>(sizeof(SOCKADDR_IN6))) return std::nullopt;
+                        return SocketAddr{SocketAddrV6{*reinterpret_cast<const SOCKADDR_IN6*>(address)}};
+                    default:
+                        return std::nullopt;
+                }
+            }
+
+            /// Borrow raw Windows socket address structure
+            ///
+            /// \return Tuple with pointer to the generic socket address structure and its length in bytes
+            [[nodiscard]] std::tuple<const SOCKADDR*, int> as_raw() const noexcept {
+                if (is_ipv4()) return {reinterpret_cast<const SOCKADDR*>(&v4_), static_cast<int>(sizeof v4_)};
+                return {reinterpret_cast<const SOCKADDR*>(&v6_), static_cast<int>(sizeof v6_)};
+            }
+
+            /// Format socket address into a character buffer
+            ///
+            /// \details Writes no more than `MAX_STR_LEN` characters and allocates nothing. The output is not
+            /// null-terminated.
+            ///
+            /// \param first Start of output
+            /// \param last End of output
+            /// \return Result with end of the written text, or `std::errc::value_too_large` if the output is too small
+            std::to_chars_result to_chars(char* first, char* last) const noexcept {
+                if (is_ipv4()) return SocketAddrV4{v4_}.to_chars(first, last);
+                return SocketAddrV6{v6_}.to_chars(first, last);
+            }
+
+            /// Return IP address of this socket address
+            [[nodiscard]] IpAddr ip() const noexcept {
+                if (is_ipv4()) return Ipv4Addr{v4_.sin_addr};
+                return Ipv6Addr{v6_.sin6_addr};
+            }
+
+            /// Return address family of this socket address (`AF_INET` or `AF_INET6`)
+            [[nodiscard]] int family() const noexcept {
+                return is_ipv4() ? AF_INET : AF_INET6;
+            }
+
+            /// Return port number of this socket address
+            [[nodiscard]] uint16_t port() const noexcept {
+                return is_ipv4() ? SocketAddrV4{v4_}.port() : SocketAddrV6{v6_}.port();
+            }
+
+            /// Change port number of this socket address
+            ///
+            /// \param port Port number associated with this socket address
+            void set_port(uint16_t port) noexcept {
+                if (is_ipv4()) {
+                    SocketAddrV4 address{v4_};
+                    address.set_port(port);
+                    v4_ = address;
+                } else {
+                    SocketAddrV6 address{v6_};
+                    address.set_port(port);
+                    v6_ = address;
+                }
+            }
+
+            /// Return `true` if this is an IPv4 socket address
+            ///
+            /// \details The family is read through the IPv4 structure, as it is part of the common initial sequence of
+            /// both structures.
+            [[nodiscard]] bool is_ipv4() const noexcept {
+                return v4_.sin_family == AF_INET;
+            }
+
+            /// Return `true` if this is an IPv6 socket address
+            [[nodiscard]] bool is_ipv6() const noexcept {
+                return v4_.sin_family == AF_INET6;
+            }
+
+            /// Return IPv4 socket address if this is one
+            [[nodiscard]] std::optional<SocketAddrV4> as_v4() const noexcept {
+                if (is_ipv4()) return SocketAddrV4{v4_};
+                return std::nullopt;
+            }
+
+            /// Return IPv6 socket address if this is one
+            [[nodiscard]] std::optional<SocketAddrV6> as_v6() const noexcept {
+                if (is_ipv6()) return SocketAddrV6{v6_};
+                return std::nullopt;
+            }
+
+        }; // class SocketAddr
+
+        static_assert(sizeof(SocketAddr) == sizeof(SOCKADDR_IN6) && std::is_trivially_copyable_v<SocketAddr>
+                      && std::is_standard_layout_v<SocketAddr>);
+
+    } // namespace net
+
+} // namespace laio
+
+namespace fmt {
+
+    template<>
+    struct formatter<laio::net::SocketAddr> : laio::net::format::ToCharsFormatter<laio::net::SocketAddr> {};
+
+} // namespace fmt
+
+namespace std {
 
-    }
+    template<>
+    struct hash<laio::net::SocketAddr> {
+        std::size_t operator()(const laio::net::SocketAddr& address) const noexcept {
+            if (std::optional<laio::net::SocketAddrV4> v4 = address.as_v4()) return hash<laio::net::SocketAddrV4>{}(*v4);
+            return hash<laio::net::SocketAddrV6>{}(*address.as_v6());
+        }
+    };
 
-} // namespace laio::net
\ No newline at end of file
+} // namespace std
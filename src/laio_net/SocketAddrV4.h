@@ -2,51 +2,52 @@
 
 #include <winsock2.h>
 
+#include <charconv>
 #include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <variant>
 
 #include "fmt/format.h"
-#include "win_error.h"
+#include "Result.h"
 
+#include "Format.h"
+#include "Hash.h"
 #include "Ipv4Addr.h"
+#include "Parser.h"
 
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, wse::win_error>;
-
     namespace net {
 
         /// IPv4 socket address implementation
         ///
         /// \details IPv4 socket address consisting of an IPv4 address, and a 16-bit port number. This implementation
-        /// assumes a host system with little-endian byte order.
+        /// assumes a host system with little-endian byte order. The class is exactly as large as the Windows structure
+        /// and trivially copyable.
         class SocketAddrV4 {
 
             SOCKADDR_IN inner_{};    ///< Windows IPv4 socket address structure
 
         public:
+            /// Length of longest address text: address, colon and port
+            static constexpr std::size_t MAX_STR_LEN = Ipv4Addr::MAX_STR_LEN + 6;
+
             // # Constructors
             constexpr SocketAddrV4() noexcept = default;
 
             constexpr SocketAddrV4(SOCKADDR_IN socketAddrV4) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
                 : inner_{std::move(socketAddrV4)} {} // NOLINT(hicpp-move-const-arg,performance-move-const-arg)
 
-            SocketAddrV4(const SocketAddrV4& other) noexcept = default;
-
-            SocketAddrV4(SocketAddrV4&& other) noexcept
-                : inner_{std::move(other.inner_)} // NOLINT(hicpp-move-const-arg,performance-move-const-arg)
-            {
-                other.inner_.sin_family = 0;
-                other.inner_.sin_port = 0;
-                other.inner_.sin_addr.S_un.S_addr = 0;
-                for (char& elem: other.inner_.sin_zero) {
-                    elem = 0;
-                }
-            }
+            constexpr SocketAddrV4(const SocketAddrV4& other) noexcept = default;
 
-            explicit SocketAddrV4(const Ipv4Addr& ip, uint16_t port) noexcept
+            explicit constexpr SocketAddrV4(const Ipv4Addr& ip, uint16_t port) noexcept
                 : inner_{AF_INET, static_cast<u_short>((port >> 8u) | (port << 8u)), ip, {0}} {} // NOLINT(hicpp-signed-bitwise)
 
             // # Operator overloads
@@ -54,8 +55,9 @@ namespace laio {
                 return inner_;
             }
 
-            explicit operator std::string() const noexcept {
-                return fmt::format("{}:{}", ip(), port());
+            explicit operator std::string() const {
+                char buf[MAX_STR_LEN];
+                return std::string{buf, to_chars(buf, buf + sizeof buf).ptr};
             }
 
             bool operator==(const SocketAddrV4& rhs) const noexcept {
@@ -65,8 +67,47 @@ namespace laio {
 
             // # Public member functions
 
+            /// Parse socket address from string
+            ///
+            /// \details Allocates nothing. The address is parsed by `Ipv4Addr::from`.
+            ///
+            /// \param socketAddress Socket address text, e.g. `192.168.0.1:8080`
+            /// \return IPv4 socket address if the text is well-formed, `std::nullopt` otherwise
+            static std::optional<SocketAddrV4> from(std::string_view socketAddress) noexcept {
+                const std::size_t colon = socketAddress.find(':');
+                if (colon == std::string_view::npos) return std::nullopt;
+                std::optional<Ipv4Addr> ip = Ipv4Addr::from(socketAddress.substr(0, colon));
+                std::optional<uint16_t> port = parser::port(socketAddress.substr(colon + 1));
+                if (!ip || !port) return std::nullopt;
+                return SocketAddrV4{*ip, *port};
+            }
+
+            /// Borrow raw Windows socket address structure
+            ///
+            /// \return Tuple with pointer to the generic socket address structure and its length in bytes
+            [[nodiscard]] std::tuple<const SOCKADDR*, int> as_raw() const noexcept {
+                return {reinterpret_cast<const SOCKADDR*>(&inner_), static_cast<int>(sizeof inner_)};
+            }
+
+            /// Format socket address as `ip:port` into a character buffer
+            ///
+            /// \details Writes no more than `MAX_STR_LEN` characters and allocates nothing. The output is not
+            /// null-terminated.
+            ///
+            /// \param first Start of output
+            /// \param last End of output
+            /// \return Result with end of the written text, or `std::errc::value_too_large` if the output is too small
+            std::to_chars_result to_chars(char* first, char* last) const noexcept {
+                char buf[32];
+                auto [a, b, c, d] = ip().octets();
+                char* end = format::ipv4(buf, a, b, c, d);
+                *end++ = ':';
+                end = format::decimal(end, port());
+                return format::copy(first, last, buf, end);
+            }
+
             /// Return IP address of this socket address
-            [[nodiscard]] Ipv4Addr ip() const noexcept {
+            [[nodiscard]] constexpr Ipv4Addr ip() const noexcept {
                 return inner_.sin_addr;
             }
 
@@ -78,7 +119,7 @@ namespace laio {
             }
 
             /// Return port number of this socket address
-            [[nodiscard]] uint16_t port() const noexcept {
+            [[nodiscard]] constexpr uint16_t port() const noexcept {
                 uint16_t port = inner_.sin_port;
                 return (port << 8u | port >> 8u); // NOLINT(hicpp-signed-bitwise)
             }
@@ -92,6 +133,47 @@ namespace laio {
 
         }; // class SocketAddrV4
 
+        static_assert(sizeof(SocketAddrV4) == sizeof(SOCKADDR_IN) && std::is_trivially_copyable_v<SocketAddrV4>
+                      && std::is_standard_layout_v<SocketAddrV4>);
+
+        namespace literals {
+
+            /// Create IPv4 socket address from literal, e.g. `constexpr SocketAddrV4 web = "127.0.0.1:80"_sockv4;`
+            ///
+            /// \details The literal is parsed at compile time wherever a constant is required, e.g. to initialize a
+            /// `constexpr` variable, so that malformed literals fail the build. Evaluated at run time, malformed literals
+            /// throw `std::invalid_argument`.
+            constexpr SocketAddrV4 operator""_sockv4(const char* text, std::size_t len) {
+                const std::string_view address{text, len};
+                const std::size_t colon = address.rfind(':');
+                if (colon == std::string_view::npos) throw std::invalid_argument{"IPv4 socket address literal without port"};
+                const std::optional<parser::Ipv4Octets> octets = parser::ipv4_scalar(address.substr(0, colon));
+                const std::optional<uint16_t> port = parser::port(address.substr(colon + 1));
+                if (!octets || !port) throw std::invalid_argument{"malformed IPv4 socket address literal"};
+                return SocketAddrV4{Ipv4Addr{(*octets)[0], (*octets)[1], (*octets)[2], (*octets)[3]}, *port};
+            }
+
+        } // namespace literals
+
     } // namespace net
 
-} // namespace laio
\ No newline at end of file
+} // namespace laio
+
+namespace fmt {
+
+    template<>
+    struct formatter<laio::net::SocketAddrV4> : laio::net::format::ToCharsFormatter<laio::net::SocketAddrV4> {};
+
+} // namespace fmt
+
+namespace std {
+
+    template<>
+    struct hash<laio::net::SocketAddrV4> {
+        std::size_t operator()(const laio::net::SocketAddrV4& address) const noexcept {
+            const std::uint64_t bits = static_cast<std::uint64_t>(address.ip().to_bits()) << 16u | address.port();
+            return static_cast<std::size_t>(laio::net::hash::mix(bits));
+        }
+    };
+
+} // namespace std
\ No newline at end of file
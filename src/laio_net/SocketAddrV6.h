@@ -2,12 +2,22 @@
 
 #include <ws2tcpip.h>
 
+#include <charconv>
 #include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <variant>
 
 #include "fmt/format.h"
 
+#include "Format.h"
+#include "Hash.h"
 #include "Ipv6Addr.h"
+#include "Parser.h"
 
 namespace laio {
 
@@ -18,32 +28,23 @@ namespace laio {
         /// IPv6 socket address implementation
         ///
         /// \details IPv6 socket address consisting of an IPv6 address, a 16-bit port number, the traffic class, flow
-        /// label, and a scope identifier. This implementation assumes a host system with little-endian byte order.
+        /// label, and a scope identifier. This implementation assumes a host system with little-endian byte order. The
+        /// class is exactly as large as the Windows structure and trivially copyable.
         class SocketAddrV6 {
 
             SOCKADDR_IN6 inner_{};    ///< Windows IPv6 socket address structure
 
         public:
+            /// Length of longest address text: brackets, address, zone, colon and port
+            static constexpr std::size_t MAX_STR_LEN = Ipv6Addr::MAX_STR_LEN + 19;
+
             // # Constructors
             constexpr SocketAddrV6() noexcept = default;
 
             constexpr SocketAddrV6(SOCKADDR_IN6 socketAddrV6) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
                 : inner_{std::move(socketAddrV6)} {} // NOLINT(hicpp-move-const-arg,performance-move-const-arg)
 
-            SocketAddrV6(const SocketAddrV6& other) noexcept = default;
-
-            SocketAddrV6(SocketAddrV6&& other) noexcept
-                : inner_{std::move(other.inner_)} // NOLINT(hicpp-move-const-arg,performance-move-const-arg)
-            {
-                other.inner_.sin6_family = 0;
-                other.inner_.sin6_port = 0;
-                other.inner_.sin6_flowinfo = 0;
-                for (uint16_t& elem: other.inner_.sin6_addr.u.Word) {
-                    elem = 0;
-                }
-                other.inner_.sin6_scope_id = 0;
-
-            }
+            constexpr SocketAddrV6(const SocketAddrV6& other) noexcept = default;
 
             explicit SocketAddrV6(const Ipv6Addr& ip, uint16_t port, uint32_t flowInfo, uint32_t scopeId) noexcept
                 : inner_{AF_INET6, static_cast<uint16_t>((port << 8u) | (port >> 8u)), flowInfo, ip, {scopeId}} {} // NOLINT(hicpp-signed-bitwise)
@@ -53,17 +54,74 @@ namespace laio {
                 return inner_;
             }
 
-            explicit operator std::string() const noexcept {
-                return fmt::format("[{}]:{}", ip(), port());
+            explicit operator std::string() const {
+                char buf[MAX_STR_LEN];
+                return std::string{buf, to_chars(buf, buf + sizeof buf).ptr};
             }
 
             bool operator==(const SocketAddrV6& rhs) const noexcept {
                 return inner_.sin6_port == rhs.inner_.sin6_port
-                    && inner_.sin6_addr.u.Word == rhs.inner_.sin6_addr.u.Word;
+                    && inner_.sin6_flowinfo == rhs.inner_.sin6_flowinfo
+                    && inner_.sin6_scope_id == rhs.inner_.sin6_scope_id
+                    && ip() == rhs.ip();
             }
 
             // # Public member functions
 
+            /// Parse socket address from string
+            ///
+            /// \details Accepts the address in brackets, optionally followed by a zone within the brackets, and the
+            /// port, as written by `to_chars`. The zone must be a numeric scope identifier, as resolving interface
+            /// names would query the system. Allocates nothing.
+            ///
+            /// \param socketAddress Socket address text, e.g. `[2001:db8::1]:443` or `[fe80::1%3]:8080`
+            /// \return IPv6 socket address if the text is well-formed, `std::nullopt` otherwise
+            static std::optional<SocketAddrV6> from(std::string_view socketAddress) noexcept {
+                const std::size_t close = socketAddress.find(']');
+                if (socketAddress.empty() || socketAddress[0] != '[' || close == std::string_view::npos
+                    || close + 1 == socketAddress.size() || socketAddress[close + 1] != ':') return std::nullopt;
+                std::optional<parser::Ipv6Text> parsed = parser::ipv6(socketAddress.substr(1, close - 1));
+                std::optional<uint16_t> port = parser::port(socketAddress.substr(close + 2));
+                if (!parsed || !port) return std::nullopt;
+                std::optional<uint32_t> scopeId = parsed->zone.empty() ? std::optional<uint32_t>{0} : parser::scope_id(parsed->zone);
+                if (!scopeId) return std::nullopt;
+                const parser::Ipv6Octets& o = parsed->octets;
+                const Ipv6Addr ip{o[0], o[1], o[2], o[3], o[4], o[5], o[6], o[7],
+                                  o[8], o[9], o[10], o[11], o[12], o[13], o[14], o[15]};
+                return SocketAddrV6{ip, *port, 0, *scopeId};
+            }
+
+            /// Borrow raw Windows socket address structure
+            ///
+            /// \return Tuple with pointer to the generic socket address structure and its length in bytes
+            [[nodiscard]] std::tuple<const SOCKADDR*, int> as_raw() const noexcept {
+                return {reinterpret_cast<const SOCKADDR*>(&inner_), static_cast<int>(sizeof inner_)};
+            }
+
+            /// Format socket address as `[ip]:port`, or `[ip%scope]:port` if the scope is set, into a character buffer
+            ///
+            /// \details Writes no more than `MAX_STR_LEN` characters and allocates nothing. The output is not
+            /// null-terminated.
+            ///
+            /// \param first Start of output
+            /// \param last End of output
+            /// \return Result with end of the written text, or `std::errc::value_too_large` if the output is too small
+            std::to_chars_result to_chars(char* first, char* last) const noexcept {
+                char buf[64];
+                auto [a, b, c, d, e, f, g, h] = ip().segments();
+                const uint16_t groups[8] = {a, b, c, d, e, f, g, h};
+                buf[0] = '[';
+                char* end = format::ipv6(buf + 1, groups);
+                if (scope_id()) {
+                    *end++ = '%';
+                    end = format::decimal(end, scope_id());
+                }
+                *end++ = ']';
+                *end++ = ':';
+                end = format::decimal(end, port());
+                return format::copy(first, last, buf, end);
+            }
+
             [[nodiscard]] Ipv6Addr ip() const noexcept {
                 return inner_.sin6_addr;
             }
@@ -85,8 +143,8 @@ namespace laio {
                 return inner_.sin6_flowinfo;
             }
 
-            void flow_info(uint32_t flowInfo) noexcept {
-                inner_.sin6_port = flowInfo;
+            void set_flow_info(uint32_t flowInfo) noexcept {
+                inner_.sin6_flowinfo = flowInfo;
             }
 
             [[nodiscard]] uint32_t scope_id() const noexcept {
@@ -99,6 +157,28 @@ namespace laio {
 
         }; // class SocketAddrV6
 
+        static_assert(sizeof(SocketAddrV6) == sizeof(SOCKADDR_IN6) && std::is_trivially_copyable_v<SocketAddrV6>
+                      && std::is_standard_layout_v<SocketAddrV6>);
+
     }
 
-} // namespace laio
\ No newline at end of file
+} // namespace laio
+
+namespace fmt {
+
+    template<>
+    struct formatter<laio::net::SocketAddrV6> : laio::net::format::ToCharsFormatter<laio::net::SocketAddrV6> {};
+
+} // namespace fmt
+
+namespace std {
+
+    template<>
+    struct hash<laio::net::SocketAddrV6> {
+        std::size_t operator()(const laio::net::SocketAddrV6& address) const noexcept {
+            const std::uint64_t bits = static_cast<std::uint64_t>(address.scope_id()) << 16u | address.port();
+            return static_cast<std::size_t>(laio::net::hash::combine(hash<laio::net::Ipv6Addr>{}(address.ip()), bits));
+        }
+    };
+
+} // namespace std
\ No newline at end of file
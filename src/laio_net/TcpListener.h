@@ -1,128 +1,260 @@
 #pragma once
 
+#include <WinSock2.h>
+#include <MSWSock.h>
+
+#include <tuple>
 #include <variant>
 
+#include "Result.h"
+
+#include "AcceptAddr.h"
+#include "AcceptAddrBuf.h"
+#include "Instrument.h"
+#include "Socket.h"
+#include "SocketAddr.h"
 #include "TcpListenerExt.h"
+#include "TcpStream.h"
+#include "WsaExtension.h"
 #include "traits.h"
 
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
-
     namespace net {
 
-    class TcpListener : public interface::TcpListenerExt {
-
-//            ////////////////////////////////////////////////////////////////////////////////
-//            // TCP listeners
-//            ////////////////////////////////////////////////////////////////////////////////
-//
-//                        pub struct TcpListener {
-//                            inner: Socket,
-//                        }
-//
-//                                impl TcpListener {
-//                            pub fn bind(addr: io::Result<&SocketAddr>) -> io::Result<TcpListener> {
-//                                    let addr = addr?;
-//
-//                                    init();
-//
-//                                    let sock = Socket::new(addr, c::SOCK_STREAM)?;
-//
-//                                    // On platforms with Berkeley-derived sockets, this allows
-//                                    // to quickly rebind a socket, without needing to wait for
-//                                    // the OS to clean up the previous one.
-//                                    if !cfg!(windows) {
-//                                        setsockopt(&sock, c::SOL_SOCKET, c::SO_REUSEADDR,
-//                                                1 as c_int)?;
-//                                    }
-//
-//                                    // Bind our new socket
-//                                    let (addrp, len) = addr.into_inner();
-//                                    cvt(unsafe { c::bind(*sock.as_inner(), addrp, len as _) })?;
-//
-//                                    // Start listening
-//                                    cvt(unsafe { c::listen(*sock.as_inner(), 128) })?;
-//                                    Ok(TcpListener { inner: sock })
-//                            }
-//
-//                            pub fn socket(&self) -> &Socket { &self.inner }
-//
-//                            pub fn into_socket(self) -> Socket { self.inner }
-//
-//                            pub fn socket_addr(&self) -> io::Result<SocketAddr> {
-//                                    sockname(|buf, len| unsafe {
-//                                            c::getsockname(*self.inner.as_inner(), buf, len)
-//                                    })
-//                            }
-//
-//                            pub fn accept(&self) -> io::Result<(TcpStream, SocketAddr)> {
-//                                    let mut storage: c::sockaddr_storage = unsafe { mem::zeroed() };
-//                                    let mut len = mem::size_of_val(&storage) as c::socklen_t;
-//                                    let sock = self.inner.accept(&mut storage as *mut _ as *mut _,
-//                                    &mut len)?;
-//                                    let addr = sockaddr_to_addr(&storage, len as usize)?;
-//                                    Ok((TcpStream { inner: sock, }, addr))
-//                            }
-//
-//                            pub fn duplicate(&self) -> io::Result<TcpListener> {
-//                                    self.inner.duplicate().map(|s| TcpListener { inner: s })
-//                            }
-//
-//                            pub fn set_ttl(&self, ttl: u32) -> io::Result<()> {
-//                                    setsockopt(&self.inner, c::IPPROTO_IP, c::IP_TTL, ttl as c_int)
-//                            }
-//
-//                            pub fn ttl(&self) -> io::Result<u32> {
-//                                    let raw: c_int = getsockopt(&self.inner, c::IPPROTO_IP, c::IP_TTL)?;
-//                                    Ok(raw as u32)
-//                            }
-//
-//                            pub fn set_only_v6(&self, only_v6: bool) -> io::Result<()> {
-//                                    setsockopt(&self.inner, c::IPPROTO_IPV6, c::IPV6_V6ONLY, only_v6 as c_int)
-//                            }
-//
-//                            pub fn only_v6(&self) -> io::Result<bool> {
-//                                    let raw: c_int = getsockopt(&self.inner, c::IPPROTO_IPV6, c::IPV6_V6ONLY)?;
-//                                    Ok(raw != 0)
-//                            }
-//
-//                            pub fn take_error(&self) -> io::Result<Option<io::Error>> {
-//                                    self.inner.take_error()
-//                            }
-//
-//                            pub fn set_nonblocking(&self, nonblocking: bool) -> io::Result<()> {
-//                                    self.inner.set_nonblocking(nonblocking)
-//                            }
-//                        }
-//
-//                        impl FromInner<Socket> for TcpListener {
-//                            fn from_inner(socket: Socket) -> TcpListener {
-//                                    TcpListener { inner: socket }
-//                            }
-//                        }
-//
-//                        impl fmt::Debug for TcpListener {
-//                            fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
-//                            let mut res = f.debug_struct("TcpListener");
-//
-//                            if let Ok(addr) = self.socket_addr() {
-//                                res.field("addr", &addr);
-//                            }
-//
-//                            let name = if cfg!(windows) {"socket"} else {"fd"};
-//                            res.field(name, &self.inner.as_inner())
-//                                    .finish()
-//                        }
-//                    }
-
-        };
+        /// TCP socket listening for incoming connections
+        ///
+        /// \details Modelled after `std::net::TcpListener` in the Rust Standard Library, with the overlapped extensions
+        /// of miow's `TcpListenerExt`. Connections are accepted into streams created beforehand through
+        /// `TcpStream::create`, so that the accept itself can complete on a completion port.
+        class TcpListener : public interface::TcpListenerExt<TcpListener> {
+
+            Socket inner_;      ///< Underlying overlapped socket
+
+        public:
+            // # Constructors
+            explicit TcpListener(Socket socket) noexcept
+                : inner_{std::move(socket)} {}
+
+            TcpListener(const TcpListener& other) = delete;
+
+            TcpListener(TcpListener&& other) noexcept = default;
+
+            // # Operator overloads
+            TcpListener& operator=(const TcpListener& rhs) = delete;
+
+            TcpListener& operator=(TcpListener&& rhs) noexcept = default;
+
+            // # Public member functions
+
+            /// Create new listener bound to the provided address
+            ///
+            /// \details Binding to port 0 requests an ephemeral port from the system, which can be retrieved through
+            /// `local_addr`.
+            ///
+            /// \param address Local socket address to listen on
+            /// \param backlog Maximum length of the queue of pending connections
+            /// \return Variant with TcpListener if successful, error type otherwise
+            static Result<TcpListener> bind(const SocketAddr& address, int backlog = SOMAXCONN) noexcept {
+                Result<Socket> socket = Socket::create(address, SOCK_STREAM);
+                if (std::holds_alternative<Error>(socket)) {
+                    return std::get<Error>(socket);
+                }
+                Socket& sock = std::get<Socket>(socket);
+                if (auto res = sock.bind(address); std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                if (auto res = sock.listen(backlog); std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                return TcpListener{std::move(sock)};
+            }
+
+            /// Wrap raw Windows socket
+            static TcpListener from_raw_socket(SOCKET socket) noexcept {
+                return TcpListener{Socket{socket}};
+            }
+
+            /// Borrow raw Windows socket
+            [[nodiscard]] SOCKET as_raw_socket() const noexcept {
+                return inner_.as_raw_socket();
+            }
+
+            /// Extract raw Windows socket and consume wrapper
+            SOCKET into_raw_socket() && noexcept {
+                return std::move(inner_).into_raw_socket();
+            }
+
+            /// Borrow underlying socket
+            [[nodiscard]] const Socket& socket() const noexcept {
+                return inner_;
+            }
+
+            /// Extract underlying socket and consume wrapper
+            Socket into_socket() && noexcept {
+                return std::move(inner_);
+            }
+
+            /// Return local address this listener is bound to
+            [[nodiscard]] Result<SocketAddr> local_addr() const noexcept {
+                return inner_.local_addr();
+            }
+
+            /// Set time-to-live of packets sent from accepted connections
+            Result<std::monostate> set_ttl(unsigned long ttl) noexcept {
+                return inner_.set_option<DWORD>(IPPROTO_IP, IP_TTL, ttl);
+            }
+
+            /// Return time-to-live of packets sent from accepted connections
+            [[nodiscard]] Result<unsigned long> ttl() const noexcept {
+                Result<DWORD> res = inner_.option<DWORD>(IPPROTO_IP, IP_TTL);
+                if (std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                return std::get<DWORD>(res);
+            }
+
+            /// Restrict IPv6 listener to IPv6 connections only, or allow IPv4-mapped connections as well
+            Result<std::monostate> set_only_v6(bool onlyV6) noexcept {
+                return inner_.set_option<DWORD>(IPPROTO_IPV6, IPV6_V6ONLY, onlyV6 ? 1 : 0);
+            }
+
+            /// Return `true` if this IPv6 listener only accepts IPv6 connections
+            [[nodiscard]] Result<bool> only_v6() const noexcept {
+                Result<DWORD> res = inner_.option<DWORD>(IPPROTO_IPV6, IPV6_V6ONLY);
+                if (std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                return std::get<DWORD>(res) != 0;
+            }
+
+            /// Retrieve and clear pending error on this listener
+            [[nodiscard]] Result<std::optional<Error>> take_error() const noexcept {
+                return inner_.take_error();
+            }
+
+            /// Move this listener in or out of non-blocking mode
+            Result<std::monostate> set_nonblocking(bool nonblocking) noexcept {
+                return inner_.set_nonblocking(nonblocking);
+            }
+
+            /// Asynchronously accept an incoming connection into the provided stream
+            ///
+            /// \details Submits an overlapped accept through `AcceptEx`. The stream must have been created for the same
+            /// address family as this listener and must not be bound or connected. The stream, the address buffer and
+            /// the overlapped structure must stay alive and in place until the operation has completed. After
+            /// completion, `accept_complete` must be called before the stream is used with other socket functions.
+            ///
+            /// \param socket Unconnected stream to accept the connection into
+            /// \param address Buffer receiving the local and the remote address of the connection
+            /// \param overlapped Raw overlapped structure to specify asynchronous accept
+            /// \return Variant with `true` if the accept has completed immediately, `false` if it is pending, error type
+            /// otherwise
+            Result<bool> accept_overlapped(const TcpStream& socket, AcceptAddrBuf& address,
+                                           OVERLAPPED* overlapped) noexcept {
+                Result<LPFN_ACCEPTEX> acceptEx = extension::ACCEPTEX.get_as<LPFN_ACCEPTEX>(inner_.as_raw_socket());
+                if (std::holds_alternative<Error>(acceptEx)) {
+                    return std::get<Error>(acceptEx);
+                }
+                DWORD bytes = 0;
+                iocp::instrument::submitted(overlapped, iocp::instrument::Op::Accept);
+                const BOOL ret = std::get<LPFN_ACCEPTEX>(acceptEx)(
+                        inner_.as_raw_socket(),
+                        socket.as_raw_socket(),
+                        address.data(),
+                        0,
+                        AcceptAddrBuf::address_length(),
+                        AcceptAddrBuf::address_length(),
+                        &bytes,
+                        overlapped
+                );
+                if (ret == FALSE) {
+                    const int err = WSAGetLastError();
+                    if (err == WSA_IO_PENDING) {
+                        return false;
+                    }
+                    iocp::instrument::rejected(overlapped);
+                    return Error{static_cast<wse::win_errc>(err)};
+                }
+                return true;
+            }
+
+            /// Update context of an accepted stream after an accept through `accept_overlapped` has completed
+            ///
+            /// \param socket Stream the connection has been accepted into
+            /// \return Variant with error type, in case the context cannot be updated
+            Result<std::monostate> accept_complete(const TcpStream& socket) noexcept {
+                SOCKET listener = inner_.as_raw_socket();
+                const int ret = setsockopt(
+                        socket.as_raw_socket(),
+                        SOL_SOCKET,
+                        SO_UPDATE_ACCEPT_CONTEXT,
+                        reinterpret_cast<const char*>(&listener),
+                        static_cast<int>(sizeof listener)
+                );
+                if (ret == SOCKET_ERROR) {
+                    return Socket::last_error();
+                }
+                return std::monostate{};
+            }
+
+            /// Retrieve the result of an overlapped operation on this listener
+            ///
+            /// \param overlapped Raw overlapped structure of the completed operation
+            /// \return Variant with tuple of the number of bytes transferred and the flags, error type otherwise
+            Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept {
+                DWORD transferred = 0;
+                DWORD flags = 0;
+                const BOOL ret = WSAGetOverlappedResult(
+                        inner_.as_raw_socket(),
+                        overlapped,
+                        &transferred,
+                        FALSE,
+                        &flags
+                );
+                if (ret == FALSE) {
+                    return Socket::last_error();
+                }
+                return std::tuple<std::size_t, unsigned long>{transferred, flags};
+            }
+
+        }; // class TcpListener
+
+        static_assert(sizeof(TcpListener) == sizeof(Socket));
+
+        inline Result<AcceptAddr> AcceptAddrBuf::parse(TcpListener& socket) noexcept {
+            Result<LPFN_GETACCEPTEXSOCKADDRS> getAcceptExSockaddrs =
+                    extension::GETACCEPTEXSOCKADDRS.get_as<LPFN_GETACCEPTEXSOCKADDRS>(socket.as_raw_socket());
+            if (std::holds_alternative<Error>(getAcceptExSockaddrs)) {
+                return std::get<Error>(getAcceptExSockaddrs);
+            }
+            SOCKADDR* local = nullptr;
+            int localLength = 0;
+            SOCKADDR* remote = nullptr;
+            int remoteLength = 0;
+            std::get<LPFN_GETACCEPTEXSOCKADDRS>(getAcceptExSockaddrs)(
+                    data(),
+                    0,
+                    address_length(),
+                    address_length(),
+                    &local,
+                    &localLength,
+                    &remote,
+                    &remoteLength
+            );
+            return AcceptAddr{local, localLength, remote, remoteLength, this};
+        }
 
     } // namespace net
 
     namespace trait {
 
+        template<>
+        constexpr bool is_send<net::TcpListener> = true;
+
+        template<>
+        constexpr bool is_sync<net::TcpListener> = true;
+
         template<>
         constexpr bool as_raw_socket<net::TcpListener> = true;
 
@@ -134,4 +266,4 @@ namespace laio {
 
     } // namespace trait
 
-} // namespace laio
\ No newline at end of file
+} // namespace laio
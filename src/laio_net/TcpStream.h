@@ -1,171 +1,375 @@
 #pragma once
 
+#include <WinSock2.h>
+#include <MSWSock.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <tuple>
 #include <variant>
 
+#include "gsl/span"
+#include "Result.h"
+
+#include "Instrument.h"
+#include "IoSpan.h"
+#include "IoSpanMut.h"
+#include "Socket.h"
+#include "SocketAddr.h"
 #include "TcpStreamExt.h"
+#include "WsaExtension.h"
 #include "traits.h"
 
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
+    using std::uint8_t;
 
     namespace net {
 
-        class TcpStream : public interface::TcpStreamExt {
-
-//            ////////////////////////////////////////////////////////////////////////////////
-//            // TCP streams
-//            ////////////////////////////////////////////////////////////////////////////////
-//
-//                        pub struct TcpStream {
-//                            inner: Socket,
-//                        }
-//
-//                                impl TcpStream {
-//                            pub fn connect(addr: io::Result<&SocketAddr>) -> io::Result<TcpStream> {
-//                                    let addr = addr?;
-//
-//                                    init();
-//
-//                                    let sock = Socket::new(addr, c::SOCK_STREAM)?;
-//
-//                                    let (addrp, len) = addr.into_inner();
-//                                    cvt_r(|| unsafe { c::connect(*sock.as_inner(), addrp, len) })?;
-//                                    Ok(TcpStream { inner: sock })
-//                            }
-//
-//                            pub fn connect_timeout(addr: &SocketAddr, timeout: Duration) -> io::Result<TcpStream> {
-//                                    init();
-//
-//                                    let sock = Socket::new(addr, c::SOCK_STREAM)?;
-//                                    sock.connect_timeout(addr, timeout)?;
-//                                    Ok(TcpStream { inner: sock })
-//                            }
-//
-//                            pub fn socket(&self) -> &Socket { &self.inner }
-//
-//                            pub fn into_socket(self) -> Socket { self.inner }
-//
-//                            pub fn set_read_timeout(&self, dur: Option<Duration>) -> io::Result<()> {
-//                                    self.inner.set_timeout(dur, c::SO_RCVTIMEO)
-//                            }
-//
-//                            pub fn set_write_timeout(&self, dur: Option<Duration>) -> io::Result<()> {
-//                                    self.inner.set_timeout(dur, c::SO_SNDTIMEO)
-//                            }
-//
-//                            pub fn read_timeout(&self) -> io::Result<Option<Duration>> {
-//                                    self.inner.timeout(c::SO_RCVTIMEO)
-//                            }
-//
-//                            pub fn write_timeout(&self) -> io::Result<Option<Duration>> {
-//                                    self.inner.timeout(c::SO_SNDTIMEO)
-//                            }
-//
-//                            pub fn peek(&self, buf: &mut [u8]) -> io::Result<usize> {
-//                                    self.inner.peek(buf)
-//                            }
-//
-//                            pub fn read(&self, buf: &mut [u8]) -> io::Result<usize> {
-//                                    self.inner.read(buf)
-//                            }
-//
-//                            pub fn read_vectored(&self, bufs: &mut [IoSpanMut<'_>]) -> io::Result<usize> {
-//                            self.inner.read_vectored(bufs)
-//                        }
-//
-//                        pub fn write(&self, buf: &[u8]) -> io::Result<usize> {
-//                            let len = cmp::min(buf.len(), <wrlen_t>::max_value() as usize) as wrlen_t;
-//                            let ret = cvt(unsafe {
-//                                    c::send(*self.inner.as_inner(),
-//                                            buf.as_ptr() as *const c_void,
-//                                    len,
-//                                    MSG_NOSIGNAL)
-//                            })?;
-//                            Ok(ret as usize)
-//                        }
-//
-//                        pub fn write_vectored(&self, bufs: &[IoSlice<'_>]) -> io::Result<usize> {
-//                        self.inner.write_vectored(bufs)
-//                    }
-//
-//                            pub fn peer_addr(&self) -> io::Result<SocketAddr> {
-//                    sockname(|buf, len| unsafe {
-//                    c::getpeername(*self.inner.as_inner(), buf, len)
-//                })
-//            }
-//
-//            pub fn socket_addr(&self) -> io::Result<SocketAddr> {
-//            sockname(|buf, len| unsafe {
-//            c::getsockname(*self.inner.as_inner(), buf, len)
-//            })
-//            }
-//
-//            pub fn shutdown(&self, how: Shutdown) -> io::Result<()> {
-//            self.inner.shutdown(how)
-//            }
-//
-//            pub fn duplicate(&self) -> io::Result<TcpStream> {
-//            self.inner.duplicate().map(|s| TcpStream { inner: s })
-//            }
-//
-//            pub fn set_nodelay(&self, nodelay: bool) -> io::Result<()> {
-//            self.inner.set_nodelay(nodelay)
-//            }
-//
-//            pub fn nodelay(&self) -> io::Result<bool> {
-//            self.inner.nodelay()
-//            }
-//
-//            pub fn set_ttl(&self, ttl: u32) -> io::Result<()> {
-//            setsockopt(&self.inner, c::IPPROTO_IP, c::IP_TTL, ttl as c_int)
-//            }
-//
-//            pub fn ttl(&self) -> io::Result<u32> {
-//            let raw: c_int = getsockopt(&self.inner, c::IPPROTO_IP, c::IP_TTL)?;
-//            Ok(raw as u32)
-//            }
-//
-//            pub fn take_error(&self) -> io::Result<Option<io::Error>> {
-//            self.inner.take_error()
-//            }
-//
-//            pub fn set_nonblocking(&self, nonblocking: bool) -> io::Result<()> {
-//            self.inner.set_nonblocking(nonblocking)
-//            }
-//            }
-//
-//            impl FromInner<Socket> for TcpStream {
-//            fn from_inner(socket: Socket) -> TcpStream {
-//            TcpStream { inner: socket }
-//            }
-//            }
-//
-//            impl fmt::Debug for TcpStream {
-//            fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
-//            let mut res = f.debug_struct("TcpStream");
-//
-//            if let Ok(addr) = self.socket_addr() {
-//                res.field("addr", &addr);
-//            }
-//
-//            if let Ok(peer) = self.peer_addr() {
-//                res.field("peer", &peer);
-//            }
-//
-//            let name = if cfg!(windows) {"socket"} else {"fd"};
-//            res.field(name, &self.inner.as_inner())
-//            .finish()
-//            }
-//            }
+        /// TCP stream between a local and a remote socket
+        ///
+        /// \details Modelled after `std::net::TcpStream` in the Rust Standard Library, with the overlapped extensions of
+        /// miow's `TcpStreamExt`. Streams are either accepted by a `TcpListener`, or created unconnected through
+        /// `create` and then connected through `connect_overlapped`.
+        class TcpStream : public interface::TcpStreamExt<TcpStream> {
+
+            Socket inner_;      ///< Underlying overlapped socket
+
+        public:
+            // # Constructors
+            explicit TcpStream(Socket socket) noexcept
+                : inner_{std::move(socket)} {}
+
+            TcpStream(const TcpStream& other) = delete;
+
+            TcpStream(TcpStream&& other) noexcept = default;
+
+            // # Operator overloads
+            TcpStream& operator=(const TcpStream& rhs) = delete;
+
+            TcpStream& operator=(TcpStream&& rhs) noexcept = default;
+
+            // # Public member functions
+
+            /// Create new unconnected stream for the address family of the provided address
+            ///
+            /// \details The stream can be passed to `TcpListener::accept_overlapped`, or bound and connected through
+            /// `connect_overlapped`.
+            ///
+            /// \param address Socket address, which determines the address family
+            /// \return Variant with TcpStream if successful, error type otherwise
+            static Result<TcpStream> create(const SocketAddr& address) noexcept {
+                return create(address.family());
+            }
+
+            /// Create new unconnected stream for the specified address family
+            ///
+            /// \param family Address family, `AF_INET` or `AF_INET6`
+            /// \return Variant with TcpStream if successful, error type otherwise
+            static Result<TcpStream> create(int family) noexcept {
+                Result<Socket> socket = Socket::create(family, SOCK_STREAM);
+                if (std::holds_alternative<Error>(socket)) {
+                    return std::get<Error>(socket);
+                }
+                return TcpStream{std::move(std::get<Socket>(socket))};
+            }
+
+            /// Wrap raw Windows socket
+            static TcpStream from_raw_socket(SOCKET socket) noexcept {
+                return TcpStream{Socket{socket}};
+            }
+
+            /// Borrow raw Windows socket
+            [[nodiscard]] SOCKET as_raw_socket() const noexcept {
+                return inner_.as_raw_socket();
+            }
+
+            /// Extract raw Windows socket and consume wrapper
+            SOCKET into_raw_socket() && noexcept {
+                return std::move(inner_).into_raw_socket();
+            }
+
+            /// Borrow underlying socket
+            [[nodiscard]] const Socket& socket() const noexcept {
+                return inner_;
+            }
+
+            /// Borrow underlying socket mutably, e.g. to bind it before connecting
+            Socket& socket() noexcept {
+                return inner_;
+            }
+
+            /// Extract underlying socket and consume wrapper
+            Socket into_socket() && noexcept {
+                return std::move(inner_);
+            }
+
+            /// Return remote address this stream is connected to
+            [[nodiscard]] Result<SocketAddr> peer_addr() const noexcept {
+                return inner_.peer_addr();
+            }
+
+            /// Return local address this stream is bound to
+            [[nodiscard]] Result<SocketAddr> local_addr() const noexcept {
+                return inner_.local_addr();
+            }
+
+            /// Shut down the read half, the write half or both halves of this stream
+            ///
+            /// \param how `SD_RECEIVE`, `SD_SEND` or `SD_BOTH`
+            /// \return Variant with error type, in case the shutdown has failed
+            Result<std::monostate> shutdown(int how) noexcept {
+                if (::shutdown(inner_.as_raw_socket(), how) == SOCKET_ERROR) {
+                    return Socket::last_error();
+                }
+                return std::monostate{};
+            }
+
+            /// Enable or disable Nagle's algorithm on this stream
+            ///
+            /// \param nodelay Disable Nagle's algorithm if `true`
+            /// \return Variant with error type, in case the option cannot be set
+            Result<std::monostate> set_nodelay(bool nodelay) noexcept {
+                return inner_.set_option<BOOL>(IPPROTO_TCP, TCP_NODELAY, nodelay ? TRUE : FALSE);
+            }
+
+            /// Return `true` if Nagle's algorithm is disabled on this stream
+            [[nodiscard]] Result<bool> nodelay() const noexcept {
+                Result<BOOL> res = inner_.option<BOOL>(IPPROTO_TCP, TCP_NODELAY);
+                if (std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                return std::get<BOOL>(res) != FALSE;
+            }
+
+            /// Retrieve and clear pending error on this stream
+            [[nodiscard]] Result<std::optional<Error>> take_error() const noexcept {
+                return inner_.take_error();
+            }
+
+            /// Asynchronously receive data from this stream
+            ///
+            /// \details Submits an overlapped receive. The buffer must stay alive and in place until the operation has
+            /// completed. If the receive completes immediately, the number of bytes is returned, although the
+            /// completion is still posted to the completion port the stream is associated with.
+            ///
+            /// \param buf Buffer for received bytes
+            /// \param overlapped Raw overlapped structure to specify asynchronous receive
+            /// \return Variant with number of bytes if completed immediately, `std::nullopt` if pending, error type
+            /// otherwise
+            Result<std::optional<std::size_t>> read_overlapped(gsl::span<uint8_t> buf,
+                                                               OVERLAPPED* overlapped) noexcept {
+                WSABUF buffer{as_len_(buf.size_bytes()), reinterpret_cast<CHAR*>(buf.data())};
+                DWORD bytes = 0;
+                DWORD flags = 0;
+                iocp::instrument::submitted(overlapped, iocp::instrument::Op::Read, buf.size_bytes());
+                const int ret = WSARecv(
+                        inner_.as_raw_socket(),
+                        &buffer,
+                        1,
+                        &bytes,
+                        &flags,
+                        overlapped,
+                        nullptr
+                );
+                return cvt_(ret, bytes, overlapped);
+            }
+
+            /// Asynchronously send data on this stream
+            ///
+            /// \details Submits an overlapped send. The buffer must stay alive and in place until the operation has
+            /// completed.
+            ///
+            /// \param buf Buffer of bytes to send
+            /// \param overlapped Raw overlapped structure to specify asynchronous send
+            /// \return Variant with number of bytes if completed immediately, `std::nullopt` if pending, error type
+            /// otherwise
+            Result<std::optional<std::size_t>> write_overlapped(gsl::span<const uint8_t> buf,
+                                                                OVERLAPPED* overlapped) noexcept {
+                WSABUF buffer{as_len_(buf.size_bytes()), reinterpret_cast<CHAR*>(const_cast<uint8_t*>(buf.data()))};
+                DWORD bytes = 0;
+                iocp::instrument::submitted(overlapped, iocp::instrument::Op::Write, buf.size_bytes());
+                const int ret = WSASend(
+                        inner_.as_raw_socket(),
+                        &buffer,
+                        1,
+                        &bytes,
+                        0,
+                        overlapped,
+                        nullptr
+                );
+                return cvt_(ret, bytes, overlapped);
+            }
+
+            /// Asynchronously receive data from this stream into several buffers
+            ///
+            /// \details Submits a single overlapped receive, which fills the buffers in order, e.g. the slices of an
+            /// `IoBuf`. The buffers must stay alive and in place until the operation has completed, while the array
+            /// describing them is only read during the call.
+            ///
+            /// \param bufs Buffers for received bytes
+            /// \param overlapped Raw overlapped structure to specify asynchronous receive
+            /// \return Variant with number of bytes if completed immediately, `std::nullopt` if pending, error type
+            /// otherwise
+            Result<std::optional<std::size_t>> read_vectored_overlapped(gsl::span<IoSpanMut> bufs,
+                                                                        OVERLAPPED* overlapped) noexcept {
+                std::size_t total = 0;
+                for (IoSpanMut& buf : bufs) {
+                    total += buf.as_span().size_bytes();
+                }
+                DWORD bytes = 0;
+                DWORD flags = 0;
+                iocp::instrument::submitted(overlapped, iocp::instrument::Op::Read, total);
+                const int ret = WSARecv(
+                        inner_.as_raw_socket(),
+                        reinterpret_cast<LPWSABUF>(bufs.data()),
+                        as_len_(bufs.size()),
+                        &bytes,
+                        &flags,
+                        overlapped,
+                        nullptr
+                );
+                return cvt_(ret, bytes, overlapped);
+            }
+
+            /// Asynchronously send data from several buffers on this stream
+            ///
+            /// \details Submits a single overlapped send, which gathers the buffers in order, e.g. the slices of an
+            /// `IoBuf`. The buffers must stay alive and in place until the operation has completed, while the array
+            /// describing them is only read during the call.
+            ///
+            /// \param bufs Buffers of bytes to send
+            /// \param overlapped Raw overlapped structure to specify asynchronous send
+            /// \return Variant with number of bytes if completed immediately, `std::nullopt` if pending, error type
+            /// otherwise
+            Result<std::optional<std::size_t>> write_vectored_overlapped(gsl::span<const IoSpan> bufs,
+                                                                         OVERLAPPED* overlapped) noexcept {
+                std::size_t total = 0;
+                for (const IoSpan& buf : bufs) {
+                    total += buf.size();
+                }
+                DWORD bytes = 0;
+                iocp::instrument::submitted(overlapped, iocp::instrument::Op::Write, total);
+                const int ret = WSASend(
+                        inner_.as_raw_socket(),
+                        reinterpret_cast<LPWSABUF>(const_cast<IoSpan*>(bufs.data())),
+                        as_len_(bufs.size()),
+                        &bytes,
+                        0,
+                        overlapped,
+                        nullptr
+                );
+                return cvt_(ret, bytes, overlapped);
+            }
+
+            /// Asynchronously connect this stream to a remote address
+            ///
+            /// \details Submits an overlapped connect through `ConnectEx`, which requires the stream to be bound
+            /// already, e.g. to the unspecified address and port 0. The provided buffer is sent once the connection
+            /// has been established. After completion, `connect_complete` must be called before the stream is used
+            /// with other socket functions.
+            ///
+            /// \param address Remote address to connect to
+            /// \param buf Buffer of bytes to send after connecting, may be empty
+            /// \param overlapped Raw overlapped structure to specify asynchronous connect
+            /// \return Variant with number of bytes sent if completed immediately, `std::nullopt` if pending, error
+            /// type otherwise
+            Result<std::optional<std::size_t>> connect_overlapped(const SocketAddr& address,
+                                                                  gsl::span<const uint8_t> buf,
+                                                                  OVERLAPPED* overlapped) noexcept {
+                Result<LPFN_CONNECTEX> connectEx = extension::CONNECTEX.get_as<LPFN_CONNECTEX>(inner_.as_raw_socket());
+                if (std::holds_alternative<Error>(connectEx)) {
+                    return std::get<Error>(connectEx);
+                }
+                auto [addr, len] = address.as_raw();
+                DWORD bytes = 0;
+                iocp::instrument::submitted(overlapped, iocp::instrument::Op::Connect, buf.size_bytes());
+                const BOOL ret = std::get<LPFN_CONNECTEX>(connectEx)(
+                        inner_.as_raw_socket(),
+                        addr,
+                        len,
+                        const_cast<uint8_t*>(buf.data()),
+                        as_len_(buf.size_bytes()),
+                        &bytes,
+                        overlapped
+                );
+                if (ret == FALSE) {
+                    const int err = WSAGetLastError();
+                    if (err == WSA_IO_PENDING) {
+                        return std::nullopt;
+                    }
+                    iocp::instrument::rejected(overlapped);
+                    return Error{static_cast<wse::win_errc>(err)};
+                }
+                return static_cast<std::size_t>(bytes);
+            }
+
+            /// Update context of this stream after a connect through `connect_overlapped` has completed
+            ///
+            /// \return Variant with error type, in case the context cannot be updated
+            Result<std::monostate> connect_complete() noexcept {
+                const int ret = setsockopt(inner_.as_raw_socket(), SOL_SOCKET, SO_UPDATE_CONNECT_CONTEXT, nullptr, 0);
+                if (ret == SOCKET_ERROR) {
+                    return Socket::last_error();
+                }
+                return std::monostate{};
+            }
+
+            /// Retrieve the result of an overlapped operation on this stream
+            ///
+            /// \param overlapped Raw overlapped structure of the completed operation
+            /// \return Variant with tuple of the number of bytes transferred and the flags, error type otherwise
+            Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept {
+                DWORD transferred = 0;
+                DWORD flags = 0;
+                const BOOL ret = WSAGetOverlappedResult(
+                        inner_.as_raw_socket(),
+                        overlapped,
+                        &transferred,
+                        FALSE,
+                        &flags
+                );
+                if (ret == FALSE) {
+                    return Socket::last_error();
+                }
+                return std::tuple<std::size_t, unsigned long>{transferred, flags};
+            }
+
+        private:
+            /// Clamp length of a buffer to what a single Winsock call accepts
+            static ULONG as_len_(std::size_t len) noexcept {
+                return static_cast<ULONG>((std::min)(len, static_cast<std::size_t>((std::numeric_limits<ULONG>::max)())));
+            }
+
+            /// Convert return value of an overlapped Winsock call into a result
+            static Result<std::optional<std::size_t>> cvt_(int ret, DWORD bytes, OVERLAPPED* overlapped) noexcept {
+                if (ret == SOCKET_ERROR) {
+                    const int err = WSAGetLastError();
+                    if (err == WSA_IO_PENDING) {
+                        return std::nullopt;
+                    }
+                    iocp::instrument::rejected(overlapped);
+                    return Error{static_cast<wse::win_errc>(err)};
+                }
+                return static_cast<std::size_t>(bytes);
+            }
 
         };
 
+        static_assert(sizeof(TcpStream) == sizeof(Socket));
+
     } // namespace net
 
     namespace trait {
 
+        template<>
+        constexpr bool is_send<net::TcpStream> = true;
+
+        template<>
+        constexpr bool is_sync<net::TcpStream> = true;
+
         template<>
         constexpr bool as_raw_socket<net::TcpStream> = true;
 
@@ -177,4 +381,4 @@ namespace laio {
 
     } // namespace trait
 
-} // namespace laio
\ No newline at end of file
+} // namespace laio
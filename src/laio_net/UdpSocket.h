@@ -4,17 +4,20 @@
 
 #include <variant>
 
+#include "Result.h"
+
 #include "traits.h"
 #include "UdpSocketExt.h"
 
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
-
     namespace net {
 
-        class UdpSocket : public interface::UdpSocketExt {
+        /// UDP socket, not implemented yet
+        ///
+        /// \details Derives from `interface::UdpSocketExt` only once it implements every member of the interface, as
+        /// calling an inherited member would forward to itself.
+        class UdpSocket {
 
 //            ////////////////////////////////////////////////////////////////////////////////
 //            // UDP
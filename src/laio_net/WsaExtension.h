@@ -1,16 +1,89 @@
 #pragma once
 
+#include <WinSock2.h>
+#include <MSWSock.h>
 #include <guiddef.h>
 
 #include <atomic>
+#include <variant>
 
-namespace laio::net {
+#include "Result.h"
 
-    class WsaExtension {
+namespace laio {
 
-        GUID guid_;
-        std::atomic_size_t value_;
+    namespace net {
 
-    };
+        /// Lazily resolved Winsock extension function
+        ///
+        /// \details Functions such as `AcceptEx` and `ConnectEx` are not exported by the Winsock library, but must be
+        /// looked up at runtime through their GUID. The pointer is resolved on first use and cached, as it is the same
+        /// for all sockets of the default provider.
+        class WsaExtension {
 
-} // namespace laio::net
\ No newline at end of file
+            GUID guid_;                         ///< GUID identifying the extension function
+            std::atomic_size_t value_;          ///< Cached function pointer, zero if not yet resolved
+
+        public:
+            // # Constructors
+            explicit constexpr WsaExtension(GUID guid) noexcept
+                : guid_{guid}, value_{0} {}
+
+            // # Public member functions
+
+            /// Return pointer to the extension function, resolving it through the provided socket if required
+            ///
+            /// \param socket Any socket of the provider, which implements the extension
+            /// \return Variant with function pointer as an integer if successful, error type otherwise
+            Result<std::size_t> get(SOCKET socket) noexcept {
+                const std::size_t prev = value_.load(std::memory_order_acquire);
+                if (prev != 0) {
+                    return prev;
+                }
+                std::size_t ret = 0;
+                DWORD bytes = 0;
+                const int res = WSAIoctl(
+                        socket,
+                        SIO_GET_EXTENSION_FUNCTION_POINTER,
+                        &guid_,
+                        static_cast<DWORD>(sizeof guid_),
+                        &ret,
+                        static_cast<DWORD>(sizeof ret),
+                        &bytes,
+                        nullptr,
+                        nullptr
+                );
+                if (res == SOCKET_ERROR) {
+                    return Error{static_cast<wse::win_errc>(WSAGetLastError())};
+                }
+                value_.store(ret, std::memory_order_release);
+                return ret;
+            }
+
+            /// Return typed pointer to the extension function, resolving it through the provided socket if required
+            ///
+            /// \param socket Any socket of the provider, which implements the extension
+            /// \return Variant with function pointer if successful, error type otherwise
+            template<typename F>
+            Result<F> get_as(SOCKET socket) noexcept {
+                Result<std::size_t> res = get(socket);
+                if (std::holds_alternative<Error>(res)) {
+                    return std::get<Error>(res);
+                }
+                return reinterpret_cast<F>(std::get<std::size_t>(res));
+            }
+
+        }; // class WsaExtension
+
+        namespace extension {
+
+            inline WsaExtension ACCEPTEX{WSAID_ACCEPTEX};                           ///< `AcceptEx`
+
+            inline WsaExtension CONNECTEX{WSAID_CONNECTEX};                         ///< `ConnectEx`
+
+            inline WsaExtension GETACCEPTEXSOCKADDRS{WSAID_GETACCEPTEXSOCKADDRS};   ///< `GetAcceptExSockaddrs`
+
+        } // namespace extension
+
+    } // namespace net
+
+} // namespace laio
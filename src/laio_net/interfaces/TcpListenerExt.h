@@ -4,8 +4,11 @@
 #include <Windows.h>
 
 #include <tuple>
+#include <type_traits>
 #include <variant>
 
+#include "Result.h"
+
 #include "AcceptAddrBuf.h"
 #include "TcpStream.h"
 
@@ -16,19 +19,44 @@
 
 namespace laio {
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
-
     namespace net::interface {
 
+        /// Overlapped extensions of a TCP listener, modelled after miow's `TcpListenerExt`
+        ///
+        /// \details Static interface, which forwards every call to the implementation without virtual dispatch, so that
+        /// generic code over listeners inlines down to the Winsock call and listeners carry no vtable pointer. An
+        /// implementation must define every member it is called through, which each member asserts, as an inherited
+        /// one would forward to itself.
+        template<typename Derived>
         struct TcpListenerExt {
-
-            virtual Result<bool> accept_overlapped(const TcpStream& socket, AcceptAddrBuf& address, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::monostate> accept_complete(const TcpStream& socket) noexcept = 0;
-            virtual Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept = 0;
-            virtual ~TcpListenerExt() = default;
-
-        };
+            // # Public member functions
+
+            /// Asynchronously accept a connection into the provided stream
+            Result<bool> accept_overlapped(const TcpStream& socket, AcceptAddrBuf& address,
+                                           OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::accept_overlapped),
+                                              decltype(&TcpListenerExt::accept_overlapped)>,
+                              "Derived must implement accept_overlapped");
+                return static_cast<Derived*>(this)->accept_overlapped(socket, address, overlapped);
+            }
+
+            /// Update context of an accepted stream after an accept has completed
+            Result<std::monostate> accept_complete(const TcpStream& socket) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::accept_complete),
+                                              decltype(&TcpListenerExt::accept_complete)>,
+                              "Derived must implement accept_complete");
+                return static_cast<Derived*>(this)->accept_complete(socket);
+            }
+
+            /// Retrieve the result of an overlapped operation on this listener
+            Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::result),
+                                              decltype(&TcpListenerExt::result)>,
+                              "Derived must implement result");
+                return static_cast<Derived*>(this)->result(overlapped);
+            }
+
+        }; // struct TcpListenerExt
 
     } // namespace net::interface
 
@@ -4,10 +4,14 @@
 
 #include <optional>
 #include <tuple>
+#include <type_traits>
 #include <variant>
 
 #include "gsl/span"
+#include "Result.h"
 
+#include "IoSpan.h"
+#include "IoSpanMut.h"
 #include "SocketAddr.h"
 
 // Symbol defined as __STRUCT__ in <combaseapi.h>
@@ -19,21 +23,80 @@ namespace laio {
 
     using std::uint8_t;
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
-
     namespace net::interface {
 
+        /// Overlapped extensions of a TCP stream, modelled after miow's `TcpStreamExt`
+        ///
+        /// \details Static interface, which forwards every call to the implementation without virtual dispatch, so that
+        /// generic code over streams inlines down to the Winsock call and streams carry no vtable pointer. An
+        /// implementation must define every member it is called through, which each member asserts, as an inherited
+        /// one would forward to itself.
+        template<typename Derived>
         struct TcpStreamExt {
+            // # Public member functions
+
+            /// Asynchronously receive data from this stream
+            Result<std::optional<std::size_t>> read_overlapped(gsl::span<uint8_t> buf, OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::read_overlapped),
+                                              decltype(&TcpStreamExt::read_overlapped)>,
+                              "Derived must implement read_overlapped");
+                return static_cast<Derived*>(this)->read_overlapped(buf, overlapped);
+            }
+
+            /// Asynchronously send data on this stream
+            Result<std::optional<std::size_t>> write_overlapped(gsl::span<const uint8_t> buf,
+                                                                OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::write_overlapped),
+                                              decltype(&TcpStreamExt::write_overlapped)>,
+                              "Derived must implement write_overlapped");
+                return static_cast<Derived*>(this)->write_overlapped(buf, overlapped);
+            }
+
+            /// Asynchronously receive data from this stream into several buffers
+            Result<std::optional<std::size_t>> read_vectored_overlapped(gsl::span<net::IoSpanMut> bufs,
+                                                                        OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::read_vectored_overlapped),
+                                              decltype(&TcpStreamExt::read_vectored_overlapped)>,
+                              "Derived must implement read_vectored_overlapped");
+                return static_cast<Derived*>(this)->read_vectored_overlapped(bufs, overlapped);
+            }
+
+            /// Asynchronously send data from several buffers on this stream
+            Result<std::optional<std::size_t>> write_vectored_overlapped(gsl::span<const net::IoSpan> bufs,
+                                                                         OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::write_vectored_overlapped),
+                                              decltype(&TcpStreamExt::write_vectored_overlapped)>,
+                              "Derived must implement write_vectored_overlapped");
+                return static_cast<Derived*>(this)->write_vectored_overlapped(bufs, overlapped);
+            }
+
+            /// Asynchronously connect this stream to a remote address
+            Result<std::optional<std::size_t>> connect_overlapped(const net::SocketAddr& address,
+                                                                  gsl::span<const uint8_t> buf,
+                                                                  OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::connect_overlapped),
+                                              decltype(&TcpStreamExt::connect_overlapped)>,
+                              "Derived must implement connect_overlapped");
+                return static_cast<Derived*>(this)->connect_overlapped(address, buf, overlapped);
+            }
+
+            /// Update context of this stream after a connect has completed
+            Result<std::monostate> connect_complete() noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::connect_complete),
+                                              decltype(&TcpStreamExt::connect_complete)>,
+                              "Derived must implement connect_complete");
+                return static_cast<Derived*>(this)->connect_complete();
+            }
 
-            virtual Result<std::optional<std::size_t>> read_overlapped(gsl::span<uint8_t> buf, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::optional<std::size_t>> write_overlapped(gsl::span<const uint8_t> buf, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::optional<std::size_t>> connect_overlapped(const SocketAddr& address, gsl::span<const uint8_t> buf, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::monostate> connect_complete() noexcept = 0;
-            virtual Result<std::tuple<std::size_t, unsigned long>> recv_overlapped(gsl::span<uint8_t> buf, OVERLAPPED* overlapped) noexcept = 0;
-            virtual ~TcpStreamExt() = default;
+            /// Retrieve the result of an overlapped operation on this stream
+            Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::result),
+                                              decltype(&TcpStreamExt::result)>,
+                              "Derived must implement result");
+                return static_cast<Derived*>(this)->result(overlapped);
+            }
 
-        };
+        }; // struct TcpStreamExt
 
     } // namespace net::interface
 
@@ -4,9 +4,11 @@
 
 #include <optional>
 #include <tuple>
+#include <type_traits>
 #include <variant>
 
 #include "gsl/span"
+#include "Result.h"
 
 #include "SocketAddr.h"
 #include "SocketAddrBuf.h"
@@ -20,21 +22,62 @@ namespace laio {
 
     using std::uint8_t;
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
-
     namespace net::interface {
 
+        /// Overlapped extensions of a UDP socket, modelled after miow's `UdpSocketExt`
+        ///
+        /// \details Static interface, which forwards every call to the implementation without virtual dispatch, so that
+        /// generic code over sockets inlines down to the Winsock call and sockets carry no vtable pointer. An
+        /// implementation must define every member it is called through, which each member asserts, as an inherited
+        /// one would forward to itself.
+        template<typename Derived>
         struct UdpSocketExt {
+            // # Public member functions
+
+            /// Asynchronously receive a datagram and the address it has been sent from
+            Result<std::optional<std::size_t>> recv_from_overlapped(gsl::span<uint8_t> buf, SocketAddrBuf* address,
+                                                                    OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::recv_from_overlapped),
+                                              decltype(&UdpSocketExt::recv_from_overlapped)>,
+                              "Derived must implement recv_from_overlapped");
+                return static_cast<Derived*>(this)->recv_from_overlapped(buf, address, overlapped);
+            }
+
+            /// Asynchronously receive a datagram from the connected address
+            Result<std::optional<std::size_t>> recv_overlapped(gsl::span<uint8_t> buf, OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::recv_overlapped),
+                                              decltype(&UdpSocketExt::recv_overlapped)>,
+                              "Derived must implement recv_overlapped");
+                return static_cast<Derived*>(this)->recv_overlapped(buf, overlapped);
+            }
+
+            /// Asynchronously send a datagram to the provided address
+            Result<std::optional<std::size_t>> send_to_overlapped(gsl::span<const uint8_t> buf, net::SocketAddr& address,
+                                                                  OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::send_to_overlapped),
+                                              decltype(&UdpSocketExt::send_to_overlapped)>,
+                              "Derived must implement send_to_overlapped");
+                return static_cast<Derived*>(this)->send_to_overlapped(buf, address, overlapped);
+            }
+
+            /// Asynchronously send a datagram to the connected address
+            Result<std::optional<std::size_t>> send_overlapped(gsl::span<const uint8_t> buf,
+                                                               OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::send_overlapped),
+                                              decltype(&UdpSocketExt::send_overlapped)>,
+                              "Derived must implement send_overlapped");
+                return static_cast<Derived*>(this)->send_overlapped(buf, overlapped);
+            }
 
-            virtual Result<std::optional<std::size_t>> recv_from_overlapped(gsl::span<uint8_t> buf, SocketAddrBuf* address, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::optional<std::size_t>> recv_overlapped(gsl::span<uint8_t> buf, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::optional<std::size_t>> send_to_overlapped(gsl::span<const uint8_t> buf, SocketAddr& address, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::optional<std::size_t>> send_overlapped(gsl::span<const uint8_t> buf, OVERLAPPED* overlapped) noexcept = 0;
-            virtual Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept = 0;
-            virtual ~UdpSocketExt() = default;
+            /// Retrieve the result of an overlapped operation on this socket
+            Result<std::tuple<std::size_t, unsigned long>> result(OVERLAPPED* overlapped) noexcept {
+                static_assert(!std::is_same_v<decltype(&Derived::result),
+                                              decltype(&UdpSocketExt::result)>,
+                              "Derived must implement result");
+                return static_cast<Derived*>(this)->result(overlapped);
+            }
 
-        };
+        }; // struct UdpSocketExt
 
     } // namespace net::interface
 
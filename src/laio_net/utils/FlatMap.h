@@ -0,0 +1,392 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define LAIO_FLATMAP_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define LAIO_FLATMAP_SSE2 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace laio::net {
+
+    using std::int8_t;
+    using std::uint32_t;
+    using std::uint64_t;
+
+    namespace detail {
+
+        /// Number of control bytes probed at once
+        constexpr std::size_t GROUP_WIDTH = 16;
+
+        constexpr int8_t CTRL_EMPTY = -128;     ///< Control byte of a slot that has never been used
+        constexpr int8_t CTRL_DELETED = -2;     ///< Control byte of a slot whose entry has been erased
+
+        /// Return bit mask of the control bytes of a group equal to the value
+        inline uint32_t match_byte(const int8_t* group, int8_t value) noexcept {
+#if LAIO_FLATMAP_SSE2
+            const __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+            uint32_t mask = 0;
+            for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+                mask |= static_cast<uint32_t>(group[i] == value) << i;
+            }
+            return mask;
+#endif
+        }
+
+        /// Return bit mask of the empty or deleted control bytes of a group
+        inline uint32_t match_free(const int8_t* group) noexcept {
+#if LAIO_FLATMAP_SSE2
+            // Only empty and deleted control bytes have their sign bit set
+            const __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+            return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+            uint32_t mask = 0;
+            for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+                mask |= static_cast<uint32_t>(group[i] < 0) << i;
+            }
+            return mask;
+#endif
+        }
+
+        /// Return index of the lowest set bit of a non-zero mask
+        inline unsigned lowest_bit(uint32_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+    } // namespace detail
+
+    /// Open-addressing hash map with SIMD probing of groups of control bytes
+    ///
+    /// \details Follows the design of Abseil's Swiss tables: every slot has a control byte holding 7 bits of the hash
+    /// of its key, or marking it as empty or deleted. A lookup compares the control bytes of a group of 16 slots
+    /// against the hash with a single SSE2 comparison, so that keys are only compared on a probable match, and stops
+    /// at the first group with an empty slot. Groups are probed quadratically. Entries are stored inline, which suits
+    /// small trivially copyable keys such as `FiveTuple`, and are relocated on growth, so that references to entries
+    /// are invalidated by insertion. The map grows once 7/8 of its slots are used. It is not synchronized.
+    ///
+    /// \tparam K Key type
+    /// \tparam V Mapped type
+    /// \tparam Hash Hash function of the keys, whose result is mixed again, so that weak hashes are acceptable
+    /// \tparam Eq Equality of the keys
+    template<typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+    class FlatMap {
+
+        using Slot_ = std::pair<K, V>;
+
+        static constexpr std::size_t ALIGNMENT_ = alignof(Slot_) > 16 ? alignof(Slot_) : 16;
+
+        int8_t* ctrl_ = nullptr;            ///< Control bytes, one per slot
+        Slot_* slots_ = nullptr;            ///< Slots following the control bytes in the same allocation
+        std::size_t capacity_ = 0;          ///< Number of slots, a power of two and a multiple of the group width
+        std::size_t size_ = 0;              ///< Number of entries
+        std::size_t growth_left_ = 0;       ///< Number of empty slots that may be filled before growing
+        Hash hash_{};
+        Eq eq_{};
+
+    public:
+        // # Constructors
+        FlatMap() noexcept = default;
+
+        FlatMap(const FlatMap& other) = delete;
+
+        FlatMap(FlatMap&& other) noexcept
+            : ctrl_{other.ctrl_}, slots_{other.slots_}, capacity_{other.capacity_}, size_{other.size_},
+              growth_left_{other.growth_left_}, hash_{std::move(other.hash_)}, eq_{std::move(other.eq_)}
+        {
+            other.ctrl_ = nullptr;
+            other.slots_ = nullptr;
+            other.capacity_ = 0;
+            other.size_ = 0;
+            other.growth_left_ = 0;
+        }
+
+        // # Destructor
+        ~FlatMap() noexcept {
+            release_();
+        }
+
+        // # Operator overloads
+        FlatMap& operator=(const FlatMap& rhs) = delete;
+
+        FlatMap& operator=(FlatMap&& rhs) noexcept {
+            if (this != &rhs) {
+                release_();
+                ctrl_ = rhs.ctrl_;
+                slots_ = rhs.slots_;
+                capacity_ = rhs.capacity_;
+                size_ = rhs.size_;
+                growth_left_ = rhs.growth_left_;
+                hash_ = std::move(rhs.hash_);
+                eq_ = std::move(rhs.eq_);
+                rhs.ctrl_ = nullptr;
+                rhs.slots_ = nullptr;
+                rhs.capacity_ = 0;
+                rhs.size_ = 0;
+                rhs.growth_left_ = 0;
+            }
+            return *this;
+        }
+
+        // # Public member functions
+
+        /// Look up the value of a key
+        ///
+        /// \return Pointer to the value, `nullptr` if the key is not in the map
+        [[nodiscard]] V* find(const K& key) noexcept {
+            Slot_* slot = find_(key);
+            return slot ? &slot->second : nullptr;
+        }
+
+        /// Look up the value of a key
+        ///
+        /// \return Pointer to the value, `nullptr` if the key is not in the map
+        [[nodiscard]] const V* find(const K& key) const noexcept {
+            const Slot_* slot = const_cast<FlatMap*>(this)->find_(key);
+            return slot ? &slot->second : nullptr;
+        }
+
+        /// Return `true` if the key is in the map
+        [[nodiscard]] bool contains(const K& key) const noexcept {
+            return find(key) != nullptr;
+        }
+
+        /// Insert value constructed from the arguments, unless the key is already in the map
+        ///
+        /// \return Pair of a pointer to the value of the key and `true` if the value has been inserted
+        template<typename... Args>
+        std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+            const uint64_t hash = hash_of_(key);
+            if (Slot_* slot = find_(key, hash)) {
+                return {&slot->second, false};
+            }
+            if (growth_left_ == 0) {
+                grow_();
+            }
+            const std::size_t index = free_slot_(hash);
+            growth_left_ -= ctrl_[index] == detail::CTRL_EMPTY;
+            Slot_* slot = new (slots_ + index) Slot_{std::piecewise_construct, std::forward_as_tuple(key),
+                                                     std::forward_as_tuple(std::forward<Args>(args)...)};
+            ctrl_[index] = h2_(hash);
+            ++size_;
+            return {&slot->second, true};
+        }
+
+        /// Insert value or assign it to the key, if the key is already in the map
+        ///
+        /// \return `true` if the value has been inserted, `false` if it has been assigned
+        bool insert_or_assign(const K& key, V value) {
+            auto [slot, inserted] = try_emplace(key, std::move(value));
+            if (!inserted) {
+                *slot = std::move(value);
+            }
+            return inserted;
+        }
+
+        /// Remove the entry of the key
+        ///
+        /// \return `true` if the key has been in the map
+        bool erase(const K& key) noexcept {
+            Slot_* slot = find_(key);
+            if (!slot) {
+                return false;
+            }
+            const auto index = static_cast<std::size_t>(slot - slots_);
+            slot->~Slot_();
+            --size_;
+
+            // Probing never passes a group with an empty slot, so no other key depends on this slot being taken
+            const int8_t* group = ctrl_ + (index & ~(detail::GROUP_WIDTH - 1));
+            if (detail::match_byte(group, detail::CTRL_EMPTY)) {
+                ctrl_[index] = detail::CTRL_EMPTY;
+                ++growth_left_;
+            } else {
+                ctrl_[index] = detail::CTRL_DELETED;
+            }
+            return true;
+        }
+
+        /// Invoke function with key and value of every entry, in unspecified order
+        template<typename F>
+        void for_each(F&& f) {
+            for (std::size_t i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] >= 0) {
+                    f(static_cast<const K&>(slots_[i].first), slots_[i].second);
+                }
+            }
+        }
+
+        /// Remove all entries, keeping the allocated slots
+        void clear() noexcept {
+            destroy_();
+            if (capacity_) {
+                std::memset(ctrl_, detail::CTRL_EMPTY, capacity_);
+            }
+            size_ = 0;
+            growth_left_ = max_load_(capacity_);
+        }
+
+        /// Allocate slots for at least the number of entries
+        void reserve(std::size_t count) {
+            std::size_t capacity = capacity_ ? capacity_ : detail::GROUP_WIDTH;
+            while (max_load_(capacity) < count) {
+                capacity *= 2;
+            }
+            if (capacity > capacity_) {
+                rehash_(capacity);
+            }
+        }
+
+        /// Return number of entries
+        [[nodiscard]] std::size_t size() const noexcept {
+            return size_;
+        }
+
+        /// Return `true` if the map has no entries
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        /// Return number of slots
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return capacity_;
+        }
+
+    private:
+        static constexpr std::size_t max_load_(std::size_t capacity) noexcept {
+            return capacity - capacity / 8;
+        }
+
+        /// Mix the hash, as the probe position is taken from its low and the control byte from its high bits
+        uint64_t hash_of_(const K& key) const noexcept {
+            uint64_t hash = static_cast<uint64_t>(hash_(key));
+            hash ^= hash >> 32u;
+            hash *= 0x9e3779b97f4a7c15ull;
+            return hash ^ hash >> 29u;
+        }
+
+        static int8_t h2_(uint64_t hash) noexcept {
+            return static_cast<int8_t>(hash >> 57u);
+        }
+
+        std::size_t first_group_(uint64_t hash) const noexcept {
+            return static_cast<std::size_t>(hash) & (capacity_ / detail::GROUP_WIDTH - 1);
+        }
+
+        Slot_* find_(const K& key) noexcept {
+            return find_(key, hash_of_(key));
+        }
+
+        Slot_* find_(const K& key, uint64_t hash) noexcept {
+            if (capacity_ == 0) {
+                return nullptr;
+            }
+            const std::size_t mask = capacity_ / detail::GROUP_WIDTH - 1;
+            const int8_t h2 = h2_(hash);
+            std::size_t group = first_group_(hash);
+            for (std::size_t step = 1;; ++step) {
+                const int8_t* ctrl = ctrl_ + group * detail::GROUP_WIDTH;
+                for (uint32_t match = detail::match_byte(ctrl, h2); match; match &= match - 1) {
+                    Slot_* slot = slots_ + group * detail::GROUP_WIDTH + detail::lowest_bit(match);
+                    if (eq_(slot->first, key)) {
+                        return slot;
+                    }
+                }
+                if (detail::match_byte(ctrl, detail::CTRL_EMPTY)) {
+                    return nullptr;
+                }
+                group = (group + step) & mask;
+            }
+        }
+
+        /// Find the first empty or deleted slot on the probe sequence of the hash
+        std::size_t free_slot_(uint64_t hash) const noexcept {
+            const std::size_t mask = capacity_ / detail::GROUP_WIDTH - 1;
+            std::size_t group = first_group_(hash);
+            for (std::size_t step = 1;; ++step) {
+                if (const uint32_t match = detail::match_free(ctrl_ + group * detail::GROUP_WIDTH)) {
+                    return group * detail::GROUP_WIDTH + detail::lowest_bit(match);
+                }
+                group = (group + step) & mask;
+            }
+        }
+
+        /// Double the slots, or only drop deleted slots if at most half of the slots hold entries
+        void grow_() {
+            if (capacity_ == 0) {
+                rehash_(detail::GROUP_WIDTH);
+            } else {
+                rehash_(size_ > capacity_ / 2 ? capacity_ * 2 : capacity_);
+            }
+        }
+
+        void rehash_(std::size_t capacity) {
+            const std::size_t offset = (capacity + alignof(Slot_) - 1) / alignof(Slot_) * alignof(Slot_);
+            void* memory = ::operator new(offset + capacity * sizeof(Slot_), std::align_val_t{ALIGNMENT_});
+            auto* ctrl = static_cast<int8_t*>(memory);
+            auto* slots = reinterpret_cast<Slot_*>(static_cast<char*>(memory) + offset);
+            std::memset(ctrl, detail::CTRL_EMPTY, capacity);
+
+            int8_t* oldCtrl = ctrl_;
+            Slot_* oldSlots = slots_;
+            const std::size_t oldCapacity = capacity_;
+            ctrl_ = ctrl;
+            slots_ = slots;
+            capacity_ = capacity;
+            growth_left_ = max_load_(capacity) - size_;
+
+            for (std::size_t i = 0; i < oldCapacity; ++i) {
+                if (oldCtrl[i] >= 0) {
+                    const uint64_t hash = hash_of_(oldSlots[i].first);
+                    const std::size_t index = free_slot_(hash);
+                    new (slots_ + index) Slot_{std::move(oldSlots[i])};
+                    ctrl_[index] = h2_(hash);
+                    oldSlots[i].~Slot_();
+                }
+            }
+            if (oldCtrl) {
+                ::operator delete(oldCtrl, std::align_val_t{ALIGNMENT_});
+            }
+        }
+
+        void destroy_() noexcept {
+            if constexpr (!std::is_trivially_destructible_v<Slot_>) {
+                for (std::size_t i = 0; i < capacity_; ++i) {
+                    if (ctrl_[i] >= 0) {
+                        slots_[i].~Slot_();
+                    }
+                }
+            }
+        }
+
+        void release_() noexcept {
+            if (ctrl_) {
+                destroy_();
+                ::operator delete(ctrl_, std::align_val_t{ALIGNMENT_});
+                ctrl_ = nullptr;
+                slots_ = nullptr;
+            }
+        }
+
+    }; // class FlatMap
+
+} // namespace laio::net
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+#include "fmt/format.h"
+
+namespace laio::net::format {
+
+    using std::uint8_t;
+    using std::uint16_t;
+    using std::uint32_t;
+
+    namespace detail {
+
+        /// Decimal representations of all byte values, three characters each followed by the number of digits
+        struct DecimalBytes {
+            char digits[256][4]{};
+
+            constexpr DecimalBytes() noexcept {
+                for (int value = 0; value < 256; ++value) {
+                    const int len = value >= 100 ? 3 : value >= 10 ? 2 : 1;
+                    int rest = value;
+                    for (int i = len - 1; i >= 0; --i) {
+                        digits[value][i] = static_cast<char>('0' + rest % 10);
+                        rest /= 10;
+                    }
+                    digits[value][3] = static_cast<char>(len);
+                }
+            }
+        };
+
+        inline constexpr DecimalBytes DECIMAL_BYTES{};
+
+        inline constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    } // namespace detail
+
+    /// Write decimal byte without leading zeros
+    ///
+    /// \details Always copies four bytes, so the output must have room for four characters.
+    inline char* byte(char* out, uint8_t value) noexcept {
+        std::memcpy(out, detail::DECIMAL_BYTES.digits[value], 4);
+        return out + detail::DECIMAL_BYTES.digits[value][3];
+    }
+
+    /// Write unsigned integer in decimal notation
+    ///
+    /// \details The output must have room for ten characters.
+    inline char* decimal(char* out, uint32_t value) noexcept {
+        return std::to_chars(out, out + 10, value).ptr;
+    }
+
+    /// Write 16-bit group in lower-case hexadecimal notation without leading zeros
+    ///
+    /// \details The output must have room for four characters.
+    inline char* hex16(char* out, uint16_t value) noexcept {
+        const int len = value >= 0x1000 ? 4 : value >= 0x100 ? 3 : value >= 0x10 ? 2 : 1;
+        for (int i = len - 1; i >= 0; --i) {
+            out[i] = detail::HEX_DIGITS[value & 0xfu];
+            value = static_cast<uint16_t>(value >> 4u);
+        }
+        return out + len;
+    }
+
+    /// Longest IPv4 address text: `255.255.255.255`
+    constexpr std::size_t IPV4_MAX_LEN = 15;
+
+    /// Longest IPv6 address text: eight groups of four digits and seven separators
+    constexpr std::size_t IPV6_MAX_LEN = 39;
+
+    /// Write IPv4 address in dotted-decimal notation
+    ///
+    /// \details The output must have room for `IPV4_MAX_LEN + 1` characters, as every octet is copied as a whole.
+    ///
+    /// \param out Start of output
+    /// \param a,b,c,d Octets of the address in network order
+    /// \return End of the written text
+    inline char* ipv4(char* out, uint8_t a, uint8_t b, uint8_t c, uint8_t d) noexcept {
+        out = byte(out, a);
+        *out++ = '.';
+        out = byte(out, b);
+        *out++ = '.';
+        out = byte(out, c);
+        *out++ = '.';
+        return byte(out, d);
+    }
+
+    /// Write IPv6 address in the canonical notation of RFC 5952
+    ///
+    /// \details Groups are written in lower-case hexadecimal without leading zeros, and the first longest run of two
+    /// or more zero groups is replaced by `::`. IPv4-mapped addresses, and IPv4-compatible addresses with a
+    /// non-zero seventh group, end in dotted-decimal notation, in agreement with `inet_ntop`. The output must have
+    /// room for `IPV6_MAX_LEN + 1` characters.
+    ///
+    /// \param out Start of output
+    /// \param segments Groups of the address in host order
+    /// \return End of the written text
+    inline char* ipv6(char* out, const uint16_t (&segments)[8]) noexcept {
+        const auto [a, b, c, d, e, f, g, h] = segments;
+
+        // IPv4-mapped addresses, and IPv4-compatible addresses whose seventh group is set, end in dotted-decimal
+        if (!a && !b && !c && !d && !e && (f == 0xff'ff || (!f && g))) {
+            std::memcpy(out, "::ffff:", 7);
+            out += f ? 7 : 2;
+            return ipv4(out, static_cast<uint8_t>(g >> 8u), static_cast<uint8_t>(g),
+                        static_cast<uint8_t>(h >> 8u), static_cast<uint8_t>(h));
+        }
+
+        // Determine the first longest span of consecutive zero-segments
+        int zeroAt = 0;
+        int zeroLen = 0;
+        for (int i = 0; i < 8;) {
+            if (segments[i]) {
+                ++i;
+                continue;
+            }
+            int j = i;
+            while (j < 8 && !segments[j]) ++j;
+            if (j - i > zeroLen) {
+                zeroAt = i;
+                zeroLen = j - i;
+            }
+            i = j;
+        }
+        if (zeroLen < 2) {
+            zeroAt = 8;
+            zeroLen = 0;
+        }
+
+        for (int i = 0; i < zeroAt; ++i) {
+            if (i) *out++ = ':';
+            out = hex16(out, segments[i]);
+        }
+        if (zeroLen) {
+            *out++ = ':';
+            *out++ = ':';
+        }
+        for (int i = zeroAt + zeroLen; i < 8; ++i) {
+            if (i != zeroAt + zeroLen) *out++ = ':';
+            out = hex16(out, segments[i]);
+        }
+        return out;
+    }
+
+    /// Copy text formatted into a scratch buffer to the output range
+    ///
+    /// \param first Start of output
+    /// \param last End of output
+    /// \param text Start of formatted text
+    /// \param end End of formatted text
+    /// \return Result with end of the written text, or `std::errc::value_too_large` if the output range is too small
+    inline std::to_chars_result copy(char* first, char* last, const char* text, const char* end) noexcept {
+        const std::size_t len = static_cast<std::size_t>(end - text);
+        if (static_cast<std::size_t>(last - first) < len) return {last, std::errc::value_too_large};
+        std::memcpy(first, text, len);
+        return {first + len, std::errc{}};
+    }
+
+    /// Base of the fmt formatters of the address types
+    ///
+    /// \details Formats through the allocation-free `to_chars` of the type into a stack buffer, and then pads and
+    /// aligns the text like a string, so that format specifications such as `{:>40}` apply.
+    template<typename T>
+    struct ToCharsFormatter : fmt::formatter<fmt::string_view> {
+        template<typename FormatContext>
+        auto format(const T& value, FormatContext& ctx) const {
+            char buf[T::MAX_STR_LEN];
+            const std::to_chars_result res = value.to_chars(buf, buf + sizeof buf);
+            return fmt::formatter<fmt::string_view>::format(
+                    fmt::string_view{buf, static_cast<std::size_t>(res.ptr - buf)}, ctx);
+        }
+    };
+
+} // namespace laio::net::format
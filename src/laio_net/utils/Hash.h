@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace laio::net::hash {
+
+    using std::uint64_t;
+
+    /// Scramble all bits of a 64-bit integer into all bits of the result
+    ///
+    /// \details Finalizer of MurmurHash3, which is a bijection with full avalanche, so that hash tables may index by
+    /// any subset of the bits of the result. The hashes of the address types are not keyed and therefore not meant to
+    /// withstand deliberately colliding keys.
+    constexpr uint64_t mix(uint64_t x) noexcept {
+        x ^= x >> 33u;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33u;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33u;
+        return x;
+    }
+
+    /// Fold a further 64-bit integer into a hash
+    ///
+    /// \details The order of the values matters, i.e. combining `a` and then `b` differs from `b` and then `a`.
+    constexpr uint64_t combine(uint64_t seed, uint64_t value) noexcept {
+        return mix((seed << 23u | seed >> 41u) ^ value ^ 0x9e3779b97f4a7c15ull);
+    }
+
+} // namespace laio::net::hash
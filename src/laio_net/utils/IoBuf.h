@@ -0,0 +1,346 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "gsl/span"
+
+#include "IoSpan.h"
+#include "IoSpanMut.h"
+
+namespace laio::net {
+
+    using std::uint8_t;
+    using std::uint32_t;
+
+    namespace detail {
+
+        /// Header of a reference-counted block, which is directly followed by its bytes
+        struct IoBlock {
+            std::atomic<uint32_t> refs;     ///< Number of slices referring to the block
+            std::size_t capacity;           ///< Number of bytes following the header
+
+            /// Return first byte of the block
+            uint8_t* data() noexcept {
+                return reinterpret_cast<uint8_t*>(this + 1);
+            }
+
+            /// Allocate a block with a single reference
+            ///
+            /// \details Throws `std::bad_alloc` if the allocation fails.
+            static IoBlock* allocate(std::size_t capacity) {
+                void* raw = ::operator new(sizeof(IoBlock) + capacity);
+                return new(raw) IoBlock{{1}, capacity};
+            }
+
+            /// Take another reference
+            void retain() noexcept {
+                refs.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /// Drop a reference and free the block with the last one
+            void release() noexcept {
+                if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    this->~IoBlock();
+                    ::operator delete(static_cast<void*>(this));
+                }
+            }
+        };
+
+    } // namespace detail
+
+    /// Window into a reference-counted block of bytes
+    ///
+    /// \details Copying a slice takes another reference to the block instead of copying its bytes, and splitting or
+    /// trimming a slice only moves its window. The block is freed once the last slice referring to it is gone. Bytes
+    /// may only be written through a slice while it is the only one referring to its block, e.g. when it has just been
+    /// allocated to receive into.
+    class IoSlice {
+
+        detail::IoBlock* block_ = nullptr;  ///< Block the window lies in, `nullptr` if empty
+        uint8_t* data_ = nullptr;           ///< First byte of the window
+        std::size_t size_ = 0;              ///< Number of bytes in the window
+
+        IoSlice(detail::IoBlock* block, uint8_t* data, std::size_t size) noexcept
+            : block_{block}, data_{data}, size_{size} {}
+
+    public:
+        // # Constructors
+
+        /// Create empty slice, which refers to no block
+        IoSlice() noexcept = default;
+
+        IoSlice(const IoSlice& other) noexcept
+            : block_{other.block_}, data_{other.data_}, size_{other.size_} {
+            if (block_ != nullptr) block_->retain();
+        }
+
+        IoSlice(IoSlice&& other) noexcept
+            : block_{std::exchange(other.block_, nullptr)},
+              data_{std::exchange(other.data_, nullptr)},
+              size_{std::exchange(other.size_, 0)} {}
+
+        ~IoSlice() {
+            if (block_ != nullptr) block_->release();
+        }
+
+        // # Operator overloads
+        IoSlice& operator=(IoSlice other) noexcept {
+            std::swap(block_, other.block_);
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+
+        // # Public member functions
+
+        /// Allocate a block and return a slice over all of its uninitialized bytes
+        ///
+        /// \details Throws `std::bad_alloc` if the allocation fails.
+        static IoSlice allocate(std::size_t size) {
+            if (size == 0) return IoSlice{};
+            detail::IoBlock* block = detail::IoBlock::allocate(size);
+            return IoSlice{block, block->data(), size};
+        }
+
+        /// Allocate a block holding a copy of the provided bytes
+        ///
+        /// \details Throws `std::bad_alloc` if the allocation fails.
+        static IoSlice copy_of(gsl::span<const uint8_t> bytes) {
+            IoSlice slice = allocate(bytes.size_bytes());
+            if (!bytes.empty()) std::memcpy(slice.data_, bytes.data(), bytes.size_bytes());
+            return slice;
+        }
+
+        /// Return number of bytes
+        [[nodiscard]] std::size_t size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        /// Return whether this is the only slice referring to its block, so that its bytes can be written
+        [[nodiscard]] bool unique() const noexcept {
+            return block_ == nullptr || block_->refs.load(std::memory_order_acquire) == 1;
+        }
+
+        /// Return bytes as span
+        [[nodiscard]] gsl::span<const uint8_t> as_span() const noexcept {
+            return gsl::span<const uint8_t>{data_, size_};
+        }
+
+        /// Return bytes as mutable span, which must only be written while the slice is unique
+        [[nodiscard]] gsl::span<uint8_t> as_mut_span() noexcept {
+            return gsl::span<uint8_t>{data_, size_};
+        }
+
+        /// Split off and return the first bytes, keeping the rest
+        ///
+        /// \param at Number of bytes to split off, clamped to the size
+        IoSlice split_to(std::size_t at) noexcept {
+            at = (std::min)(at, size_);
+            IoSlice front{*this};
+            front.size_ = at;
+            trim_front(at);
+            return front;
+        }
+
+        /// Split off and return the last bytes, keeping the first
+        ///
+        /// \param at Number of bytes to keep, clamped to the size
+        IoSlice split_off(std::size_t at) noexcept {
+            at = (std::min)(at, size_);
+            IoSlice back{*this};
+            back.trim_front(at);
+            size_ = at;
+            return back;
+        }
+
+        /// Drop the first bytes
+        ///
+        /// \param n Number of bytes to drop, clamped to the size
+        void trim_front(std::size_t n) noexcept {
+            n = (std::min)(n, size_);
+            data_ += n;
+            size_ -= n;
+        }
+
+        /// Drop the last bytes
+        ///
+        /// \param n Number of bytes to drop, clamped to the size
+        void trim_back(std::size_t n) noexcept {
+            size_ -= (std::min)(n, size_);
+        }
+
+    }; // class IoSlice
+
+    /// Chain of slices, which is sent and received through vectored overlapped operations
+    ///
+    /// \details Modelled after folly's `IOBuf`: appending, splitting and trimming a chain moves slices and windows
+    /// around without copying any bytes, so that a message can be assembled from a header and a payload, or a
+    /// received stream cut into frames, on the way between two operations. `spans` lays the chain out as the buffer
+    /// array of `TcpStream::write_vectored_overlapped`, and `mut_spans` as that of `read_vectored_overlapped`. The
+    /// chain must keep its slices until the operation has completed, while the span array may go once the call has
+    /// returned.
+    class IoBuf {
+
+        std::vector<IoSlice> slices_{};     ///< Non-empty slices in order
+        std::size_t size_ = 0;              ///< Number of bytes in all slices
+
+    public:
+        // # Constructors
+
+        /// Create empty chain
+        IoBuf() noexcept = default;
+
+        /// Create chain of a single slice
+        explicit IoBuf(IoSlice slice) {
+            append(std::move(slice));
+        }
+
+        // # Public member functions
+
+        /// Return number of bytes in all slices
+        [[nodiscard]] std::size_t size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        /// Return slices in order, all of which are non-empty
+        [[nodiscard]] gsl::span<const IoSlice> slices() const noexcept {
+            return gsl::span<const IoSlice>{slices_.data(), slices_.size()};
+        }
+
+        /// Append slice to the end of this chain, empty slices are dropped
+        void append(IoSlice slice) {
+            if (slice.empty()) return;
+            size_ += slice.size();
+            slices_.push_back(std::move(slice));
+        }
+
+        /// Append all slices of another chain to the end of this chain, appending a chain to itself does nothing
+        void append(IoBuf&& other) {
+            if (&other == this) return;
+            if (slices_.empty()) {
+                std::swap(slices_, other.slices_);
+            } else {
+                slices_.insert(slices_.end(),
+                               std::make_move_iterator(other.slices_.begin()),
+                               std::make_move_iterator(other.slices_.end()));
+                other.slices_.clear();
+            }
+            size_ += std::exchange(other.size_, 0);
+        }
+
+        /// Prepend slice to the front of this chain, e.g. a header to its payload, empty slices are dropped
+        void prepend(IoSlice slice) {
+            if (slice.empty()) return;
+            size_ += slice.size();
+            slices_.insert(slices_.begin(), std::move(slice));
+        }
+
+        /// Split off and return the first bytes, keeping the rest
+        ///
+        /// \details Splits at most one slice in two, which then share its block.
+        ///
+        /// \param at Number of bytes to split off, clamped to the size
+        IoBuf split_to(std::size_t at) {
+            at = (std::min)(at, size_);
+            IoBuf front{};
+            std::size_t whole = 0;
+            while (whole < slices_.size() && slices_[whole].size() <= at - front.size_) {
+                front.size_ += slices_[whole].size();
+                ++whole;
+            }
+            front.slices_.reserve(whole + 1);
+            front.slices_.insert(front.slices_.end(),
+                                 std::make_move_iterator(slices_.begin()),
+                                 std::make_move_iterator(slices_.begin() + static_cast<std::ptrdiff_t>(whole)));
+            slices_.erase(slices_.begin(), slices_.begin() + static_cast<std::ptrdiff_t>(whole));
+            if (front.size_ < at) {
+                front.append(slices_.front().split_to(at - front.size_));
+            }
+            size_ -= at;
+            return front;
+        }
+
+        /// Drop the first bytes
+        ///
+        /// \param n Number of bytes to drop, clamped to the size
+        void trim_front(std::size_t n) noexcept {
+            n = (std::min)(n, size_);
+            size_ -= n;
+            std::size_t whole = 0;
+            while (whole < slices_.size() && slices_[whole].size() <= n) {
+                n -= slices_[whole].size();
+                ++whole;
+            }
+            slices_.erase(slices_.begin(), slices_.begin() + static_cast<std::ptrdiff_t>(whole));
+            if (n != 0) slices_.front().trim_front(n);
+        }
+
+        /// Drop the last bytes, e.g. the unused tail of a receive
+        ///
+        /// \param n Number of bytes to drop, clamped to the size
+        void trim_back(std::size_t n) noexcept {
+            n = (std::min)(n, size_);
+            size_ -= n;
+            while (!slices_.empty() && slices_.back().size() <= n) {
+                n -= slices_.back().size();
+                slices_.pop_back();
+            }
+            if (n != 0) slices_.back().trim_back(n);
+        }
+
+        /// Lay out the slices as buffers of a vectored send
+        ///
+        /// \param out Buffers to fill, one per slice
+        /// \return Number of buffers filled, which is less than the number of slices if `out` is too short
+        std::size_t spans(gsl::span<IoSpan> out) const noexcept {
+            const std::size_t count = (std::min)(slices_.size(), static_cast<std::size_t>(out.size()));
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = IoSpan{slices_[i].as_span()};
+            }
+            return count;
+        }
+
+        /// Lay out the slices as buffers of a vectored receive, all of which must be unique
+        ///
+        /// \param out Buffers to fill, one per slice
+        /// \return Number of buffers filled, which is less than the number of slices if `out` is too short
+        std::size_t mut_spans(gsl::span<IoSpanMut> out) noexcept {
+            const std::size_t count = (std::min)(slices_.size(), static_cast<std::size_t>(out.size()));
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = IoSpanMut{slices_[i].as_mut_span()};
+            }
+            return count;
+        }
+
+        /// Copy the first bytes into a contiguous buffer
+        ///
+        /// \param out Buffer to copy into
+        /// \return Number of bytes copied
+        std::size_t copy_to(gsl::span<uint8_t> out) const noexcept {
+            std::size_t copied = 0;
+            for (const IoSlice& slice : slices_) {
+                const std::size_t n = (std::min)(slice.size(), static_cast<std::size_t>(out.size()) - copied);
+                if (n == 0) break;
+                std::memcpy(out.data() + copied, slice.as_span().data(), n);
+                copied += n;
+            }
+            return copied;
+        }
+
+    }; // class IoBuf
+
+} // namespace laio::net
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <WinSock2.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "gsl/span"
+
+namespace laio {
+
+    using std::uint8_t;
+
+    namespace net {
+
+        /// Immutable buffer of a vectored send
+        ///
+        /// \details Wraps a raw `WSABUF`, so that an array of spans is passed to Winsock as an array of buffers without
+        /// conversion. Winsock never writes through the buffers of a send, although `WSABUF` points to mutable bytes.
+        class IoSpan {
+
+            WSABUF raw_wsa_buffer_;     ///< Raw Winsock buffer
+
+        public:
+            // # Constructors
+
+            /// Borrow bytes to send, clamped to the length a single Winsock buffer can describe
+            IoSpan(gsl::span<const uint8_t> buf) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+                : raw_wsa_buffer_{
+                        static_cast<ULONG>((std::min)(buf.size_bytes(),
+                                static_cast<std::size_t>((std::numeric_limits<ULONG>::max)()))),
+                        reinterpret_cast<CHAR*>(const_cast<uint8_t*>(buf.data())),
+                  } {}
+
+            // # Public member functions
+
+            /// Return number of bytes
+            [[nodiscard]] constexpr std::size_t size() const noexcept {
+                return static_cast<std::size_t>(raw_wsa_buffer_.len);
+            }
+
+            /// Return bytes as span
+            [[nodiscard]] gsl::span<const uint8_t> as_span() const noexcept {
+                return gsl::span<const uint8_t>{reinterpret_cast<const uint8_t*>(raw_wsa_buffer_.buf), size()};
+            }
+
+        }; // class IoSpan
+
+        // Arrays of spans are handed to Winsock as arrays of buffers
+        static_assert(sizeof(IoSpan) == sizeof(WSABUF));
+
+    } // namespace net
+
+} // namespace laio
@@ -3,13 +3,14 @@
 
 #include <WinSock2.h>
 
+#include <algorithm>
+#include <limits>
 #include <variant>
 #include <gsl/span>
 
-namespace laio {
+#include "Result.h"
 
-    template<typename T>
-    using Result = std::variant<T, std::exception>;
+namespace laio {
 
     namespace net {
 
@@ -22,6 +23,14 @@ namespace laio {
             explicit constexpr IoSpanMut(WSABUF&& wsaBuffer) noexcept
                 : _raw_wsa_buffer{std::move(wsaBuffer)} {}  // NOLINT(hicpp-move-const-arg,performance-move-const-arg)
 
+            /// Borrow bytes to receive into, clamped to the length a single Winsock buffer can describe
+            explicit IoSpanMut(gsl::span<unsigned char> buf) noexcept
+                : _raw_wsa_buffer{
+                        static_cast<ULONG>((std::min)(buf.size_bytes(),
+                                static_cast<std::size_t>((std::numeric_limits<ULONG>::max)()))),
+                        reinterpret_cast<CHAR*>(buf.data()),
+                  } {}
+
             static inline IoSpanMut create(unsigned char buf[]) noexcept {
                 static_assert(sizeof(*buf) <= (std::numeric_limits<ULONG>::max)());
 
@@ -34,8 +43,8 @@ namespace laio {
             }
 
             inline Result<std::monostate> advance(std::size_t n) noexcept {
-                if (static_cast<std::size_t>(sizeof(_raw_wsa_buffer.len)) < n) {
-                    return std::out_of_range("Advancing out of range");
+                if (static_cast<std::size_t>(_raw_wsa_buffer.len) < n) {
+                    return Error{static_cast<wse::win_errc>(WSAEINVAL)};
                 }
                 _raw_wsa_buffer.len -= static_cast<ULONG>(n);
                 _raw_wsa_buffer.buf += n;
@@ -57,6 +66,9 @@ namespace laio {
             }
         };
 
+        // Arrays of spans are handed to Winsock as arrays of buffers
+        static_assert(sizeof(IoSpanMut) == sizeof(WSABUF));
+
     } // namespace net
 
 } // namespace laio
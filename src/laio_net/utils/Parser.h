@@ -0,0 +1,526 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+// SSE4.1 is implied by AVX on MSVC, which does not define the SSE macros on x64
+#if defined(__SSE4_1__) || defined(__AVX__)
+    #define LAIO_PARSER_SSE41 1
+    #include <smmintrin.h>
+#else
+    #define LAIO_PARSER_SSE41 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace laio::net::parser {
+
+    using std::uint8_t;
+    using std::uint16_t;
+    using std::uint32_t;
+
+    /// Octets of an IPv4 address in network order
+    using Ipv4Octets = std::array<uint8_t, 4>;
+
+    /// Parse dotted-decimal IPv4 address one character at a time
+    ///
+    /// \details Accepts exactly four octets of one to three decimal digits each, separated by single periods. Leading
+    /// zeros are permitted and are read as decimal. This is the reference implementation for the vectorized parser,
+    /// and is evaluated at compile time for address literals.
+    ///
+    /// \param text Address text without surrounding whitespace
+    /// \return Octets of the address if the text is well-formed, `std::nullopt` otherwise
+    constexpr std::optional<Ipv4Octets> ipv4_scalar(std::string_view text) noexcept {
+        uint16_t buf[4] = {0};
+        uint8_t pos = 0, octet = 0;
+        for (char c : text) {
+
+            // Each octet is representable with max 3 digits
+            if (c >= '0' && c <= '9' && pos < 3) {
+                buf[octet] = static_cast<uint16_t>(buf[octet] * 10 + (c - '0'));
+
+                // The maximum valid value an octet can hold is 255
+                if (buf[octet] > 255) return std::nullopt;
+                ++pos;
+            }
+
+            // There should be precisely 3 periods in the address, each at most 3 digits apart
+            else if (c == '.' && pos > 0 && octet < 3) {
+                pos = 0;
+                ++octet;
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        // The last octet must not be empty
+        if (octet != 3 || pos == 0) return std::nullopt;
+        return Ipv4Octets{
+            static_cast<uint8_t>(buf[0]),
+            static_cast<uint8_t>(buf[1]),
+            static_cast<uint8_t>(buf[2]),
+            static_cast<uint8_t>(buf[3])
+        };
+    }
+
+#if LAIO_PARSER_SSE41
+
+    namespace detail {
+
+        /// Shuffle masks gathering the digits of each octet into a right-aligned group of three bytes
+        ///
+        /// \details Indexed by the lengths of the four octets `(l0 - 1) * 27 + (l1 - 1) * 9 + (l2 - 1) * 3 + (l3 - 1)`.
+        /// Octet `i` occupies bytes `4i` to `4i + 3` as `[hundreds, tens, ones, 0]`; missing digits select byte 0x80,
+        /// which the shuffle turns into zero.
+        struct Ipv4Shuffles {
+            alignas(16) uint8_t masks[81][16]{};
+
+            constexpr Ipv4Shuffles() noexcept {
+                for (int index = 0; index < 81; ++index) {
+                    const int lengths[4] = {index / 27 + 1, index / 9 % 3 + 1, index / 3 % 3 + 1, index % 3 + 1};
+                    int start = 0;
+                    for (int octet = 0; octet < 4; ++octet) {
+                        for (int digit = 0; digit < 4; ++digit) {
+                            masks[index][octet * 4 + digit] = 0x80;
+                        }
+                        for (int digit = 0; digit < lengths[octet]; ++digit) {
+                            masks[index][octet * 4 + 3 - lengths[octet] + digit] = static_cast<uint8_t>(start + digit);
+                        }
+                        start += lengths[octet] + 1;
+                    }
+                }
+            }
+        };
+
+        inline constexpr Ipv4Shuffles IPV4_SHUFFLES{};
+
+        /// Return index of the lowest set bit
+        inline unsigned lowest_bit(unsigned mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+    } // namespace detail
+
+    /// Parse dotted-decimal IPv4 address with SSE4.1
+    ///
+    /// \details The whole address fits into a single 16-byte register, which is classified into digits and periods in
+    /// one pass. The positions of the periods select a shuffle, that lines up the digits of every octet, so that a
+    /// multiply-add computes all four octets at once. Accepts exactly what `ipv4_scalar` accepts.
+    ///
+    /// \param text Address text without surrounding whitespace
+    /// \return Octets of the address if the text is well-formed, `std::nullopt` otherwise
+    inline std::optional<Ipv4Octets> ipv4_simd(std::string_view text) noexcept {
+
+        // Shortest address is `0.0.0.0`, longest is `255.255.255.255`
+        const std::size_t len = text.size();
+        if (len < 7 || len > 15) return std::nullopt;
+
+        // Copy into a zeroed block, as the input may end right before an unmapped page
+        alignas(16) char block[16] = {};
+        std::memcpy(block, text.data(), len);
+        const __m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+
+        // Classify all bytes: digits become their value, periods are recorded separately
+        const __m128i values = _mm_sub_epi8(input, _mm_set1_epi8('0'));
+        const __m128i digits = _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+        const __m128i periods = _mm_cmpeq_epi8(input, _mm_set1_epi8('.'));
+        const unsigned used = (1u << len) - 1;
+        const unsigned valid = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(digits, periods))) & used;
+        unsigned dots = static_cast<unsigned>(_mm_movemask_epi8(periods)) & used;
+        if (valid != used) return std::nullopt;
+
+        // Exactly three periods, delimiting octets of one to three digits
+        const unsigned first = detail::lowest_bit(dots | 0x10000u);
+        dots &= dots - 1;
+        const unsigned second = detail::lowest_bit(dots | 0x10000u);
+        dots &= dots - 1;
+        const unsigned third = detail::lowest_bit(dots | 0x10000u);
+        dots &= dots - 1;
+        if (dots != 0 || third >= len) return std::nullopt;
+        const unsigned l0 = first - 1;
+        const unsigned l1 = second - first - 2;
+        const unsigned l2 = third - second - 2;
+        const unsigned l3 = static_cast<unsigned>(len) - third - 2;
+        if (l0 > 2 || l1 > 2 || l2 > 2 || l3 > 2) return std::nullopt;
+
+        // Line up digits and weigh them: [h, t, o, 0] * [100, 10, 1, 0] summed per octet
+        const __m128i shuffle = _mm_load_si128(
+                reinterpret_cast<const __m128i*>(detail::IPV4_SHUFFLES.masks[l0 * 27 + l1 * 9 + l2 * 3 + l3]));
+        const __m128i aligned = _mm_shuffle_epi8(values, shuffle);
+        const __m128i pairs = _mm_maddubs_epi16(aligned, _mm_setr_epi8(
+                100, 10, 1, 0, 100, 10, 1, 0, 100, 10, 1, 0, 100, 10, 1, 0));
+        const __m128i octets = _mm_madd_epi16(pairs, _mm_set1_epi16(1));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi32(octets, _mm_set1_epi32(255))) != 0) return std::nullopt;
+
+        const __m128i packed = _mm_packus_epi16(_mm_packus_epi32(octets, octets), octets);
+        const uint32_t raw = static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+        Ipv4Octets result{};
+        std::memcpy(result.data(), &raw, sizeof raw);
+        return result;
+    }
+
+#endif // LAIO_PARSER_SSE41
+
+    /// Parse dotted-decimal IPv4 address with the fastest implementation available on this target
+    ///
+    /// \param text Address text without surrounding whitespace
+    /// \return Octets of the address if the text is well-formed, `std::nullopt` otherwise
+    inline std::optional<Ipv4Octets> ipv4(std::string_view text) noexcept {
+#if LAIO_PARSER_SSE41
+        return ipv4_simd(text);
+#else
+        return ipv4_scalar(text);
+#endif
+    }
+
+    /// Octets of an IPv6 address in network order
+    using Ipv6Octets = std::array<uint8_t, 16>;
+
+    /// IPv6 address with optional zone identifier
+    struct Ipv6Text {
+        Ipv6Octets octets;      ///< Octets of the address in network order
+        std::string_view zone;  ///< Zone following the `%` sign, empty if there is none
+    };
+
+    namespace detail {
+
+        /// Longest IPv6 address text without zone: `ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255`
+        constexpr std::size_t IPV6_MAX_LEN = 45;
+
+        /// Classification of the characters of an IPv6 address text
+        ///
+        /// \details Bit `i` of each mask describes character `i`. Nibbles hold the value of every hexadecimal digit.
+        struct Ipv6Classes {
+            std::uint64_t hex = 0;
+            std::uint64_t colon = 0;
+            std::uint64_t dot = 0;
+            alignas(16) uint8_t nibbles[48] = {};
+        };
+
+        /// Classify characters one at a time
+        inline void classify_ipv6_scalar(const char* block, std::size_t len, Ipv6Classes& classes) noexcept {
+            for (std::size_t i = 0; i < len; ++i) {
+                const char c = block[i];
+                const char lower = static_cast<char>(c | 0x20);
+                if (c >= '0' && c <= '9') {
+                    classes.hex |= 1ull << i;
+                    classes.nibbles[i] = static_cast<uint8_t>(c - '0');
+                } else if (lower >= 'a' && lower <= 'f') {
+                    classes.hex |= 1ull << i;
+                    classes.nibbles[i] = static_cast<uint8_t>(lower - 'a' + 10);
+                } else if (c == ':') {
+                    classes.colon |= 1ull << i;
+                } else if (c == '.') {
+                    classes.dot |= 1ull << i;
+                }
+            }
+        }
+
+#if LAIO_PARSER_SSE41
+        /// Classify 16 characters at a time
+        ///
+        /// \details Digits and letters are decoded side by side and blended, so that every byte costs a handful of
+        /// instructions regardless of its class. The block must be zero-padded to 48 bytes.
+        inline void classify_ipv6_simd(const char* block, std::size_t len, Ipv6Classes& classes) noexcept {
+            const std::uint64_t used = (1ull << len) - 1;
+            for (int chunk = 0; chunk < 3; ++chunk) {
+                const __m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(block + chunk * 16));
+                const __m128i digits = _mm_sub_epi8(input, _mm_set1_epi8('0'));
+                const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+                const __m128i letters = _mm_sub_epi8(_mm_or_si128(input, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+                const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+                const __m128i nibbles = _mm_blendv_epi8(_mm_add_epi8(letters, _mm_set1_epi8(10)), digits, isDigit);
+                _mm_store_si128(reinterpret_cast<__m128i*>(classes.nibbles + chunk * 16), nibbles);
+
+                const int shift = chunk * 16;
+                const auto mask = [](__m128i v) {
+                    return static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(v)));
+                };
+                classes.hex |= mask(_mm_or_si128(isDigit, isLetter)) << shift;
+                classes.colon |= mask(_mm_cmpeq_epi8(input, _mm_set1_epi8(':'))) << shift;
+                classes.dot |= mask(_mm_cmpeq_epi8(input, _mm_set1_epi8('.'))) << shift;
+            }
+            classes.hex &= used;
+            classes.colon &= used;
+            classes.dot &= used;
+        }
+#endif
+
+        /// Return index of the lowest set bit of a non-zero mask
+        inline unsigned lowest_bit64(std::uint64_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+            _BitScanForward64(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+        }
+
+        /// Return index of the highest set bit of a non-zero mask
+        inline unsigned highest_bit64(std::uint64_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+            _BitScanReverse64(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return 63u - static_cast<unsigned>(__builtin_clzll(mask));
+#endif
+        }
+
+        /// Return mask with bits `begin` to `end - 1` set
+        constexpr std::uint64_t range(unsigned begin, unsigned end) noexcept {
+            return end <= begin ? 0 : ((end >= 64 ? ~0ull : (1ull << end) - 1) & ~((1ull << begin) - 1));
+        }
+
+        /// Decode colon-separated groups of one to four hexadecimal digits in `[begin, end)`
+        ///
+        /// \return Number of groups, or -1 if the range is malformed
+        inline int ipv6_groups(const Ipv6Classes& classes, unsigned begin, unsigned end, uint16_t* groups,
+                               int capacity) noexcept {
+            int count = 0;
+            unsigned pos = begin;
+            while (pos < end) {
+                const std::uint64_t colons = classes.colon & range(pos, end);
+                const unsigned stop = colons ? lowest_bit64(colons) : end;
+                const unsigned len = stop - pos;
+                if (len == 0 || len > 4 || count == capacity) return -1;
+                if ((classes.hex & range(pos, stop)) != range(pos, stop)) return -1;
+                uint16_t value = 0;
+                for (unsigned i = pos; i < stop; ++i) {
+                    value = static_cast<uint16_t>(value << 4u | classes.nibbles[i]);
+                }
+                groups[count++] = value;
+
+                // A separator must be followed by another group
+                if (stop == end) break;
+                pos = stop + 1;
+                if (pos == end) return -1;
+            }
+            return count;
+        }
+
+    } // namespace detail
+
+    /// Parse textual IPv6 address
+    ///
+    /// \details Accepts the text representations of RFC 4291 section 2.2: eight groups of one to four hexadecimal
+    /// digits in either case, at most one `::` replacing one or more zero groups, and an embedded dotted-decimal IPv4
+    /// address without leading zeros in place of the last two groups. This includes the canonical form of RFC 5952. A zone identifier may
+    /// follow a `%` sign; it is returned as a view into the text and is not interpreted.
+    /// Characters are classified 16 at a time if the target supports SSE4.1. Nothing is allocated.
+    ///
+    /// \param text Address text without surrounding whitespace or brackets
+    /// \return Octets and zone of the address if the text is well-formed, `std::nullopt` otherwise
+    inline std::optional<Ipv6Text> ipv6(std::string_view text) noexcept {
+        std::string_view zone{};
+        const std::size_t percent = text.find('%');
+        if (percent != std::string_view::npos) {
+            zone = text.substr(percent + 1);
+            text = text.substr(0, percent);
+            if (zone.empty()) return std::nullopt;
+        }
+        const std::size_t len = text.size();
+        if (len < 2 || len > detail::IPV6_MAX_LEN) return std::nullopt;
+
+        // Copy into a zeroed block, as the input may end right before an unmapped page
+        alignas(16) char block[48] = {};
+        std::memcpy(block, text.data(), len);
+        detail::Ipv6Classes classes{};
+#if LAIO_PARSER_SSE41
+        detail::classify_ipv6_simd(block, len, classes);
+#else
+        detail::classify_ipv6_scalar(block, len, classes);
+#endif
+        const std::uint64_t used = (1ull << len) - 1;
+        if ((classes.hex | classes.colon | classes.dot) != used || classes.colon == 0) return std::nullopt;
+
+        // At most a single `::`, never `:::`
+        const std::uint64_t doubles = classes.colon & (classes.colon >> 1u);
+        if ((doubles & (doubles - 1)) != 0) return std::nullopt;
+
+        // Embedded IPv4 address follows the last colon
+        unsigned hexEnd = static_cast<unsigned>(len);
+        int tailGroups = 0;
+        uint8_t v4[4] = {};
+        if (classes.dot) {
+            const unsigned last = detail::highest_bit64(classes.colon);
+            if ((classes.dot & detail::range(0, last + 1)) != 0) return std::nullopt;
+            const std::string_view dotted = text.substr(last + 1);
+            std::optional<Ipv4Octets> embedded = ipv4(dotted);
+            if (!embedded) return std::nullopt;
+
+            // The embedded address follows RFC 3986, which does not permit leading zeros
+            for (std::size_t i = 0; i + 1 < dotted.size(); ++i) {
+                if (dotted[i] == '0' && (i == 0 || dotted[i - 1] == '.') && dotted[i + 1] != '.') return std::nullopt;
+            }
+            std::memcpy(v4, embedded->data(), 4);
+            tailGroups = 2;
+
+            // The separating colon is dropped, unless it closes a `::`
+            hexEnd = last > 0 && (doubles >> (last - 1u) & 1u) ? last + 1 : last;
+        }
+
+        uint16_t head[8] = {};
+        uint16_t tail[8] = {};
+        int headCount = 0;
+        int tailCount = 0;
+        if (doubles) {
+            const unsigned at = detail::lowest_bit64(doubles);
+            if (at + 2 > hexEnd) return std::nullopt;
+            headCount = detail::ipv6_groups(classes, 0, at, head, 7);
+            tailCount = detail::ipv6_groups(classes, at + 2, hexEnd, tail, 7);
+            if (headCount < 0 || tailCount < 0 || headCount + tailCount + tailGroups > 7) return std::nullopt;
+        } else {
+            headCount = detail::ipv6_groups(classes, 0, hexEnd, head, 8);
+            if (headCount < 0 || headCount + tailGroups != 8) return std::nullopt;
+        }
+
+        Ipv6Text result{Ipv6Octets{}, zone};
+        for (int i = 0; i < headCount; ++i) {
+            result.octets[2 * i] = static_cast<uint8_t>(head[i] >> 8u);
+            result.octets[2 * i + 1] = static_cast<uint8_t>(head[i]);
+        }
+        const int tailAt = 8 - tailGroups - tailCount;
+        for (int i = 0; i < tailCount; ++i) {
+            result.octets[2 * (tailAt + i)] = static_cast<uint8_t>(tail[i] >> 8u);
+            result.octets[2 * (tailAt + i) + 1] = static_cast<uint8_t>(tail[i]);
+        }
+        if (tailGroups) {
+            std::memcpy(result.octets.data() + 12, v4, 4);
+        }
+        return result;
+    }
+
+    /// Parse textual IPv6 address one character at a time
+    ///
+    /// \details Accepts exactly what `ipv6` accepts, but reads groups front to back instead of classifying all
+    /// characters up front. This is the reference implementation for `ipv6`, and is evaluated at compile time for
+    /// address literals.
+    ///
+    /// \param text Address text without surrounding whitespace or brackets
+    /// \return Octets and zone of the address if the text is well-formed, `std::nullopt` otherwise
+    constexpr std::optional<Ipv6Text> ipv6_scalar(std::string_view text) noexcept {
+        std::string_view zone{};
+        const std::size_t percent = text.find('%');
+        if (percent != std::string_view::npos) {
+            zone = text.substr(percent + 1);
+            text = text.substr(0, percent);
+            if (zone.empty()) return std::nullopt;
+        }
+        const std::size_t len = text.size();
+        if (len < 2 || len > detail::IPV6_MAX_LEN) return std::nullopt;
+
+        // Groups following a `::` are moved to the end once all groups are known
+        uint16_t groups[8] = {};
+        int count = 0;
+        int gap = -1;
+        std::size_t pos = 0;
+        if (text[0] == ':') {
+            if (text[1] != ':') return std::nullopt;
+            gap = 0;
+            pos = 2;
+        }
+        while (pos < len) {
+            std::size_t end = pos;
+            uint32_t value = 0;
+            for (; end < len; ++end) {
+                const char c = text[end];
+                const char lower = static_cast<char>(c | 0x20);
+                if (c >= '0' && c <= '9') {
+                    value = value << 4u | static_cast<uint32_t>(c - '0');
+                } else if (lower >= 'a' && lower <= 'f') {
+                    value = value << 4u | static_cast<uint32_t>(lower - 'a' + 10);
+                } else {
+                    break;
+                }
+                if (end - pos == 4) return std::nullopt;
+            }
+
+            // Embedded IPv4 address takes the place of the last two groups
+            if (end < len && text[end] == '.') {
+                const std::string_view dotted = text.substr(pos);
+                std::optional<Ipv4Octets> embedded = ipv4_scalar(dotted);
+                if (!embedded || count > 6) return std::nullopt;
+
+                // The embedded address follows RFC 3986, which does not permit leading zeros
+                for (std::size_t i = 0; i + 1 < dotted.size(); ++i) {
+                    if (dotted[i] == '0' && (i == 0 || dotted[i - 1] == '.') && dotted[i + 1] != '.') return std::nullopt;
+                }
+                groups[count++] = static_cast<uint16_t>((*embedded)[0] << 8u | (*embedded)[1]);
+                groups[count++] = static_cast<uint16_t>((*embedded)[2] << 8u | (*embedded)[3]);
+                break;
+            }
+            if (end == pos || count == 8) return std::nullopt;
+            groups[count++] = static_cast<uint16_t>(value);
+            if (end == len) break;
+
+            // A separator is either a single colon followed by a group, or the only `::`
+            if (text[end] != ':' || end + 1 == len) return std::nullopt;
+            pos = end + 1;
+            if (text[pos] == ':') {
+                if (gap >= 0) return std::nullopt;
+                gap = count;
+                ++pos;
+                if (pos < len && text[pos] == ':') return std::nullopt;
+            }
+        }
+        if (gap < 0 ? count != 8 : count > 7) return std::nullopt;
+
+        Ipv6Text result{Ipv6Octets{}, zone};
+        const int tailCount = gap < 0 ? 0 : count - gap;
+        const int headCount = count - tailCount;
+        for (int i = 0; i < 8; ++i) {
+            const uint16_t group = i < headCount ? groups[i] : i >= 8 - tailCount ? groups[count - 8 + i] : 0;
+            result.octets[2 * i] = static_cast<uint8_t>(group >> 8u);
+            result.octets[2 * i + 1] = static_cast<uint8_t>(group);
+        }
+        return result;
+    }
+
+    /// Parse decimal port number
+    ///
+    /// \details Accepts one to five decimal digits with a value of at most 65535. Leading zeros are permitted.
+    ///
+    /// \param text Port text without surrounding whitespace
+    /// \return Port number if the text is well-formed, `std::nullopt` otherwise
+    constexpr std::optional<uint16_t> port(std::string_view text) noexcept {
+        if (text.empty() || text.size() > 5) return std::nullopt;
+        uint32_t value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return std::nullopt;
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+        }
+        if (value > 65535) return std::nullopt;
+        return static_cast<uint16_t>(value);
+    }
+
+    /// Parse decimal scope identifier of an IPv6 zone
+    ///
+    /// \details Accepts one to ten decimal digits with a value of at most 2^32 - 1. Interface names are not resolved.
+    ///
+    /// \param text Zone text following the `%` sign
+    /// \return Scope identifier if the text is well-formed, `std::nullopt` otherwise
+    constexpr std::optional<uint32_t> scope_id(std::string_view text) noexcept {
+        if (text.empty() || text.size() > 10) return std::nullopt;
+        std::uint64_t value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return std::nullopt;
+            value = value * 10 + static_cast<std::uint64_t>(c - '0');
+        }
+        if (value > 0xff'ff'ff'ffu) return std::nullopt;
+        return static_cast<uint32_t>(value);
+    }
+
+} // namespace laio::net::parser
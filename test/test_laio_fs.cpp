@@ -0,0 +1,191 @@
+#include "catch2/catch.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "AlignedBuffer.h"
+#include "CompletionPort.h"
+#include "File.h"
+#include "MappedView.h"
+#include "OpenOptions.h"
+#include "Overlapped.h"
+#include "ReadAhead.h"
+
+TEST_CASE("AlignedBuffer") {
+    using namespace laio::fs;
+
+    // Length is rounded up to a multiple of the alignment and the address is aligned
+    AlignedBuffer buffer = std::get<AlignedBuffer>(AlignedBuffer::allocate(100, 512));
+    CHECK(buffer.size() == 512);
+    CHECK(buffer.alignment() == 512);
+    CHECK(reinterpret_cast<std::uintptr_t>(buffer.data()) % 512 == 0);
+
+    // The buffer is zeroed
+    for (uint8_t byte: buffer.as_span()) {
+        CHECK(byte == 0);
+    }
+
+    // The alignment must be a power of two
+    CHECK(std::holds_alternative<laio::Error>(AlignedBuffer::allocate(100, 3)));
+    CHECK(std::holds_alternative<laio::Error>(AlignedBuffer::allocate(100, 0)));
+}
+
+TEST_CASE("File") {
+    using namespace laio::fs;
+    using laio::iocp::Overlapped;
+
+    // File has traits `is_send`, `is_sync`, `as_raw_handle` and `into_raw_handle`
+    CHECK(laio::trait::is_send<File>);
+    CHECK(laio::trait::is_sync<File>);
+    CHECK(laio::trait::as_raw_handle<File>);
+    CHECK(laio::trait::into_raw_handle<File>);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "test_laio_fs_direct.bin";
+    {
+        File file = std::get<File>(OpenOptions{}
+                .read(true)
+                .write(true)
+                .create(true)
+                .truncate(true)
+                .caching(Caching::Direct)
+                .open(path));
+        CHECK(file.is_direct());
+        CHECK(file.alignment() >= 512);
+
+        // Aligned round trip through the device
+        AlignedBuffer out = std::get<AlignedBuffer>(file.allocate_buffer(file.alignment()));
+        out.as_mut_span()[0] = 0xab;
+        out.as_mut_span()[out.size() - 1] = 0xcd;
+        Overlapped write{};
+        CHECK(std::get<std::size_t>(file.write_at_wait(out.as_span(), file.alignment(), write)) == out.size());
+
+        AlignedBuffer in = std::get<AlignedBuffer>(file.allocate_buffer(file.alignment()));
+        Overlapped read{};
+        CHECK(std::get<std::size_t>(file.read_at_wait(in.as_mut_span(), file.alignment(), read)) == in.size());
+        CHECK(in.as_span()[0] == 0xab);
+        CHECK(in.as_span()[in.size() - 1] == 0xcd);
+
+        // Misaligned offsets and lengths are rejected before submission
+        Overlapped rejected{};
+        const laio::Error offset = std::get<laio::Error>(file.read_at_wait(in.as_mut_span(), 1, rejected));
+        CHECK(offset == static_cast<wse::win_errc>(ERROR_OFFSET_ALIGNMENT_VIOLATION));
+        const laio::Error length = std::get<laio::Error>(
+                file.read_at_wait(in.as_mut_span().first(in.size() - 1), 0, rejected));
+        CHECK(length == static_cast<wse::win_errc>(ERROR_INVALID_PARAMETER));
+    }
+
+    // Buffered files accept arbitrary offsets and lengths
+    {
+        File file = std::get<File>(OpenOptions{}.read(true).open(path));
+        CHECK_FALSE(file.is_direct());
+        CHECK(file.alignment() == 1);
+        uint8_t byte = 0xff;
+        Overlapped read{};
+        CHECK(std::get<std::size_t>(file.read_at_wait(gsl::span<uint8_t>{&byte, 1}, 3, read)) == 1);
+        CHECK(byte == 0);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("ReadAhead") {
+    using namespace laio::fs;
+    using laio::iocp::Overlapped;
+
+    // Fill file with a pattern that is not a multiple of the chunk size
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "test_laio_fs_read_ahead.bin";
+    std::vector<uint8_t> pattern(10'000);
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<uint8_t>(i * 7);
+    }
+    {
+        File file = std::get<File>(OpenOptions{}.write(true).create(true).truncate(true).open(path));
+        Overlapped write{};
+        CHECK(std::get<std::size_t>(file.write_at_wait(pattern, 0, write)) == pattern.size());
+    }
+
+    // Chunks are handed out in file order, however many reads are in flight
+    File file = std::get<File>(OpenOptions{}.read(true).open(path));
+    ReadAhead reader = std::get<ReadAhead>(ReadAhead::create(file, ReadAheadOptions{}
+            .chunk_size(1'000)
+            .depth(3, 1, 8)));
+    std::vector<uint8_t> contents{};
+    while (auto chunk = std::get<std::optional<gsl::span<const uint8_t>>>(reader.next())) {
+        CHECK(chunk->size() <= 1'000);
+        contents.insert(contents.end(), chunk->begin(), chunk->end());
+    }
+    CHECK(contents == pattern);
+    CHECK(reader.depth() >= 1);
+    CHECK(reader.depth() <= 8);
+
+    // Ranges are trimmed to the requested length
+    ReadAhead ranged = std::get<ReadAhead>(ReadAhead::create(file, ReadAheadOptions{}
+            .chunk_size(4'096)
+            .range(100, 50)
+            .adaptive(false)));
+    auto chunk = std::get<std::optional<gsl::span<const uint8_t>>>(ranged.next());
+    CHECK(chunk->size() == 50);
+    CHECK((*chunk)[0] == pattern[100]);
+    CHECK(std::get<std::optional<gsl::span<const uint8_t>>>(ranged.next()) == std::nullopt);
+
+    // Lengths beyond the end of the file stop at the end of the file
+    ReadAhead unbounded = std::get<ReadAhead>(ReadAhead::create(file, ReadAheadOptions{}
+            .chunk_size(4'096)
+            .range(8'192, UINT64_MAX)
+            .adaptive(false)));
+    chunk = std::get<std::optional<gsl::span<const uint8_t>>>(unbounded.next());
+    CHECK(chunk->size() == pattern.size() - 8'192);
+    CHECK(std::get<std::optional<gsl::span<const uint8_t>>>(unbounded.next()) == std::nullopt);
+}
+
+TEST_CASE("MappedView") {
+    using namespace laio::fs;
+    using namespace laio::iocp;
+
+    // MappedView has traits `is_send` and `is_sync`
+    CHECK(laio::trait::is_send<MappedView>);
+    CHECK(laio::trait::is_sync<MappedView>);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "test_laio_fs_mapped.bin";
+    std::vector<uint8_t> pattern(100'000);
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<uint8_t>(i * 13);
+    }
+    {
+        File file = std::get<File>(OpenOptions{}.write(true).create(true).truncate(true).open(path));
+        Overlapped write{};
+        CHECK(std::get<std::size_t>(file.write_at_wait(pattern, 0, write)) == pattern.size());
+    }
+
+    // Offsets need not be aligned to the allocation granularity
+    File file = std::get<File>(OpenOptions{}.read(true).open(path));
+    MappedView view = std::get<MappedView>(MappedView::map(file, 70'001, std::nullopt, false));
+    CHECK(view.size() == pattern.size() - 70'001);
+    CHECK(view.as_span()[0] == pattern[70'001]);
+    CHECK(view.as_span()[view.size() - 1] == pattern.back());
+
+    // Hints are accepted for any range within the view
+    CHECK(std::holds_alternative<std::monostate>(view.advise(0, view.size(), Advice::WillNeed)));
+    CHECK(std::holds_alternative<std::monostate>(view.advise(0, view.size(), Advice::DontNeed)));
+
+    // Asynchronous prefaults report back through the completion port
+    CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
+    Overlapped prefaulted{};
+    CHECK(std::holds_alternative<std::monostate>(view.prefault_async(0, view.size(), &port, 7, &prefaulted)));
+    CompletionStatus status = std::get<CompletionStatus>(port.get(std::nullopt));
+    CHECK(status.token() == 7);
+    CHECK(status.overlapped() == prefaulted.raw());
+
+    // Prefaults without an overlapped structure report back as well
+    CHECK(std::holds_alternative<std::monostate>(view.prefault_async(0, view.size(), &port, 8, nullptr)));
+    status = std::get<CompletionStatus>(port.get(std::nullopt));
+    CHECK(status.token() == 8);
+    CHECK(status.overlapped() == nullptr);
+
+    // Anonymous views are writable and zeroed
+    MappedView anonymous = std::get<MappedView>(MappedView::anonymous(4'096, false));
+    CHECK(anonymous.is_writable());
+    CHECK(anonymous.as_span()[4'095] == 0);
+    anonymous.as_mut_span()[4'095] = 1;
+    CHECK(anonymous.as_span()[4'095] == 1);
+}
@@ -1,12 +1,28 @@
 #include "catch2/catch.hpp"
 
+#include <cerrno>
 #include <chrono>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 #include "CompletionPort.h"
 #include "CompletionStatus.h"
 #include "Handle.h"
+#include "Histogram.h"
+#include "Instrument.h"
+#include "Metrics.h"
 #include "Overlapped.h"
+#include "OverlappedPool.h"
+#include "Result.h"
+#include "RingBuffer.h"
+#include "ShardedPort.h"
+#include "TraceRing.h"
 
 TEST_CASE("CompletionPort") {
     using namespace laio::iocp;
@@ -27,10 +43,38 @@ TEST_CASE("CompletionPort") {
 
     // The port attempts to dequeue a completion status until it times out
     CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
-    const wse::win_error timeout = std::get<1>(port.get(std::chrono::milliseconds(1)));
+    const laio::Error timeout = std::get<1>(port.get(std::chrono::milliseconds(1)));
     CHECK(timeout == wse::win_errc::wait_timeout);
 }
 
+TEST_CASE("Result") {
+    using laio::Error;
+    using laio::Result;
+
+    // Errors of both domains fit into four bytes and never compare equal
+    CHECK(sizeof(Error) == 4);
+    CHECK(Error{wse::win_errc::wait_timeout}.domain() == Error::Domain::Windows);
+    CHECK(Error::from_errno(ENOMEM).domain() == Error::Domain::Posix);
+    CHECK(Error::from_errno(ENOMEM).code() == ENOMEM);
+    CHECK(Error::from_errno(ERROR_INVALID_PARAMETER) != Error{static_cast<wse::win_errc>(ERROR_INVALID_PARAMETER)});
+    CHECK(Error{wse::win_errc::wait_timeout}.error_code() == std::error_code{WAIT_TIMEOUT, std::system_category()});
+
+    // Results of small values are trivially copyable and no larger than two words of four bytes
+    CHECK(std::is_trivially_copyable_v<Result<std::monostate>>);
+    CHECK(sizeof(Result<std::monostate>) == 8);
+    CHECK(sizeof(Result<bool>) == 8);
+
+    // Results are accessed like variants or like `std::expected`
+    const Result<std::size_t> value{std::size_t{3}};
+    CHECK(value.has_value());
+    CHECK(*value == 3);
+    CHECK(std::get<std::size_t>(value) == 3);
+    const Result<std::size_t> error{Error{wse::win_errc::io_incomplete}};
+    CHECK(!error.has_value());
+    CHECK(std::holds_alternative<Error>(error));
+    CHECK(error.error() == wse::win_errc::io_incomplete);
+}
+
 TEST_CASE("CompletionStatus") {
     using namespace laio::iocp;
 
@@ -80,4 +124,254 @@ TEST_CASE("CompletionStatus") {
     CHECK(messageQueue[2].bytes_transferred() == 0);
     CHECK(messageQueue[2].token() == 0);
     CHECK(messageQueue[2].overlapped() == nullptr);
+}
+
+TEST_CASE("ShardedPort") {
+    using namespace laio::iocp;
+
+    // Shards default to one per active processor
+    ShardedPort all = std::get<ShardedPort>(ShardedPort::create());
+    CHECK(all.size() == GetActiveProcessorCount(ALL_PROCESSOR_GROUPS));
+
+    // Round robin policy assigns new handles to shards in turn
+    ShardedPort ports = std::get<ShardedPort>(ShardedPort::create(2, policy::round_robin()));
+    CHECK(ports.size() == 2);
+    CompletionPort first = std::get<CompletionPort>(CompletionPort::create(1));
+    CompletionPort second = std::get<CompletionPort>(CompletionPort::create(1));
+    CHECK(std::get<std::size_t>(ports.add_handle(1, first)) == 0);
+    CHECK(std::get<std::size_t>(ports.add_handle(2, second)) == 1);
+
+    // Custom policies are wrapped around the number of shards
+    ShardedPort pinned = std::get<ShardedPort>(ShardedPort::create(2, [](std::uintptr_t, const ShardedPort&) {
+        return std::size_t{3};
+    }));
+    CompletionPort third = std::get<CompletionPort>(CompletionPort::create(1));
+    CHECK(std::get<std::size_t>(pinned.add_handle(3, third)) == 1);
+
+    // Pinned worker finds its own shard
+    Shard& shard = ports.shard(0);
+    CHECK(std::holds_alternative<std::monostate>(shard.pin_current_thread()));
+    CHECK(ports.current() == std::optional<std::size_t>{0});
+
+    // Node-local memory and overlapped pools
+    NumaBuffer buffer = std::get<NumaBuffer>(shard.allocate(4'096));
+    CHECK(buffer.size() == 4'096);
+    CHECK(buffer.node() == shard.numa_node());
+    CHECK(buffer.as_span()[4'095] == 0);
+
+    OverlappedPool pool = std::get<OverlappedPool>(shard.overlapped_pool(2));
+    Overlapped* a = pool.acquire();
+    Overlapped* b = pool.acquire();
+    CHECK(a != nullptr);
+    CHECK(b != nullptr);
+    CHECK(pool.acquire() == nullptr);
+    CHECK(pool.owns(a->raw()));
+    pool.release(a);
+    CHECK(pool.available() == 1);
+    CHECK(pool.acquire() == a);
+
+    // Completions posted to a shard are dequeued from that shard only
+    shard.port().post(CompletionStatus::create(4, 5, b));
+    CompletionStatus status = std::get<CompletionStatus>(shard.port().get(std::chrono::milliseconds{1'000}));
+    CHECK(status.overlapped() == b->raw());
+}
+
+TEST_CASE("Histogram") {
+    using namespace laio::iocp;
+
+    // Small values are counted exactly, larger ones within 1/16 of their value
+    CHECK(Histogram::bucket(0) == 0);
+    CHECK(Histogram::bucket(15) == 15);
+    CHECK(Histogram::bucket(16) == 16);
+    CHECK(Histogram::bucket(31) == 31);
+    CHECK(Histogram::bucket(32) == 32);
+    CHECK(Histogram::bucket(33) == 32);
+    for (const std::uint64_t value : {17ull, 1'000ull, 123'456ull, 987'654'321ull}) {
+        const std::size_t bucket = Histogram::bucket(value);
+        CHECK(Histogram::lower_bound(bucket) <= value);
+        CHECK(Histogram::upper_bound(bucket) >= value);
+        CHECK(Histogram::upper_bound(bucket) - Histogram::lower_bound(bucket) < value / Histogram::SUB_BUCKETS + 1);
+    }
+
+    // Values beyond the range end up in the last bucket
+    CHECK(Histogram::bucket(~std::uint64_t{0}) == Histogram::BUCKETS - 1);
+
+    // Percentiles are never underestimated, and overestimated by at most one bucket
+    Histogram histogram{};
+    CHECK(histogram.value_at(0.5) == 0);
+    std::vector<std::uint64_t> values{};
+    for (std::uint64_t i = 1; i <= 10'000; ++i) {
+        values.push_back(i * i);
+        histogram.record(i * i);
+    }
+    CHECK(histogram.count() == 10'000);
+    for (const double fraction : {0.5, 0.9, 0.99, 0.999, 1.0}) {
+        const std::uint64_t exact = values[static_cast<std::size_t>(fraction * 10'000) - 1];
+        CHECK(histogram.value_at(fraction) >= exact);
+        CHECK(histogram.value_at(fraction) <= exact + exact / Histogram::SUB_BUCKETS);
+    }
+
+    // Merged histograms count the values of both
+    Histogram copy{histogram};
+    copy.merge(histogram);
+    CHECK(copy.count() == 20'000);
+    CHECK(copy.value_at(0.5) == histogram.value_at(0.5));
+    copy.clear();
+    CHECK(copy.count() == 0);
+
+    // Completions of submitted operations are timed per operation type and token group, posted ones are not
+    CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
+    const std::uint64_t before = instrument::snapshot().of(instrument::Op::Write, 1).count();
+    Overlapped submitted{};
+    Overlapped posted{};
+    instrument::submitted(submitted.raw(), instrument::Op::Write);
+    port.post(CompletionStatus::create(0, 5, &submitted));
+    port.post(CompletionStatus::create(0, 5, &posted));
+    std::vector<CompletionStatus> statuses(2, CompletionStatus{});
+    CHECK(std::get<0>(port.get_many(statuses, std::nullopt)).size() == 2);
+    const std::uint64_t after = instrument::snapshot().of(instrument::Op::Write, 1).count();
+    CHECK(after - before == (instrument::ENABLED ? 1 : 0));
+}
+
+TEST_CASE("TraceRing") {
+    using namespace laio::iocp;
+
+    // Events are copied in the order they were pushed
+    TraceRing ring{4};
+    CHECK(ring.events().empty());
+    ring.push(TraceEvent{1, 0, 0x10, 2, 3, TraceEvent::Kind::Submit, 1});
+    ring.push(TraceEvent{4, 5, 0, 0, 1, TraceEvent::Kind::Dequeue, 0});
+    std::vector<TraceEvent> events = ring.events();
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].time == 1);
+    CHECK(events[0].overlapped == 0x10);
+    CHECK(events[0].token == 2);
+    CHECK(events[0].bytes == 3);
+    CHECK(events[0].kind == TraceEvent::Kind::Submit);
+    CHECK(events[0].op == 1);
+    CHECK(events[1].duration == 5);
+    CHECK(events[1].kind == TraceEvent::Kind::Dequeue);
+
+    // A full ring overwrites its oldest events
+    for (int64_t time = 10; time < 15; ++time) {
+        ring.push(TraceEvent{time, 0, 0, 0, 0, TraceEvent::Kind::Complete, 0});
+    }
+    events = ring.events();
+    CHECK(ring.written() == 7);
+    REQUIRE(events.size() == 4);
+    CHECK(events.front().time == 11);
+    CHECK(events.back().time == 14);
+
+    // Traces of operations on a port are written as Chrome trace JSON
+    CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
+    Overlapped overlapped{};
+    instrument::submitted(overlapped.raw(), instrument::Op::Read, 16);
+    port.post(CompletionStatus::create(16, 7, &overlapped));
+    CompletionStatus status = std::get<CompletionStatus>(port.get(std::nullopt));
+    {
+        instrument::Dispatch dispatch{status};
+    }
+    std::ostringstream trace{};
+    instrument::write_trace(trace);
+    CHECK(trace.str().rfind("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", 0) == 0);
+    CHECK((trace.str().find("\"name\": \"complete read\"") != std::string::npos) == instrument::TRACED);
+    CHECK((trace.str().find("\"name\": \"dispatch\"") != std::string::npos) == instrument::TRACED);
+}
+
+TEST_CASE("Metrics") {
+    using namespace laio::iocp;
+
+    // Batches are counted by the next power of two
+    CHECK(MetricsCell::bucket(1) == 0);
+    CHECK(MetricsCell::bucket(2) == 1);
+    CHECK(MetricsCell::bucket(3) == 2);
+    CHECK(MetricsCell::bucket(64) == 6);
+    CHECK(MetricsCell::bucket(65) == 7);
+    CHECK(MetricsCell::bucket(100'000) == MetricsCell::BATCH_BUCKETS - 1);
+    CHECK(sizeof(MetricsCell) % 64 == 0);
+
+    // Operations are in flight from their submission to their completion, posts and timeouts are counted
+    CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
+    const auto accept = static_cast<std::size_t>(instrument::Op::Accept);
+    const Metrics before = instrument::metrics();
+    Overlapped first{};
+    Overlapped second{};
+    instrument::submitted(first.raw(), instrument::Op::Accept);
+    instrument::submitted(second.raw(), instrument::Op::Accept);
+    CHECK(instrument::metrics().in_flight(accept) - before.in_flight(accept) == (instrument::METERED ? 2 : 0));
+    instrument::rejected(second.raw());
+    port.post(CompletionStatus::create(0, 3, &first));
+    std::vector<CompletionStatus> statuses(2, CompletionStatus{});
+    CHECK(std::get<0>(port.get_many(statuses, std::nullopt)).size() == 1);
+    CHECK(std::holds_alternative<laio::Error>(port.get(std::chrono::milliseconds(1))));
+    const Metrics after = instrument::metrics();
+    CHECK(after.in_flight(accept) == before.in_flight(accept));
+    CHECK(after.rejected[accept] - before.rejected[accept] == (instrument::METERED ? 1 : 0));
+    CHECK(after.completed[accept] - before.completed[accept] == (instrument::METERED ? 1 : 0));
+    CHECK(after.posts - before.posts == (instrument::METERED ? 1 : 0));
+    CHECK(after.timeouts - before.timeouts == (instrument::METERED ? 1 : 0));
+    CHECK(after.batches[0] - before.batches[0] == (instrument::METERED ? 1 : 0));
+
+    // Operations, which are polled for instead of dequeued, are completed explicitly
+    const auto connect = static_cast<std::size_t>(instrument::Op::Connect);
+    Overlapped polled{};
+    instrument::submitted(polled.raw(), instrument::Op::Connect);
+    instrument::completed(polled.raw());
+    const Metrics polledAfter = instrument::metrics();
+    CHECK(polledAfter.in_flight(connect) == after.in_flight(connect));
+    CHECK(polledAfter.completed[connect] - after.completed[connect] == (instrument::METERED ? 1 : 0));
+
+    // Plain structures are instrumented as well, without any bytes written past them
+    OVERLAPPED plain{};
+    instrument::submitted(&plain, instrument::Op::Connect);
+    CHECK(instrument::metrics().in_flight(connect) - polledAfter.in_flight(connect) == (instrument::METERED ? 1 : 0));
+    instrument::completed(&plain);
+    CHECK(instrument::metrics().in_flight(connect) == polledAfter.in_flight(connect));
+
+    // Snapshots are written in the Prometheus text format
+    std::ostringstream text{};
+    instrument::write_metrics(text, after);
+    CHECK(text.str().find("# TYPE laio_dequeue_batch_size histogram\n") != std::string::npos);
+    CHECK(text.str().find("laio_operations_in_flight{op=\"accept\"} ") != std::string::npos);
+}
+
+TEST_CASE("RingBuffer") {
+    using namespace laio::iocp;
+
+    CHECK(std::holds_alternative<laio::Error>(RingBuffer::create(0)));
+
+    // Capacity is rounded up to the allocation granularity
+    RingBuffer ring = std::get<RingBuffer>(RingBuffer::create(1));
+    const std::size_t capacity = ring.capacity();
+    CHECK(capacity >= 65'536);
+    CHECK(ring.empty());
+    CHECK(ring.writable().size() == capacity);
+
+    // Move the read position close to the end of the first mapping
+    ring.commit(capacity - 2);
+    ring.consume(capacity - 3);
+    CHECK(ring.size() == 1);
+    CHECK(ring.writable().size() == capacity - 1);
+
+    // Writes past the end of the first mapping appear at its start and read back in one piece
+    gsl::span<uint8_t> free = ring.writable();
+    for (std::size_t i = 0; i < 4; ++i) {
+        free[i] = static_cast<uint8_t>(i + 1);
+    }
+    ring.commit(4);
+    gsl::span<const uint8_t> frame = ring.readable();
+    CHECK(frame.size() == 5);
+    CHECK(frame[1] == 1);
+    CHECK(frame[4] == 4);
+
+    // Consuming across the end wraps the read position back into the first mapping
+    ring.consume(3);
+    CHECK(ring.size() == 2);
+    CHECK(ring.readable()[0] == 3);
+    CHECK(ring.readable().data() < ring.writable().data());
+    ring.commit(capacity);
+    CHECK(ring.full());
+    CHECK(ring.writable().empty());
+    ring.consume(capacity);
+    CHECK(ring.empty());
 }
\ No newline at end of file
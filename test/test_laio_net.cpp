@@ -1,7 +1,39 @@
 #include "catch2/catch.hpp"
 
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "AddrClass.h"
+#include "CidrTable.h"
+#include "CompletionPort.h"
+#include "ConnectionPool.h"
+#include "FiveTuple.h"
+#include "FlatMap.h"
+#include "IoBuf.h"
+#include "IpAddr.h"
 #include "Ipv4Addr.h"
 #include "Ipv6Addr.h"
+#include "Overlapped.h"
+#include "Parser.h"
+#include "ShardedListener.h"
+#include "Socket.h"
+#include "SocketAddr.h"
+#include "SocketAddrV4.h"
+#include "SocketAddrV6.h"
+#include "TcpListener.h"
+#include "TcpStream.h"
 
 TEST_CASE("Ipv4Addr") {
     using namespace laio::net;
@@ -302,4 +334,683 @@ TEST_CASE("Ipv6Addr string conversion") {
     // Two multi-zero segments of equal length
     Ipv6Addr equal_ranges{1, 0, 0, 4, 5, 0, 0, 8};
     CHECK(std::string{equal_ranges} == "1::4:5:0:0:8");
+}
+
+TEST_CASE("TcpListener") {
+    using namespace laio::net;
+    using namespace laio::iocp;
+
+    // TcpListener and TcpStream have traits `is_send`, `is_sync`, `as_raw_socket`, `from_raw_socket` and `into_raw_socket`
+    CHECK(laio::trait::is_send<TcpListener>);
+    CHECK(laio::trait::into_raw_socket<TcpListener>);
+    CHECK(laio::trait::is_send<TcpStream>);
+    CHECK(laio::trait::into_raw_socket<TcpStream>);
+
+    // Ephemeral port is assigned on bind
+    TcpListener listener = std::get<TcpListener>(TcpListener::bind(SocketAddrV4{ipv4::LOCALHOST, 0}));
+    SocketAddr address = std::get<SocketAddr>(listener.local_addr());
+    CHECK(address.is_ipv4());
+    CHECK(address.port() != 0);
+
+    CompletionPort port = std::get<CompletionPort>(CompletionPort::create(1));
+    CHECK(std::holds_alternative<std::monostate>(port.add_socket(1, listener)));
+
+    // Accept and connect complete on the completion port
+    TcpStream accepted = std::get<TcpStream>(TcpStream::create(address));
+    AcceptAddrBuf addresses{};
+    Overlapped accepting{};
+    CHECK(std::holds_alternative<bool>(listener.accept_overlapped(accepted, addresses, accepting.raw())));
+
+    TcpStream client = std::get<TcpStream>(TcpStream::create(address));
+    CHECK(std::holds_alternative<std::monostate>(client.socket().bind(SocketAddrV4{ipv4::LOCALHOST, 0})));
+    CHECK(std::holds_alternative<std::monostate>(port.add_socket(2, client)));
+    Overlapped connecting{};
+    CHECK(std::holds_alternative<std::optional<std::size_t>>(
+            client.connect_overlapped(address, gsl::span<const uint8_t>{}, connecting.raw())));
+
+    for (int i = 0; i < 2; ++i) {
+        CompletionStatus status = std::get<CompletionStatus>(port.get(std::chrono::milliseconds{5'000}));
+        CHECK((status.token() == 1 || status.token() == 2));
+    }
+    CHECK(std::holds_alternative<std::monostate>(listener.accept_complete(accepted)));
+    CHECK(std::holds_alternative<std::monostate>(client.connect_complete()));
+
+    // Both ends agree on the addresses of the connection
+    AcceptAddr parsed = std::get<AcceptAddr>(addresses.parse(listener));
+    CHECK(parsed.local() == address);
+    CHECK(parsed.remote() == std::get<SocketAddr>(client.local_addr()));
+    CHECK(std::get<SocketAddr>(accepted.peer_addr()) == std::get<SocketAddr>(client.local_addr()));
+}
+
+TEST_CASE("ShardedListener") {
+    using namespace laio::net;
+    using namespace laio::iocp;
+
+    // Unpinned shards would not be balanced, so that only a single one is bound
+    CHECK(std::holds_alternative<laio::Error>(ShardedListenerBuilder{}
+            .shards(2)
+            .bind(SocketAddrV4{ipv4::LOCALHOST, 0})));
+    CHECK(std::get<ShardedListener>(ShardedListenerBuilder{}.bind(SocketAddrV4{ipv4::LOCALHOST, 0})).size() == 1);
+
+    // Shards must be pinned to active processors of the current group
+    CHECK(std::holds_alternative<laio::Error>(ShardedListenerBuilder{}
+            .shards(1)
+            .cpu_affinity(true, UINT16_MAX)
+            .bind(SocketAddrV4{ipv4::LOCALHOST, 0})));
+    PROCESSOR_NUMBER current{};
+    GetCurrentProcessorNumberEx(&current);
+    if (GetActiveProcessorCount(current.Group) < 2) {
+        return;
+    }
+
+    // All shards share the ephemeral port assigned to the first one
+    ShardedListener listener = std::get<ShardedListener>(ShardedListenerBuilder{}
+            .shards(2)
+            .cpu_affinity(true)
+            .bind(SocketAddrV4{ipv4::LOCALHOST, 0}));
+    CHECK(listener.size() == 2);
+    const uint16_t port = std::get<SocketAddr>(listener.local_addr()).port();
+    CHECK(port != 0);
+    for (std::size_t i = 0; i < listener.size(); ++i) {
+        CHECK(std::get<SocketAddr>(listener.shard(i).local_addr()).port() == port);
+    }
+
+    // Each shard is associated with its own completion port
+    CompletionPort first = std::get<CompletionPort>(CompletionPort::create(1));
+    CompletionPort second = std::get<CompletionPort>(CompletionPort::create(1));
+    CHECK(std::holds_alternative<std::monostate>(listener.associate(0, first, 0)));
+    CHECK(std::holds_alternative<std::monostate>(listener.associate(1, second, 1)));
+}
+
+TEST_CASE("ConnectionPool") {
+    using namespace laio::net;
+    using namespace std::chrono_literals;
+
+    TcpListener listener = std::get<TcpListener>(TcpListener::bind(SocketAddrV4{ipv4::LOCALHOST, 0}));
+    const SocketAddr address = std::get<SocketAddr>(listener.local_addr());
+
+    // Blocking connect with timeout, zero timeouts are rejected
+    Socket socket = std::get<Socket>(Socket::create(address, SOCK_STREAM));
+    CHECK(std::holds_alternative<laio::Error>(socket.connect_timeout(address, 0ns)));
+    CHECK(std::holds_alternative<std::monostate>(socket.connect_timeout(address, 1s)));
+
+    // First acquire starts connecting in the background without blocking
+    ConnectionPool pool{ConnectionPoolOptions{}.max_per_host(2).min_idle(1)};
+    CHECK(std::get<std::optional<TcpStream>>(pool.acquire(address)) == std::nullopt);
+    CHECK(pool.pending(address) == 1);
+
+    // Connects complete in the backlog of the listener, without any accept
+    for (int i = 0; i < 500 && pool.idle(address) == 0; ++i) {
+        std::this_thread::sleep_for(10ms);
+        pool.maintain();
+    }
+    CHECK(pool.idle(address) == 1);
+
+    // Ready connections are handed out and can be returned for reuse
+    std::optional<TcpStream> stream = std::get<std::optional<TcpStream>>(pool.acquire(address));
+    REQUIRE(stream);
+    CHECK(std::get<SocketAddr>(stream->peer_addr()) == address);
+    pool.release(address, std::move(*stream));
+    CHECK(pool.idle(address) == 1);
+
+    // Broken connections are dropped on release
+    std::optional<TcpStream> broken = std::get<std::optional<TcpStream>>(pool.acquire(address));
+    REQUIRE(broken);
+    pool.release(address, std::move(*broken), false);
+    CHECK(pool.idle(address) == 0);
+}
+
+TEST_CASE("Ipv4Addr parser") {
+    using namespace laio::net;
+
+    // Malformed addresses are rejected
+    for (std::string_view text : {"", "...", "1.2.3", "1.2.3.", ".1.2.3", "1..2.3", "1.2.3.4.", "1.2.3.4.5",
+                                  "256.0.0.1", "1.2.3.1000", "1.2.3.a", " 1.2.3.4", "1.2.3.4 ", "0000.0.0.0"}) {
+        CHECK(parser::ipv4_scalar(text) == std::nullopt);
+        CHECK(Ipv4Addr::from(text) == std::nullopt);
+    }
+
+    // Octets of one to three digits, including leading zeros
+    CHECK(Ipv4Addr::from("1.22.033.255") == Ipv4Addr{1, 22, 33, 255});
+    CHECK(Ipv4Addr::from(std::string{"10.0.0.1"}) == Ipv4Addr{10, 0, 0, 1});
+
+#if LAIO_PARSER_SSE41
+    // The vectorized parser accepts exactly what the scalar parser accepts
+    std::mt19937 rng{7};
+    const char alphabet[] = "0123456789..x";
+    for (int i = 0; i < 100'000; ++i) {
+        std::string text{};
+        const std::size_t len = rng() % 17;
+        for (std::size_t j = 0; j < len; ++j) {
+            text += alphabet[rng() % (sizeof alphabet - 1)];
+        }
+        REQUIRE(parser::ipv4_simd(text) == parser::ipv4_scalar(text));
+    }
+    for (int i = 0; i < 100'000; ++i) {
+        const std::string text = fmt::format("{}.{}.{}.{}", rng() % 300, rng() % 300, rng() % 300, rng() % 300);
+        REQUIRE(parser::ipv4_simd(text) == parser::ipv4_scalar(text));
+    }
+#endif
+}
+
+TEST_CASE("Ipv6Addr parser") {
+    using namespace laio::net;
+
+    // Compressed, full, mixed-case and embedded IPv4 representations
+    CHECK(Ipv6Addr::from("::") == ipv6::UNSPECIFIED);
+    CHECK(Ipv6Addr::from("::1") == Ipv6Addr{0, 0, 0, 0, 0, 0, 0, 1});
+    CHECK(Ipv6Addr::from("1::") == Ipv6Addr{1, 0, 0, 0, 0, 0, 0, 0});
+    CHECK(Ipv6Addr::from("2001:DB8::ff00:42:8329") == Ipv6Addr{0x2001, 0xdb8, 0, 0, 0, 0xff00, 0x42, 0x8329});
+    CHECK(Ipv6Addr::from("2001:0db8:0000:0000:0000:ff00:0042:8329") == Ipv6Addr{0x2001, 0xdb8, 0, 0, 0, 0xff00, 0x42, 0x8329});
+    CHECK(Ipv6Addr::from("::ffff:192.0.2.128") == Ipv4Addr{192, 0, 2, 128}.to_ipv6_mapped());
+    CHECK(Ipv6Addr::from("1:2:3:4:5:6:1.2.3.4") == Ipv6Addr{1, 2, 3, 4, 5, 6, 0x0102, 0x0304});
+    CHECK(Ipv6Addr::from("1:2:3:4:5:6:7::") == Ipv6Addr{1, 2, 3, 4, 5, 6, 7, 0});
+
+    // Malformed addresses are rejected
+    for (std::string_view text : {"", ":", "1:", ":1", ":::", "1:::2", "1::2::3", "1:2:3:4:5:6:7", "1:2:3:4:5:6:7:8:9",
+                                  "12345::", "g::", "::1.2.3", "::1.2.3.04", "1.2.3.4", "::1.2.3.4:5",
+                                  "1:2:3:4:5:6:7:1.2.3.4", "fe80::1%"}) {
+        CHECK(Ipv6Addr::from(text) == std::nullopt);
+    }
+
+    // Zone identifiers are returned by the parser, but are not part of the address
+    std::optional<parser::Ipv6Text> scoped = parser::ipv6("fe80::1%eth0");
+    REQUIRE(scoped);
+    CHECK(scoped->zone == "eth0");
+    CHECK(scoped->octets[0] == 0xfe);
+    CHECK(scoped->octets[15] == 1);
+    CHECK(Ipv6Addr::from("fe80::1%eth0") == std::nullopt);
+
+    // Parser agrees with the system on formatted random addresses
+    std::mt19937 rng{11};
+    for (int i = 0; i < 10'000; ++i) {
+        uint16_t s[8]{};
+        for (uint16_t& segment : s) {
+            segment = rng() % 3 ? static_cast<uint16_t>(rng()) : 0;
+        }
+        const Ipv6Addr address{s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7]};
+        const std::string text{address};
+        IN6_ADDR expected{};
+        REQUIRE(inet_pton(AF_INET6, text.c_str(), &expected) == 1);
+        REQUIRE(Ipv6Addr::from(text) == Ipv6Addr{expected});
+        REQUIRE(Ipv6Addr::from(text) == address);
+    }
+}
+
+TEST_CASE("Address formatting") {
+    using namespace laio::net;
+
+    // Text of the longest addresses fits into buffers of the advertised length
+    char buf[SocketAddrV6::MAX_STR_LEN];
+    std::to_chars_result res = Ipv4Addr{255, 255, 255, 255}.to_chars(buf, buf + Ipv4Addr::MAX_STR_LEN);
+    CHECK(res.ec == std::errc{});
+    CHECK(std::string_view(buf, res.ptr - buf) == "255.255.255.255");
+    res = Ipv6Addr{0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xfffe}.to_chars(buf, buf + Ipv6Addr::MAX_STR_LEN);
+    CHECK(res.ec == std::errc{});
+    CHECK(std::string_view(buf, res.ptr - buf) == "ffff:ffff:ffff:ffff:ffff:ffff:ffff:fffe");
+    res = SocketAddrV6{Ipv6Addr{0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff}, 65535, 0, 4294967295u}
+            .to_chars(buf, buf + sizeof buf);
+    CHECK(res.ec == std::errc{});
+    CHECK(res.ptr - buf == SocketAddrV6::MAX_STR_LEN);
+
+    // Too small output is reported and not written beyond its end
+    res = Ipv4Addr{10, 0, 0, 1}.to_chars(buf, buf + 7);
+    CHECK(res.ec == std::errc::value_too_large);
+    CHECK(res.ptr == buf + 7);
+
+    // Canonical IPv6 text as of RFC 5952
+    CHECK(std::string{ipv6::UNSPECIFIED} == "::");
+    CHECK(std::string{ipv6::LOCALHOST} == "::1");
+    CHECK(std::string{Ipv6Addr{0x2001, 0xdb8, 0, 0, 1, 0, 0, 1}} == "2001:db8::1:0:0:1");
+    CHECK(std::string{Ipv6Addr{0x2001, 0xdb8, 0, 1, 1, 1, 1, 1}} == "2001:db8:0:1:1:1:1:1");
+    CHECK(std::string{Ipv6Addr{1, 0, 0, 0, 0, 0, 0, 0}} == "1::");
+    CHECK(std::string{Ipv4Addr{192, 0, 2, 128}.to_ipv6_mapped()} == "::ffff:192.0.2.128");
+    CHECK(std::string{Ipv4Addr{0, 0, 0, 0}.to_ipv6_mapped()} == "::ffff:0.0.0.0");
+    CHECK(std::string{Ipv4Addr{192, 0, 2, 128}.to_ipv6_compatible()} == "::192.0.2.128");
+
+    // Socket addresses, with the scope identifier as zone
+    CHECK(std::string{SocketAddrV4{ipv4::LOCALHOST, 8080}} == "127.0.0.1:8080");
+    CHECK(std::string{SocketAddrV6{ipv6::LOCALHOST, 443, 0, 0}} == "[::1]:443");
+    CHECK(std::string{SocketAddrV6{Ipv6Addr{0xfe80, 0, 0, 0, 0, 0, 0, 1}, 80, 0, 3}} == "[fe80::1%3]:80");
+
+    // Formatters of the fmt library honour width and alignment
+    CHECK(fmt::format("{}", Ipv4Addr{10, 0, 0, 1}) == "10.0.0.1");
+    CHECK(fmt::format("{:>10}", Ipv4Addr{10, 0, 0, 1}) == "  10.0.0.1");
+    CHECK(fmt::format("{:<6}|", ipv6::LOCALHOST) == "::1   |");
+    CHECK(fmt::format("{} {}", SocketAddrV4{ipv4::LOCALHOST, 80}, SocketAddrV6{ipv6::LOCALHOST, 80, 0, 0})
+          == "127.0.0.1:80 [::1]:80");
+}
+
+TEST_CASE("Address layout") {
+    using namespace laio::net;
+
+    // Address types are as large as the Windows structures and can be copied with memcpy
+    static_assert(sizeof(Ipv4Addr) == 4 && std::is_trivially_copyable_v<Ipv4Addr>);
+    static_assert(sizeof(Ipv6Addr) == 16 && std::is_trivially_copyable_v<Ipv6Addr>);
+    static_assert(sizeof(IpAddr) <= 20 && std::is_trivially_copyable_v<IpAddr>);
+    static_assert(sizeof(SocketAddrV4) == 16 && std::is_trivially_copyable_v<SocketAddrV4>);
+    static_assert(sizeof(SocketAddrV6) == 28 && std::is_trivially_copyable_v<SocketAddrV6>);
+    static_assert(sizeof(SocketAddr) <= 32 && std::is_trivially_copyable_v<SocketAddr>);
+
+    // Moving from an address leaves it intact
+    SocketAddrV4 source{ipv4::LOCALHOST, 80};
+    SocketAddrV4 target{std::move(source)};
+    CHECK(source == target);
+
+    // Addresses order like their numeric value, IPv4 before IPv6
+    CHECK(Ipv4Addr{1, 2, 3, 4} < Ipv4Addr{1, 2, 3, 5});
+    CHECK(Ipv4Addr{1, 255, 255, 255} < Ipv4Addr{2, 0, 0, 0});
+    CHECK_FALSE(Ipv4Addr{2, 0, 0, 0} < Ipv4Addr{1, 255, 255, 255});
+    CHECK(Ipv4Addr{192, 168, 0, 1}.to_bits() == 0xc0'a8'00'01u);
+    CHECK(Ipv6Addr{0, 0xffff, 0, 0, 0, 0, 0, 0} < Ipv6Addr{1, 0, 0, 0, 0, 0, 0, 0});
+    CHECK(Ipv6Addr{0, 0, 0, 0, 0, 0, 0, 1} < Ipv6Addr{0, 0, 0, 0, 0, 0, 0, 2});
+    CHECK(Ipv6Addr{0x2001, 0xdb8, 0, 0, 0, 0, 0, 1}.to_bits() == std::pair<uint64_t, uint64_t>{0x2001'0db8'0000'0000u, 1u});
+    CHECK(Ipv6Addr{1, 2, 3, 4, 5, 6, 7, 8} == Ipv6Addr{1, 2, 3, 4, 5, 6, 7, 8});
+    CHECK_FALSE(Ipv6Addr{1, 2, 3, 4, 5, 6, 7, 8} == Ipv6Addr{1, 2, 3, 4, 5, 6, 7, 9});
+    CHECK(IpAddr{ipv4::BROADCAST} < IpAddr{ipv6::UNSPECIFIED});
+
+    // Tagged address of either version
+    const IpAddr v4 = *IpAddr::from("10.0.0.1");
+    const IpAddr v6 = *IpAddr::from("2001:db8::1");
+    CHECK(v4.is_ipv4());
+    CHECK(v4.as_v4() == Ipv4Addr{10, 0, 0, 1});
+    CHECK(v6.is_ipv6());
+    CHECK(v6.is_documentation());
+    CHECK_FALSE(v4 == v6);
+    CHECK(fmt::format("{} {}", v4, v6) == "10.0.0.1 2001:db8::1");
+    CHECK(IpAddr::from("10.0.0") == std::nullopt);
+
+    // Socket address of either version, with the same fields compared as their version-specific types
+    SocketAddrV6 flow{ipv6::LOCALHOST, 443, 0, 0};
+    flow.set_flow_info(7);
+    CHECK(flow.flow_info() == 7);
+    CHECK(flow.port() == 443);
+    CHECK_FALSE(flow == SocketAddrV6(ipv6::LOCALHOST, 443, 0, 0));
+    CHECK(SocketAddrV6(ipv6::LOCALHOST, 443, 0, 0) == SocketAddrV6(ipv6::LOCALHOST, 443, 0, 0));
+    CHECK_FALSE(SocketAddrV6(ipv6::LOCALHOST, 443, 0, 0) == SocketAddrV6(ipv6::UNSPECIFIED, 443, 0, 0));
+
+    SocketAddr scoped = SocketAddrV6{Ipv6Addr{0xfe80, 0, 0, 0, 0, 0, 0, 1}, 80, 0, 3};
+    scoped.set_port(8080);
+    CHECK(scoped.is_ipv6());
+    CHECK(scoped.port() == 8080);
+    CHECK(scoped.ip() == IpAddr{Ipv6Addr{0xfe80, 0, 0, 0, 0, 0, 0, 1}});
+    CHECK(scoped.as_v6()->scope_id() == 3);
+    CHECK(fmt::format("{}", scoped) == "[fe80::1%3]:8080");
+    const SocketAddr local = SocketAddrV4{ipv4::LOCALHOST, 8080};
+    CHECK(local.is_ipv4());
+    CHECK(local.ip() == IpAddr{ipv4::LOCALHOST});
+    CHECK_FALSE(local == scoped);
+    CHECK(std::get<1>(local.as_raw()) == sizeof(SOCKADDR_IN));
+}
+
+TEST_CASE("CidrTable") {
+    using namespace laio::net;
+
+    CidrTableBuilder<int> builder{};
+    CHECK(builder.insert("0.0.0.0/0", 0));
+    CHECK(builder.insert("10.0.0.0/8", 8));
+    CHECK(builder.insert("10.1.0.0/16", 16));
+    CHECK(builder.insert("10.1.2.0/24", 24));
+    CHECK(builder.insert(Ipv4Addr{10, 1, 2, 3}, 32, 32));
+    CHECK(builder.insert(Ipv4Addr{192, 168, 1, 77}, 20, 20));
+    CHECK(builder.insert("2001:db8::/32", 132));
+    CHECK(builder.insert("2001:db8:1::/48", 148));
+    CHECK(builder.insert("2001:db8:1::1/128", 228));
+    CHECK_FALSE(builder.insert("10.0.0.0/33", 0));
+    CHECK_FALSE(builder.insert("10.0.0.0", 0));
+    CHECK_FALSE(builder.insert("10.0.0.0/", 0));
+    CHECK_FALSE(builder.insert("10.0.0/8", 0));
+    CHECK_FALSE(builder.insert(ipv6::UNSPECIFIED, 129, 0));
+    CHECK(builder.size() == 9);
+
+    // The most specific range wins, host bits of the network address are ignored
+    const CidrTable<int> table = builder.build();
+    CHECK(*table.find(Ipv4Addr{10, 1, 2, 3}) == 32);
+    CHECK(*table.find(Ipv4Addr{10, 1, 2, 4}) == 24);
+    CHECK(*table.find(Ipv4Addr{10, 1, 3, 4}) == 16);
+    CHECK(*table.find(Ipv4Addr{10, 2, 3, 4}) == 8);
+    CHECK(*table.find(Ipv4Addr{11, 2, 3, 4}) == 0);
+    CHECK(*table.find(Ipv4Addr{192, 168, 15, 255}) == 20);
+    CHECK(*table.find(Ipv4Addr{192, 168, 16, 0}) == 0);
+    CHECK(*table.find(*Ipv6Addr::from("2001:db8:1::1")) == 228);
+    CHECK(*table.find(*Ipv6Addr::from("2001:db8:1::2")) == 148);
+    CHECK(*table.find(*Ipv6Addr::from("2001:db8:2::")) == 132);
+    CHECK(table.find(*Ipv6Addr::from("2001:db9::")) == nullptr);
+    CHECK(*table.find(*IpAddr::from("10.1.2.3")) == 32);
+
+    // Batch lookups agree with single lookups
+    std::mt19937 rng{13};
+    std::vector<Ipv4Addr> addresses{};
+    for (int i = 0; i < 1'000; ++i) {
+        addresses.emplace_back(static_cast<uint8_t>(rng() % 2 ? 10 : rng()), static_cast<uint8_t>(rng() % 3),
+                               static_cast<uint8_t>(rng() % 4), static_cast<uint8_t>(rng() % 5));
+    }
+    std::vector<const int*> values(addresses.size());
+    table.find(addresses, values);
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        REQUIRE(values[i] == table.find(addresses[i]));
+    }
+
+    // Later duplicates take precedence, and rebuilt tables are swapped in without disturbing readers
+    SharedCidrTable<int> shared{builder.build()};
+    std::shared_ptr<const CidrTable<int>> before = shared.load();
+    CHECK(builder.insert("10.0.0.0/8", 80));
+    shared.store(builder.build());
+    CHECK(*before->find(Ipv4Addr{10, 2, 3, 4}) == 8);
+    CHECK(*shared.load()->find(Ipv4Addr{10, 2, 3, 4}) == 80);
+    CHECK(CidrTable<int>{}.find(Ipv4Addr{10, 2, 3, 4}) == nullptr);
+}
+
+TEST_CASE("Address hashing") {
+    using namespace laio::net;
+
+    // Equal addresses hash equally, and different versions of the same address do not collide
+    CHECK(std::hash<Ipv4Addr>{}(Ipv4Addr{10, 0, 0, 1}) == std::hash<Ipv4Addr>{}(*Ipv4Addr::from("10.0.0.1")));
+    CHECK(std::hash<Ipv6Addr>{}(ipv6::LOCALHOST) == std::hash<Ipv6Addr>{}(*Ipv6Addr::from("::1")));
+    CHECK(std::hash<IpAddr>{}(IpAddr{ipv4::LOCALHOST}) == std::hash<Ipv4Addr>{}(ipv4::LOCALHOST));
+    CHECK(std::hash<IpAddr>{}(IpAddr{ipv4::LOCALHOST}) != std::hash<IpAddr>{}(IpAddr{ipv4::LOCALHOST.to_ipv6_mapped()}));
+    CHECK(std::hash<SocketAddr>{}(SocketAddrV4{ipv4::LOCALHOST, 80})
+          == std::hash<SocketAddrV4>{}(SocketAddrV4{ipv4::LOCALHOST, 80}));
+    CHECK(std::hash<SocketAddr>{}(SocketAddrV6{ipv6::LOCALHOST, 80, 0, 1})
+          == std::hash<SocketAddrV6>{}(SocketAddrV6{ipv6::LOCALHOST, 80, 0, 1}));
+    CHECK(std::hash<SocketAddrV6>{}(SocketAddrV6{ipv6::LOCALHOST, 80, 0, 1})
+          != std::hash<SocketAddrV6>{}(SocketAddrV6{ipv6::LOCALHOST, 80, 0, 2}));
+
+    // Sequential addresses and ports spread evenly over the low bits, which hash tables index by
+    std::unordered_set<std::size_t> buckets{};
+    for (uint8_t i = 0; i < 128; ++i) {
+        buckets.insert(std::hash<Ipv4Addr>{}(Ipv4Addr{10, 0, 0, i}) & 0xffffu);
+        buckets.insert(std::hash<SocketAddrV4>{}(SocketAddrV4{ipv4::LOCALHOST, static_cast<uint16_t>(1024 + i)}) & 0xffffu);
+        buckets.insert(std::hash<Ipv6Addr>{}(Ipv6Addr{0x2001, 0xdb8, 0, 0, 0, 0, 0, i}) & 0xffffu);
+    }
+    CHECK(buckets.size() > 370);
+
+    const FiveTuple tuple = FiveTuple::from(SocketAddrV4{Ipv4Addr{10, 0, 0, 1}, 50'000},
+                                            SocketAddrV4{Ipv4Addr{10, 0, 0, 2}, 443}, IPPROTO_TCP);
+    FiveTuple reversed = tuple;
+    std::swap(reversed.source, reversed.destination);
+    std::swap(reversed.source_port, reversed.destination_port);
+    CHECK(tuple.destination == IpAddr{Ipv4Addr{10, 0, 0, 2}});
+    CHECK(tuple.source_port == 50'000);
+    CHECK(tuple == FiveTuple{Ipv4Addr{10, 0, 0, 1}, Ipv4Addr{10, 0, 0, 2}, 50'000, 443, IPPROTO_TCP});
+    CHECK_FALSE(tuple == reversed);
+    CHECK(std::hash<FiveTuple>{}(tuple) != std::hash<FiveTuple>{}(reversed));
+}
+
+TEST_CASE("FlatMap") {
+    using namespace laio::net;
+
+    FlatMap<FiveTuple, int> connections{};
+    CHECK(connections.empty());
+    CHECK(connections.find(FiveTuple{ipv4::LOCALHOST, ipv4::LOCALHOST, 1, 2, IPPROTO_UDP}) == nullptr);
+    const auto tuple = [](uint16_t port) {
+        return FiveTuple{Ipv6Addr{0x2001, 0xdb8, 0, 0, 0, 0, 0, 1}, ipv6::LOCALHOST, port, 443, IPPROTO_TCP};
+    };
+    for (uint16_t port = 0; port < 1'000; ++port) {
+        REQUIRE(connections.try_emplace(tuple(port), port).second);
+    }
+    CHECK(connections.size() == 1'000);
+    CHECK(connections.capacity() * 7 / 8 >= 1'000);
+    CHECK(*connections.find(tuple(999)) == 999);
+    CHECK_FALSE(connections.try_emplace(tuple(999), 0).second);
+    CHECK_FALSE(connections.insert_or_assign(tuple(999), -1));
+    CHECK(*connections.find(tuple(999)) == -1);
+    CHECK(connections.erase(tuple(999)));
+    CHECK_FALSE(connections.erase(tuple(999)));
+    CHECK_FALSE(connections.contains(tuple(999)));
+
+    // Random operations agree with the standard library, including over erased slots and growth
+    std::mt19937 rng{21};
+    FlatMap<uint32_t, std::string> map{};
+    std::unordered_map<uint32_t, std::string> reference{};
+    for (int i = 0; i < 100'000; ++i) {
+        const uint32_t key = rng() % 4'096;
+        switch (rng() % 3) {
+            case 0:
+                REQUIRE(map.erase(key) == (reference.erase(key) == 1));
+                break;
+            case 1:
+                REQUIRE(map.insert_or_assign(key, std::to_string(i)) == reference.insert_or_assign(key, std::to_string(i)).second);
+                break;
+            default: {
+                const std::string* value = map.find(key);
+                const auto it = reference.find(key);
+                REQUIRE((value == nullptr) == (it == reference.end()));
+                if (value) REQUIRE(*value == it->second);
+            }
+        }
+        REQUIRE(map.size() == reference.size());
+    }
+    std::size_t visited = 0;
+    map.for_each([&](const uint32_t& key, std::string& value) {
+        ++visited;
+        CHECK(reference.at(key) == value);
+    });
+    CHECK(visited == reference.size());
+
+    FlatMap<uint32_t, std::string> moved{std::move(map)};
+    CHECK(moved.size() == reference.size());
+    CHECK(map.empty()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    const std::size_t capacity = moved.capacity();
+    moved.clear();
+    CHECK(moved.empty());
+    CHECK(moved.capacity() == capacity);
+    CHECK_FALSE(moved.contains(reference.begin()->first));
+}
+
+TEST_CASE("Address literals") {
+    using namespace laio::net;
+    using namespace laio::net::literals;
+
+    // Literals are constants, a malformed literal in place of any of these fails the build
+    constexpr Ipv4Addr gateway = "10.0.0.1"_ipv4;
+    constexpr Ipv6Addr documentation = "2001:db8::ffff:1.2.3.4"_ipv6;
+    constexpr SocketAddrV4 service = "127.0.0.1:8080"_sockv4;
+    static_assert(gateway.to_bits() == 0x0a000001u);
+    static_assert(std::get<0>(documentation.segments()) == 0x2001 && std::get<7>(documentation.segments()) == 0x0304);
+    static_assert(service.port() == 8080 && service.ip().is_loopback());
+    static_assert("::1"_ipv6.is_loopback() && "0.0.0.0"_ipv4.is_unspecified() && "192.0.2.1"_ipv4.is_documentation());
+    static_assert("ff0e::1"_ipv6.multicast_scope() == Ipv6MulticastScope::Global && "fe80::1"_ipv6.is_unicast_link_local());
+    static_assert(parser::port("65535") == 65535 && !parser::port("65536") && !parser::port(""));
+
+    CHECK(gateway == Ipv4Addr{10, 0, 0, 1});
+    CHECK(documentation == *Ipv6Addr::from("2001:db8::ffff:1.2.3.4"));
+    CHECK(service == SocketAddrV4{ipv4::LOCALHOST, 8080});
+    // Evaluated at run time, malformed literals throw instead
+    CHECK_THROWS_AS("10.0.0.256"_ipv4, std::invalid_argument);
+    CHECK_THROWS_AS("fe80::1%eth0"_ipv6, std::invalid_argument);
+    CHECK_THROWS_AS("127.0.0.1"_sockv4, std::invalid_argument);
+    CHECK_THROWS_AS("127.0.0.1:"_sockv4, std::invalid_argument);
+
+    // The scalar IPv6 parser accepts exactly what the classifying parser accepts
+    std::mt19937 rng{17};
+    const char alphabet[] = "0123456789abcdefABCDEF::::....%x";
+    for (int i = 0; i < 200'000; ++i) {
+        std::string text{};
+        const std::size_t len = rng() % 48;
+        for (std::size_t j = 0; j < len; ++j) {
+            text += alphabet[rng() % (sizeof alphabet - 1)];
+        }
+        const std::optional<parser::Ipv6Text> expected = parser::ipv6(text);
+        const std::optional<parser::Ipv6Text> actual = parser::ipv6_scalar(text);
+        REQUIRE(expected.has_value() == actual.has_value());
+        if (expected) {
+            REQUIRE(expected->octets == actual->octets);
+            REQUIRE(expected->zone == actual->zone);
+        }
+    }
+    for (int i = 0; i < 10'000; ++i) {
+        uint16_t s[8]{};
+        for (uint16_t& segment : s) {
+            segment = rng() % 3 ? static_cast<uint16_t>(rng()) : 0;
+        }
+        const std::string text{Ipv6Addr{s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7]}};
+        REQUIRE(parser::ipv6_scalar(text)->octets == parser::ipv6(text)->octets);
+    }
+}
+
+TEST_CASE("Address classification") {
+    using namespace laio::net;
+    using namespace laio::net::literals;
+
+    static_assert(classify("8.8.8.8"_ipv4) == addr_class::GLOBAL);
+    static_assert(classify("192.0.0.9"_ipv4) == (addr_class::GLOBAL | addr_class::IETF_PROTOCOL_ASSIGNMENT));
+    CHECK(classify(ipv4::LOCALHOST) == addr_class::LOOPBACK);
+    CHECK(classify(ipv4::BROADCAST) == addr_class::BROADCAST);
+    constexpr Ipv4Addr reserved = "240.0.0.1"_ipv4;
+    constexpr Ipv6Addr global_multicast = "ff0e::1"_ipv6;
+    constexpr Ipv6Addr link_local = "fe80::1"_ipv6;
+    constexpr Ipv6Addr site_local = "fec0::1"_ipv6;
+    CHECK(classify(reserved) == addr_class::RESERVED);
+    CHECK(classify(global_multicast) == (addr_class::MULTICAST | addr_class::GLOBAL));
+    CHECK(classify(link_local) == addr_class::LINK_LOCAL);
+    CHECK(classify(site_local) == (addr_class::SITE_LOCAL | addr_class::GLOBAL));
+
+    // Batch classification agrees with the predicates, for addresses in and around every range
+    std::mt19937 rng{19};
+    const uint32_t prefixes[] = {0x00000000, 0x0a000000, 0x64400000, 0x7f000000, 0xa9fe0000, 0xac100000, 0xc0000000,
+                                 0xc0000200, 0xc0a80000, 0xc6120000, 0xc6336400, 0xcb007100, 0xe0000000, 0xf0000000,
+                                 0xffffff00};
+    std::vector<Ipv4Addr> ipv4Addresses{};
+    for (int i = 0; i < 10'003; ++i) {
+        const uint32_t bits = rng() % 2 ? static_cast<uint32_t>(rng())
+                                        : prefixes[rng() % std::size(prefixes)] ^ (rng() % 2 ? 0u : 1u << (rng() % 32));
+        ipv4Addresses.emplace_back(static_cast<uint8_t>(bits >> 24u), static_cast<uint8_t>(bits >> 16u),
+                                   static_cast<uint8_t>(bits >> 8u), static_cast<uint8_t>(bits));
+    }
+    constexpr Ipv4Addr pcp_anycast = "192.0.0.9"_ipv4;
+    constexpr Ipv4Addr turn_anycast = "192.0.0.10"_ipv4;
+    ipv4Addresses.insert(ipv4Addresses.end(), {pcp_anycast, turn_anycast, ipv4::UNSPECIFIED, ipv4::BROADCAST});
+    std::vector<AddrClass> classes(ipv4Addresses.size());
+    classify(ipv4Addresses, classes);
+    for (std::size_t i = 0; i < ipv4Addresses.size(); ++i) {
+        REQUIRE(classes[i] == classify(ipv4Addresses[i]));
+    }
+
+    const uint16_t heads[] = {0x0000, 0x2001, 0xfc00, 0xfd12, 0xfe80, 0xfebf, 0xfec0, 0xff02, 0xff0e, 0xff1e};
+    std::vector<Ipv6Addr> ipv6Addresses{};
+    for (int i = 0; i < 10'003; ++i) {
+        uint16_t s[8]{};
+        for (uint16_t& segment : s) {
+            segment = rng() % 4 ? 0 : static_cast<uint16_t>(rng());
+        }
+        if (rng() % 2) s[0] = heads[rng() % std::size(heads)];
+        if (rng() % 4 == 0) s[1] = 0x0db8;
+        if (rng() % 4 == 0) s[7] = 1;
+        ipv6Addresses.emplace_back(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7]);
+    }
+    ipv6Addresses.insert(ipv6Addresses.end(), {ipv6::LOCALHOST, ipv6::UNSPECIFIED, ipv6::LOCALHOST});
+    classes.resize(ipv6Addresses.size());
+    classify(ipv6Addresses, classes);
+    for (std::size_t i = 0; i < ipv6Addresses.size(); ++i) {
+        REQUIRE(classes[i] == classify(ipv6Addresses[i]));
+    }
+}
+
+TEST_CASE("SocketAddr parser") {
+    using namespace laio::net;
+
+    CHECK(SocketAddrV4::from("192.168.0.1:8080") == SocketAddrV4{Ipv4Addr{192, 168, 0, 1}, 8080});
+    CHECK(SocketAddrV4::from("0.0.0.0:0") == SocketAddrV4{ipv4::UNSPECIFIED, 0});
+    CHECK(SocketAddrV6::from("[::1]:443") == SocketAddrV6{ipv6::LOCALHOST, 443, 0, 0});
+    CHECK(SocketAddrV6::from("[fe80::1%3]:8080") == SocketAddrV6{Ipv6Addr{0xfe80, 0, 0, 0, 0, 0, 0, 1}, 8080, 0, 3});
+    CHECK(SocketAddrV6::from("[::ffff:10.0.0.1]:65535")->ip() == Ipv4Addr{10, 0, 0, 1}.to_ipv6_mapped());
+    CHECK(SocketAddr::from("10.0.0.1:80") == SocketAddr{SocketAddrV4{Ipv4Addr{10, 0, 0, 1}, 80}});
+    CHECK(SocketAddr::from("[2001:db8::1%4294967295]:1")->as_v6()->scope_id() == 4'294'967'295u);
+
+    // Malformed addresses, ports and zones are rejected
+    for (std::string_view text : {"", ":", "10.0.0.1", "10.0.0.1:", "10.0.0.1:65536", "10.0.0.1:8a", "10.0.0.1:-1",
+                                  "10.0.0.1:80:80", "10.0.0:80", "::1:80", "[::1]", "[::1]:", "[::1]80", "::1]:80",
+                                  "[::1:80", "[10.0.0.1]:80", "[fe80::1%]:80", "[fe80::1%eth0]:80",
+                                  "[fe80::1%4294967296]:80", "[::1] :80"}) {
+        CHECK(SocketAddr::from(text) == std::nullopt);
+    }
+
+    // Formatted socket addresses are parsed back
+    std::mt19937 rng{23};
+    for (int i = 0; i < 1'000; ++i) {
+        const SocketAddr v4 = SocketAddrV4{Ipv4Addr{static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()),
+                                                    static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng())},
+                                           static_cast<uint16_t>(rng())};
+        const SocketAddr v6 = SocketAddrV6{Ipv6Addr{static_cast<uint16_t>(rng()), 0, 0, static_cast<uint16_t>(rng()),
+                                                    0, 0, 0, static_cast<uint16_t>(rng())},
+                                           static_cast<uint16_t>(rng()), 0, static_cast<uint32_t>(rng() % 3)};
+        REQUIRE(SocketAddr::from(std::string{v4}) == v4);
+        REQUIRE(SocketAddr::from(std::string{v6}) == v6);
+    }
+
+    // Lists are parsed up to the first malformed entry, or as far as the output reaches
+    std::vector<SocketAddr> addresses(3);
+    SocketAddrList list = SocketAddr::from_list(" 10.0.0.1:80,\r\n[::1]:443\t10.0.0.2:80, ", addresses);
+    CHECK(list.count == 3);
+    CHECK(list.rest.empty());
+    CHECK(addresses[1] == SocketAddr{SocketAddrV6{ipv6::LOCALHOST, 443, 0, 0}});
+    CHECK(addresses[2] == SocketAddr{SocketAddrV4{Ipv4Addr{10, 0, 0, 2}, 80}});
+    list = SocketAddr::from_list("10.0.0.1:80, 10.0.0.300:80, 10.0.0.3:80", addresses);
+    CHECK(list.count == 1);
+    CHECK(list.rest == "10.0.0.300:80, 10.0.0.3:80");
+    list = SocketAddr::from_list("10.0.0.1:1 10.0.0.1:2 10.0.0.1:3 10.0.0.1:4", addresses);
+    CHECK(list.count == 3);
+    CHECK(list.rest == "10.0.0.1:4");
+    CHECK(SocketAddr::from_list("", addresses).count == 0);
+    CHECK(SocketAddr{}.is_ipv4());
+}
+
+TEST_CASE("IoBuf") {
+    using namespace laio::net;
+
+    const auto slice = [](std::string_view text) {
+        return IoSlice::copy_of(gsl::span<const uint8_t>{reinterpret_cast<const uint8_t*>(text.data()), text.size()});
+    };
+    const auto text = [](const IoBuf& buf) {
+        std::string out(buf.size(), '\0');
+        buf.copy_to(gsl::span<uint8_t>{reinterpret_cast<uint8_t*>(out.data()), out.size()});
+        return out;
+    };
+
+    // Appending moves slices into the chain, empty slices are dropped
+    IoBuf message{slice("hello ")};
+    message.append(slice("wor"));
+    message.append(slice("ld"));
+    message.append(IoSlice{});
+    CHECK(message.size() == 11);
+    CHECK(message.slices().size() == 3);
+    CHECK(text(message) == "hello world");
+
+    // Splitting within a slice shares its block between both chains
+    IoBuf front = message.split_to(8);
+    CHECK(text(front) == "hello wo");
+    CHECK(text(message) == "rld");
+    CHECK(front.slices().size() == 2);
+    CHECK_FALSE(message.slices().front().unique());
+
+    // Trimming drops whole slices and shrinks partial ones
+    front.trim_front(7);
+    CHECK(text(front) == "o");
+    front.trim_back(5);
+    CHECK(front.empty());
+    CHECK(front.slices().empty());
+    CHECK(message.slices().front().unique());
+
+    // Headers are prepended and chains appended without copying
+    message.prepend(slice(">"));
+    IoBuf chain{};
+    chain.append(std::move(message));
+    CHECK(message.empty());
+    CHECK(text(chain) == ">rld");
+    chain.append(std::move(chain));
+    CHECK(text(chain) == ">rld");
+
+    // Chains lay out as buffer arrays of vectored operations
+    std::vector<IoSpan> spans(2, IoSpan{gsl::span<const uint8_t>{}});
+    CHECK(chain.spans(spans) == 2);
+    CHECK(spans[0].size() == 1);
+    CHECK(spans[1].size() == 3);
+
+    IoBuf received{IoSlice::allocate(16)};
+    std::vector<IoSpanMut> buffers(1, IoSpanMut{gsl::span<uint8_t>{}});
+    CHECK(received.mut_spans(buffers) == 1);
+    std::memcpy(buffers[0].as_mut_span().data(), "abc", 3);
+    received.trim_back(13);
+    CHECK(text(received) == "abc");
 }
\ No newline at end of file